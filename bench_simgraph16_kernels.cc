@@ -0,0 +1,110 @@
+/**
+ * This file is part of the Simutrans project under the artistic license.
+ * (see license.txt)
+ *
+ * Micro benchmark for simgraph16_kernels.h: MPix/s of the blend, outline,
+ * alpha and player colour routines for each SIMD level of this CPU.
+ * Do NOT link this into simutrans!  This is a benchmark!
+ *
+ * Build e.g. with: g++ -O2 -DCOLOUR_DEPTH=16 -o bench_kernels bench_simgraph16_kernels.cc simgraph16_kernels.cc
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "simgraph16_kernels.h"
+#include "simgraph.h"
+
+#define RGBMAP_SIZE (0x8000+256)
+// runs of about the width of a tile at normal zoom
+#define RUN_LEN (64)
+#define PIXELS (RUN_LEN * 4096)
+#define ROUNDS (64)
+
+static PIXVAL rgbmap[RGBMAP_SIZE+1];
+static PIXVAL src[PIXELS];
+static PIXVAL alphamap[PIXELS];
+static PIXVAL dest[PIXELS];
+
+static clock_t timer;
+
+static void start_timer()
+{
+	timer = clock();
+}
+
+static void stop_timer(const char *what)
+{
+	const double secs = (double)(clock() - timer) / CLOCKS_PER_SEC;
+	fprintf(stdout, "%-14s %8.1f MPix/s\n", what, secs > 0 ? (double)ROUNDS * PIXELS / secs * 1e-6 : 0.0);
+}
+
+
+static void bench_blend(const char *name, blend_proc p, const PIXVAL *s)
+{
+	start_timer();
+	for(  int r = 0;  r < ROUNDS;  r++  ) {
+		for(  int i = 0;  i < PIXELS;  i += RUN_LEN  ) {
+			p(dest + i, s ? s + i : NULL, rgbmap, 0x1234, RUN_LEN);
+		}
+	}
+	stop_timer(name);
+}
+
+
+static void bench_alpha(const char *name, alpha_proc p)
+{
+	start_timer();
+	for(  int r = 0;  r < ROUNDS;  r++  ) {
+		for(  int i = 0;  i < PIXELS;  i += RUN_LEN  ) {
+			p(dest + i, src + i, alphamap + i, rgbmap, ALPHA_RED | ALPHA_GREEN | ALPHA_BLUE, 0, RUN_LEN);
+		}
+	}
+	stop_timer(name);
+}
+
+
+static void bench_level(simd_level_t level)
+{
+	pixel_kernels_t k;
+	if(  !get_pixel_kernels(level, false, k)  ) {
+		return;
+	}
+	fprintf(stdout, "=== %s ===\n", get_simd_level_name(level));
+	bench_blend("blend25", k.blend[0], src);
+	bench_blend("blend50", k.blend[1], src);
+	bench_blend("blend75", k.blend[2], src);
+	bench_blend("blend_recode50", k.blend_recode[1], src);
+	bench_blend("outline50", k.outline[1], NULL);
+	bench_alpha("alpha", k.alpha);
+	bench_alpha("alpha_recode", k.alpha_recode);
+
+	start_timer();
+	for(  int r = 0;  r < ROUNDS;  r++  ) {
+		for(  int i = 0;  i < PIXELS;  i += RUN_LEN  ) {
+			k.colorcopy(dest + i, src + i, rgbmap, RUN_LEN);
+		}
+	}
+	stop_timer("colorcopy");
+	fprintf(stdout, "\n");
+}
+
+
+int main(int argc, char** argv)
+{
+	srand(42);
+	for(  int i = 0;  i < RGBMAP_SIZE+1;  i++  ) {
+		rgbmap[i] = rand();
+	}
+	for(  int i = 0;  i < PIXELS;  i++  ) {
+		src[i] = rand() % RGBMAP_SIZE;
+		dest[i] = rand();
+		const int a = rand() % 4;
+		alphamap[i] = a == 0 ? 0 : (a == 1 ? 0x7fff : rand() & 0x7fff);
+	}
+
+	const simd_level_t cpu_level = get_cpu_simd_level();
+	for(  int level = SIMD_NONE;  level <= cpu_level;  level++  ) {
+		bench_level((simd_level_t)level);
+	}
+	return 0;
+}
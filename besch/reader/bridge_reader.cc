@@ -22,17 +22,13 @@ void bridge_reader_t::register_obj(obj_besch_t *&data)
 }
 
 
-obj_besch_t * bridge_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t * bridge_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
 	// DBG_DEBUG("bridge_reader_t::read_node()", "called");
-	ALLOCA(char, besch_buf, node.size);
 
 	bruecke_besch_t *besch = new bruecke_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
-
 	char * p = besch_buf;
 
 	// Hajo: old versions of PAK files have no version stamp.
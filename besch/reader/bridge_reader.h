@@ -18,7 +18,7 @@ public:
 	 * compatibility transformations.
 	 * @author Hj. Malthaner
 	 */
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_bridge; }
 	char const* get_type_name() const OVERRIDE { return "bridge"; }
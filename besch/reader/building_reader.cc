@@ -9,16 +9,11 @@
 #include "../../dataobj/pakset_info.h"
 
 
-obj_besch_t * tile_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t * tile_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
-
 	haus_tile_besch_t *besch = new haus_tile_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
-
 	char * p = besch_buf;
 
 	// Hajo: old versions of PAK files have no version stamp.
@@ -182,16 +177,11 @@ bool building_reader_t::successfully_loaded() const
 }
 
 
-obj_besch_t * building_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t * building_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
-
 	haus_besch_t *besch = new haus_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
-
 	char * p = besch_buf;
 	// Hajo: old versions of PAK files have no version stamp.
 	// But we know, the highest bit was always cleared.
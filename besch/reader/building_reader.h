@@ -17,7 +17,7 @@ public:
 	/* Read a node. Does version check and compatibility transformations.
 	 * @author Hj. Malthaner
 	 */
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
 };
 
 
@@ -38,7 +38,7 @@ public:
 	/* Read a node. Does version check and compatibility transformations.
 	 * @author Hj. Malthaner
 	 */
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
 
 };
 
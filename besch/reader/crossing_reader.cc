@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "../../dataobj/crossing_logic.h"
 
@@ -15,6 +17,17 @@
 void crossing_reader_t::register_obj(obj_besch_t *&data)
 {
 	kreuzung_besch_t *besch = static_cast<kreuzung_besch_t *>(data);
+	if(besch->sound==LOAD_SOUND) {
+		char *const wavname = static_cast<char *>(get_deferred(besch));
+		besch->sound = (sint8)sound_besch_t::get_sound_id(wavname);
+DBG_MESSAGE("crossing_reader_t::register_obj()","sound %s to %i",wavname,besch->sound);
+		free(wavname);
+	}
+	else if(besch->sound>=0  &&  besch->sound<=MAX_OLD_SOUNDS) {
+		sint16 old_id = besch->sound;
+		besch->sound = (sint8)sound_besch_t::get_compatible_sound_id((sint8)old_id);
+DBG_MESSAGE("crossing_reader_t::register_obj()","old sound %i to %i",old_id,besch->sound);
+	}
 	if(besch->topspeed1!=0) {
 		crossing_logic_t::register_besch(besch);
 	}
@@ -25,15 +38,11 @@ void crossing_reader_t::register_obj(obj_besch_t *&data)
 }
 
 
-obj_besch_t * crossing_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t * crossing_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
-
 	kreuzung_besch_t *besch = new kreuzung_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
 	char * p = besch_buf;
 
 	// Hajo: old versions of PAK files have no version stamp.
@@ -48,6 +57,7 @@ obj_besch_t * crossing_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 		besch->wegtyp2 = (uint8)decode_uint16(p);
 		besch->topspeed1 = 0;
 		besch->topspeed2 = 0;
+		besch->sound = (sint8)NO_SOUND;
 	}
 	else {
 		besch->wegtyp1 = decode_uint8(p);
@@ -65,13 +75,8 @@ obj_besch_t * crossing_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 			for(uint8 i=0; i<len; i++) {
 				wavname[i] = decode_sint8(p);
 			}
-			besch->sound = (sint8)sound_besch_t::get_sound_id(wavname);
-DBG_MESSAGE("crossing_reader_t::register_obj()","sound %s to %i",wavname,besch->sound);
-		}
-		else if(besch->sound>=0  &&  besch->sound<=MAX_OLD_SOUNDS) {
-			sint16 old_id = besch->sound;
-			besch->sound = (sint8)sound_besch_t::get_compatible_sound_id((sint8)old_id);
-DBG_MESSAGE("crossing_reader_t::register_obj()","old sound %i to %i",old_id,besch->sound);
+			// the sound is looked up in register_obj()
+			set_deferred(besch, strdup(wavname));
 		}
 
 DBG_DEBUG("crossing_reader_t::read_node()","version=%i, w1=%d, speed1=%i, w2=%d, speed2=%d",v,besch->wegtyp1,besch->topspeed1,besch->wegtyp2,besch->topspeed2);
@@ -16,7 +16,7 @@ public:
 
 	obj_type get_type() const OVERRIDE { return obj_crossing; }
 	char const* get_type_name() const OVERRIDE { return "crossing"; }
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
 };
 
 #endif
@@ -27,15 +27,11 @@ uint16 rescale_probability(const uint16 p)
 }
 
 
-obj_besch_t *factory_field_class_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t *factory_field_class_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
-
 	field_class_besch_t *besch = new field_class_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
 	char * p = besch_buf;
 
 	uint16 v = decode_uint16(p);
@@ -56,15 +52,11 @@ obj_besch_t *factory_field_class_reader_t::read_node(FILE *fp, obj_node_info_t &
 }
 
 
-obj_besch_t *factory_field_group_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t *factory_field_group_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
-
 	field_group_besch_t *besch = new field_group_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
 	char * p = besch_buf;
 
 	uint16 v = decode_uint16(p);
@@ -103,10 +95,10 @@ obj_besch_t *factory_field_group_reader_t::read_node(FILE *fp, obj_node_info_t &
 		field_class_besch->spawn_weight = 1000;
 
 		/* Knightly :
-		 *   store it in a static variable for further processing
+		 *   keep it for further processing
 		 *   later in factory_field_reader_t::register_obj()
 		 */
-		incomplete_field_class_besch = field_class_besch;
+		set_deferred(besch, field_class_besch);
 
 		DBG_DEBUG("factory_field_group_reader_t::read_node()", "has_snow %i, probability %i, fields: max %i, min %i, production %i", field_class_besch->snow_image, besch->probability, besch->max_fields, besch->min_fields, field_class_besch->production_per_field);
 	}
@@ -123,27 +115,22 @@ void factory_field_group_reader_t::register_obj(obj_besch_t *&data)
 	field_group_besch_t *const besch = static_cast<field_group_besch_t *>(data);
 
 	// Knightly : check if we need to continue with the construction of field class besch
-	if (field_class_besch_t *const field_class_besch = incomplete_field_class_besch) {
+	if (field_class_besch_t *const field_class_besch = static_cast<field_class_besch_t *>(get_deferred(besch))) {
 		// we *must* transfer the obj_besch_t array and not just the besch object itself
 		// as xref reader has already logged the address of the array element for xref resolution
 		field_class_besch->node_info = besch->node_info;
 		besch->node_info = new obj_besch_t*[1];
 		besch->node_info[0] = field_class_besch;
-		incomplete_field_class_besch = NULL;
 	}
 }
 
 
 
-obj_besch_t *factory_smoke_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t *factory_smoke_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
-
 	rauch_besch_t *besch = new rauch_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
 	char * p = besch_buf;
 
 	sint16 x = decode_sint16(p);
@@ -162,16 +149,13 @@ obj_besch_t *factory_smoke_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 }
 
 
-obj_besch_t *factory_supplier_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t *factory_supplier_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
 	// DBG_DEBUG("factory_product_reader_t::read_node()", "called");
-	ALLOCA(char, besch_buf, node.size);
 
 	fabrik_lieferant_besch_t *besch = new fabrik_lieferant_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
 	char * p = besch_buf;
 
 	// Hajo: old versions of PAK files have no version stamp.
@@ -197,17 +181,13 @@ obj_besch_t *factory_supplier_reader_t::read_node(FILE *fp, obj_node_info_t &nod
 }
 
 
-obj_besch_t *factory_product_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t *factory_product_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
 	// DBG_DEBUG("factory_product_reader_t::read_node()", "called");
-	ALLOCA(char, besch_buf, node.size);
 
 	fabrik_produkt_besch_t *besch = new fabrik_produkt_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
-
 	char * p = besch_buf;
 
 	// Hajo: old versions of PAK files have no version stamp.
@@ -232,17 +212,13 @@ obj_besch_t *factory_product_reader_t::read_node(FILE *fp, obj_node_info_t &node
 }
 
 
-obj_besch_t *factory_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t *factory_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
 	// DBG_DEBUG("factory_reader_t::read_node()", "called");
-	ALLOCA(char, besch_buf, node.size);
 
 	fabrik_besch_t *besch = new fabrik_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
-
 	char * p = besch_buf;
 
 	// Hajo: old versions of PAK files have no version stamp.
@@ -16,7 +16,7 @@ class factory_field_class_reader_t : public obj_reader_t {
 public:
 	static factory_field_class_reader_t *instance() { return &the_instance; }
 
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_ffldclass; }
 	char const* get_type_name() const OVERRIDE { return "factory field class"; }
@@ -28,15 +28,12 @@ class factory_field_group_reader_t : public obj_reader_t {
 
 	factory_field_group_reader_t() { register_reader(); }
 
-	// hold a field class besch under construction
-	static field_class_besch_t* incomplete_field_class_besch;
-
 protected:
 	void register_obj(obj_besch_t*&) OVERRIDE;
 public:
 	static factory_field_group_reader_t *instance() { return &the_instance; }
 
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_ffield; }
 	char const* get_type_name() const OVERRIDE { return "factory field"; }
@@ -51,7 +48,7 @@ class factory_smoke_reader_t : public obj_reader_t {
 public:
 	static factory_smoke_reader_t*instance() { return &the_instance; }
 
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_fsmoke; }
 	char const* get_type_name() const OVERRIDE { return "factory smoke"; }
@@ -65,7 +62,7 @@ class factory_supplier_reader_t : public obj_reader_t {
 public:
 	static factory_supplier_reader_t*instance() { return &the_instance; }
 
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_fsupplier; }
 	char const* get_type_name() const OVERRIDE { return "factory supplier"; }
@@ -84,7 +81,7 @@ public:
 	 * compatibility transformations.
 	 * @author Hj. Malthaner
 	 */
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_fproduct; }
 	char const* get_type_name() const OVERRIDE { return "factory product"; }
@@ -103,7 +100,7 @@ public:
 
 	static factory_reader_t*instance() { return &the_instance; }
 
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_factory; }
 	char const* get_type_name() const OVERRIDE { return "factory"; }
@@ -29,10 +29,8 @@ bool good_reader_t::successfully_loaded() const
 }
 
 
-obj_besch_t * good_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t * good_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
-
 	ware_besch_t *besch = new ware_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
@@ -41,9 +39,6 @@ obj_besch_t * good_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 	besch->weight_per_unit = 100;
 	besch->color = 255;
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
-
 	char * p = besch_buf;
 
 	// Hajo: old versions of PAK files have no version stamp.
@@ -22,7 +22,7 @@ public:
 	 * compatibility transformations.
 	 * @author Hj. Malthaner
 	 */
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
 };
 
 #endif
@@ -21,13 +21,10 @@
 #define break_after_first_pixel break
 #endif
 
-obj_besch_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t *image_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
 	bild_besch_t* besch=NULL;
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
 	char * p = besch_buf+6;
 
 	// always zero in old version, since length was always less than 65535
@@ -164,6 +161,14 @@ obj_besch_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 		}
 	}
 
+	return besch;
+}
+
+
+void image_reader_t::register_obj(obj_besch_t *&data)
+{
+	bild_besch_t *besch = static_cast<bild_besch_t *>(data);
+
 	if (besch->pic.len != 0) {
 		// get the adler hash (since we have zlib on board anyway ... )
 		bool do_register_image = true;
@@ -196,9 +201,7 @@ obj_besch_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 		else {
 			// no need to load doubles ...
 			delete besch;
-			besch = same;
+			data = same;
 		}
 	}
-
-	return besch;
 }
@@ -13,7 +13,10 @@ public:
 
 	obj_type get_type() const OVERRIDE { return obj_image; }
 	char const* get_type_name() const OVERRIDE { return "image"; }
-	obj_besch_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_besch_t* read_node(char*, obj_node_info_t&) OVERRIDE;
+
+protected:
+	void register_obj(obj_besch_t*&) OVERRIDE;
 };
 
 #endif
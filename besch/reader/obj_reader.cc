@@ -1,5 +1,12 @@
 #include <string>
 #include <string.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 // for the progress bar
 #include "../../simcolor.h"
@@ -21,11 +28,14 @@
 
 #include "../../utils/searchfolder.h"
 #include "../../utils/simstring.h"
+#include "../../utils/simthread.h"
 
 #include "../../tpl/inthashtable_tpl.h"
 #include "../../tpl/ptrhashtable_tpl.h"
 #include "../../tpl/stringhashtable_tpl.h"
+#include "../../tpl/vector_tpl.h"
 #include "../../simdebug.h"
+#include "../../simmem.h"
 
 #include "../obj_besch.h"
 #include "../obj_node_info.h"
@@ -37,6 +47,13 @@ obj_reader_t::obj_map*                                         obj_reader_t::obj
 inthashtable_tpl<obj_type, stringhashtable_tpl<obj_besch_t*> > obj_reader_t::loaded;
 obj_reader_t::unresolved_map                                   obj_reader_t::unresolved;
 ptrhashtable_tpl<obj_besch_t**, int>                           obj_reader_t::fatals;
+ptrhashtable_tpl<obj_besch_t*, void*>                          obj_reader_t::deferred;
+
+#if MULTI_THREAD>1
+#include <pthread.h>
+static pthread_mutex_t deferred_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t pak_list_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 void obj_reader_t::register_reader()
 {
@@ -65,7 +82,9 @@ bool obj_reader_t::init()
 
 bool obj_reader_t::laden_abschliessen()
 {
+	const unsigned long ms = dr_time();
 	resolve_xrefs();
+	dbg->message("obj_reader_t::laden_abschliessen()", "cross references resolved in %lu ms", dr_time() - ms );
 
 	FOR(obj_map, const& i, *obj_reader) {
 		DBG_MESSAGE("obj_reader_t::laden_abschliessen()","Checking %s objects...", i.value->get_type_name());
@@ -81,6 +100,87 @@ bool obj_reader_t::laden_abschliessen()
 }
 
 
+/**
+ * Maps a whole pak file into memory, so the nodes can be parsed in place
+ * instead of reading each one with a separate fread. The mapping is private
+ * and writable, since the readers decode through a char pointer.
+ * Where mmap is not available, the file is read with a single fread.
+ * @return NULL on error or for an empty file
+ */
+static char *map_pak(const char *name, size_t &size)
+{
+	size = 0;
+#ifndef _WIN32
+	const int fd = open(name, O_RDONLY);
+	if(  fd < 0  ) {
+		return NULL;
+	}
+	struct stat st;
+	char *buf = NULL;
+	if(  fstat(fd, &st) == 0  &&  st.st_size > 0  ) {
+		void *const map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		if(  map != MAP_FAILED  ) {
+			// all nodes are visited once from start to end
+			madvise(map, st.st_size, MADV_SEQUENTIAL);
+			buf = (char *)map;
+			size = st.st_size;
+		}
+	}
+	close(fd);
+	return buf;
+#else
+	FILE *const fp = fopen(name, "rb");
+	if(  fp == NULL  ) {
+		return NULL;
+	}
+	char *buf = NULL;
+	fseek(fp, 0, SEEK_END);
+	const long len = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if(  len > 0  ) {
+		buf = MALLOCN(char, len);
+		if(  fread(buf, len, 1, fp) == 1  ) {
+			size = len;
+		}
+		else {
+			free(buf);
+			buf = NULL;
+		}
+	}
+	fclose(fp);
+	return buf;
+#endif
+}
+
+
+static void unmap_pak(char *buf, size_t size)
+{
+#ifndef _WIN32
+	munmap(buf, size);
+#else
+	(void)size;
+	free(buf);
+#endif
+}
+
+
+/**
+ * The pak files of one directory, which are parsed by several threads.
+ */
+struct obj_reader_t::pak_list_t {
+	struct file_t {
+		const char *name;
+		obj_besch_t *data;	// root node
+		vector_tpl<registration_t> registrations;
+	};
+	file_t *files;
+	uint32 count;
+	uint32 next;	// the first file not taken by a thread
+	loadingscreen_t *ls;	// updated by the calling thread, if drawing
+	uint32 progress_step;
+};
+
+
 bool obj_reader_t::load(const char *path, const char *message)
 {
 	searchfolder_t find;
@@ -158,13 +258,33 @@ DBG_MESSAGE("obj_reader_t::load()","big logo %p", skinverwaltung_t::biglogosymbo
 
 DBG_MESSAGE("obj_reader_t::load()", "reading from '%s'", name.c_str());
 
+		pak_list_t list;
+		list.files = new pak_list_t::file_t[max];
+		list.count = max;
+		list.next = 0;
+		list.ls = drawing ? &ls : NULL;
+		list.progress_step = step;
 		uint n = 0;
 		FORX(searchfolder_t, const& i, find, ++n) {
-			read_file(i);
-			if ((n & step) == 0 && drawing) {
-				ls.set_progress(n);
-			}
+			list.files[n].name = i;
+			list.files[n].data = NULL;
+		}
+
+		const unsigned long ms = dr_time();
+#if MULTI_THREAD>1
+		// the files are parsed by all threads
+		run_parallel( read_files_part, &list, max < MULTI_THREAD ? (max > 0 ? max : 1) : MULTI_THREAD );
+#else
+		read_files_part( &list, 0 );
+#endif
+		const unsigned long read_ms = dr_time();
+
+		// registering in the order of the files gives the same result (and pakset checksum) for any number of threads
+		for(  uint32 j = 0;  j < list.count;  j++  ) {
+			register_objs(list.files[j].registrations);
 		}
+		delete [] list.files;
+		dbg->message("obj_reader_t::load()", "%i files read in %lu ms, registered in %lu ms", max, read_ms - ms, dr_time() - read_ms );
 
 		return find.begin()!=find.end();
 	}
@@ -177,102 +297,172 @@ void obj_reader_t::read_file(const char *name)
 	// Hajo: added trace
 	DBG_DEBUG("obj_reader_t::read_file()", "filename='%s'", name);
 
-	if (FILE* const fp = fopen(name, "rb")) {
-		sint32 n = 0;
+	size_t size;
+	if (char* const buf = map_pak(name, size)) {
+		obj_besch_t *data = NULL;
+		vector_tpl<registration_t> registrations;
+		read_pak(buf, size, name, data, registrations);
+		unmap_pak(buf, size);
+		register_objs(registrations);
+	}
+	else {
+		// Hajo: added error check
+		dbg->error("obj_reader_t::read_file()", "reading '%s' failed!", name);
+	}
+}
 
-		// This is the normal header reading code
-		int c;
-		do {
-			c = fgetc(fp);
-			n ++;
-		} while(!feof(fp) && c != 0x1a);
 
-		if(feof(fp)) {
-			// Hajo: added error check
-			dbg->error("obj_reader_t::read_file()",	"unexpected end of file after %d bytes while reading '%s'!",n, name);
-		}
-		else {
-//			DBG_DEBUG("obj_reader_t::read_file()", "skipped %d header bytes", n);
+/**
+ * Parses the next file of the list which is not taken by another thread.
+ * @return false, if all files are taken
+ */
+bool obj_reader_t::read_next_file(pak_list_t &list)
+{
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &pak_list_mutex );
+#endif
+	const uint32 n = list.next;
+	if(  n < list.count  ) {
+		list.next ++;
+	}
+#if MULTI_THREAD>1
+	pthread_mutex_unlock( &pak_list_mutex );
+#endif
+	if(  n >= list.count  ) {
+		return false;
+	}
+
+	pak_list_t::file_t &file = list.files[n];
+	DBG_DEBUG("obj_reader_t::read_file()", "filename='%s'", file.name);
+	size_t size;
+	if(  char *const buf = map_pak(file.name, size)  ) {
+		read_pak(buf, size, file.name, file.data, file.registrations);
+		unmap_pak(buf, size);
+	}
+	else {
+		dbg->error("obj_reader_t::read_file()", "reading '%s' failed!", file.name);
+	}
+	return true;
+}
+
+
+void obj_reader_t::read_files_part(void *args, int nr)
+{
+	pak_list_t &list = *(pak_list_t *)args;
+	uint32 shown = 0;
+	while(  read_next_file(list)  ) {
+		// the calling thread also updates the progress bar
+		if(  nr == 0  &&  list.ls  &&  list.next > shown + list.progress_step  ) {
+			shown = list.next;
+			list.ls->set_progress(shown);
 		}
+	}
+}
 
-		// Compiled Verison
-		uint32 version = 0;
-		char dummy[4], *p;
-		p = dummy;
 
-		n = fread(dummy, 4, 1, fp);
-		version = decode_uint32(p);
+void obj_reader_t::register_objs(const vector_tpl<registration_t> &registrations)
+{
+	FOR(vector_tpl<registration_t>, const& r, registrations) {
+		r.reader->register_obj(*r.data);
+	}
+}
 
-		DBG_DEBUG("obj_reader_t::read_file()", "read %d blocks, file version is %x", n, version);
+
+/**
+ * Parses the nodes of a pak file in memory. register_obj() is not called yet,
+ * the nodes which need it are appended to registrations in the right order.
+ */
+void obj_reader_t::read_pak(char *buf, size_t size, const char *name, obj_besch_t *&data, vector_tpl<registration_t> &registrations)
+{
+	char *const end = buf + size;
+
+	// This is the normal header reading code
+	char *p = (char *)memchr(buf, 0x1a, size);
+
+	if(  p == NULL  ||  end - p < 5  ) {
+		// Hajo: added error check
+		dbg->error("obj_reader_t::read_file()",	"unexpected end of file after %d bytes while reading '%s'!", (int)size, name);
+	}
+	else {
+		p ++;
+
+		// Compiled Verison
+		uint32 version = decode_uint32(p);
+
+		DBG_DEBUG("obj_reader_t::read_file()", "skipped %d header bytes, file version is %x", (int)(p - buf - 4), version);
 
 		if(version <= COMPILER_VERSION_CODE) {
-			obj_besch_t *data = NULL;
-			read_nodes(fp, data, 0, version );
+			read_nodes(p, end, data, 0, version, registrations );
 		}
 		else {
 			DBG_DEBUG("obj_reader_t::read_file()","version of '%s' is too old, %d instead of %d", name, version, COMPILER_VERSION_CODE );
 		}
-		fclose(fp);
-	}
-	else {
-		// Hajo: added error check
-		dbg->error("obj_reader_t::read_file()", "reading '%s' failed!", name);
 	}
 }
 
 
-void obj_reader_t::read_nodes(FILE* fp, obj_besch_t*& data, int register_nodes, uint32 version )
+/**
+ * Decodes a node header at p and checks that the node fits into the file.
+ * Advances p to the node data.
+ */
+static void read_node_info(char *&p, const char *end, obj_node_info_t &node, uint32 version)
 {
-	obj_node_info_t node;
-	char load_dummy[EXT_OBJ_NODE_INFO_SIZE], *p;
-
-	p = load_dummy;
-	if(  version==COMPILER_VERSION_CODE_11  ) {
-		fread(p, OBJ_NODE_INFO_SIZE, 1, fp);
-		node.type = decode_uint32(p);
-		node.children = decode_uint16(p);
-		node.size = decode_uint16(p);
+	if(  end - p < OBJ_NODE_INFO_SIZE  ) {
+		dbg->fatal("obj_reader_t::read_node_info()", "pak file truncated in node header");
 	}
-	else {
+	node.type = decode_uint32(p);
+	node.children = decode_uint16(p);
+	node.size = decode_uint16(p);
+	if(  version!=COMPILER_VERSION_CODE_11  &&  node.size==LARGE_RECORD_SIZE  ) {
 		// can have larger records
-		fread(p, OBJ_NODE_INFO_SIZE, 1, fp);
-		node.type = decode_uint32(p);
-		node.children = decode_uint16(p);
-		node.size = decode_uint16(p);
-		if(  node.size==LARGE_RECORD_SIZE  ) {
-			fread(p, 4, 1, fp);
-			node.size = decode_uint32(p);
+		if(  end - p < 4  ) {
+			dbg->fatal("obj_reader_t::read_node_info()", "pak file truncated in node header");
 		}
+		node.size = decode_uint32(p);
+	}
+	if(  (size_t)(end - p) < node.size  ) {
+		dbg->fatal("obj_reader_t::read_node_info()", "pak file truncated in %.4s-node of size %u", reinterpret_cast<const char *>(&node.type), node.size);
 	}
+}
+
+
+void obj_reader_t::read_nodes(char *&p, const char *end, obj_besch_t*& data, int register_nodes, uint32 version, vector_tpl<registration_t> &registrations )
+{
+	obj_node_info_t node;
+	read_node_info(p, end, node, version);
 
 	obj_reader_t *reader = obj_reader->get(static_cast<obj_type>(node.type));
 	if(reader) {
 
 //DBG_DEBUG("obj_reader_t::read_nodes()","Reading %.4s-node of length %d with '%s'",	reinterpret_cast<const char *>(&node.type),	node.size,	reader->get_type_name());
-		data = reader->read_node(fp, node);
+		data = reader->read_node(p, node);
+		p += node.size;
 		for(int i = 0; i < node.children; i++) {
-			read_nodes(fp, data->node_info[i], register_nodes+1, version);
+			read_nodes(p, end, data->node_info[i], register_nodes+1, version, registrations);
 		}
 
 //DBG_DEBUG("obj_reader_t","registering with '%s'", reader->get_type_name());
 		if(register_nodes<2  ||  node.type!=obj_cursor) {
 			// since many buildings are with cursors that do not need registration
-			reader->register_obj(data);
+			registration_t r;
+			r.reader = reader;
+			r.data = &data;
+			registrations.append(r);
 		}
 	}
 	else {
 		// no reader found ...
 		dbg->warning("obj_reader_t::read_nodes()","skipping unknown %.4s-node\n",reinterpret_cast<const char *>(&node.type));
-		fseek(fp, node.size, SEEK_CUR);
+		p += node.size;
 		for(int i = 0; i < node.children; i++) {
-			skip_nodes(fp,version);
+			skip_nodes(p, end, version);
 		}
 		data = NULL;
 	}
 }
 
 
-obj_besch_t *obj_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t *obj_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
 	obj_besch_t* besch = new(node.size) obj_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
@@ -280,45 +470,51 @@ obj_besch_t *obj_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 	if(node.size>0) {
 		// not 32/64 Bit compatible for everything but char!
 		dbg->warning("obj_reader_t::read_node()","native called on type %.4s (size %i), will break on 64Bit if type!=ASCII",reinterpret_cast<const char *>(&node.type),node.size);
-		fread(besch + 1, node.size, 1, fp);
+		memcpy(besch + 1, besch_buf, node.size);
 	}
 
 	return besch;
 }
 
 
-void obj_reader_t::skip_nodes(FILE *fp,uint32 version)
+void obj_reader_t::skip_nodes(char *&p, const char *end, uint32 version)
 {
 	obj_node_info_t node;
-	char load_dummy[OBJ_NODE_INFO_SIZE], *p;
-
-	p = load_dummy;
-	if(  version==COMPILER_VERSION_CODE_11  ) {
-		fread(p, OBJ_NODE_INFO_SIZE, 1, fp);
-		node.type = decode_uint32(p);
-		node.children = decode_uint16(p);
-		node.size = decode_uint16(p);
-	}
-	else {
-		// can have larger records
-		fread(p, OBJ_NODE_INFO_SIZE, 1, fp);
-		node.type = decode_uint32(p);
-		node.children = decode_uint16(p);
-		node.size = decode_uint16(p);
-		if(  node.size==LARGE_RECORD_SIZE  ) {
-			fread(p, 4, 1, fp);
-			node.size = decode_uint32(p);
-		}
-	}
+	read_node_info(p, end, node, version);
 //DBG_DEBUG("obj_reader_t::skip_nodes", "type %.4s (size %d)",reinterpret_cast<const char *>(&node.type),node.size);
 
-	fseek(fp, node.size, SEEK_CUR);
+	p += node.size;
 	for(int i = 0; i < node.children; i++) {
-		skip_nodes(fp,version);
+		skip_nodes(p, end, version);
 	}
 }
 
 
+void obj_reader_t::set_deferred(obj_besch_t *besch, void *data)
+{
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &deferred_mutex );
+#endif
+	deferred.put(besch, data);
+#if MULTI_THREAD>1
+	pthread_mutex_unlock( &deferred_mutex );
+#endif
+}
+
+
+void *obj_reader_t::get_deferred(obj_besch_t *besch)
+{
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &deferred_mutex );
+#endif
+	void *const data = deferred.remove(besch);
+#if MULTI_THREAD>1
+	pthread_mutex_unlock( &deferred_mutex );
+#endif
+	return data;
+}
+
+
 void obj_reader_t::delete_node(obj_besch_t *data)
 {
 	delete [] data->node_info;
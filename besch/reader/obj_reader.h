@@ -15,6 +15,7 @@ template<class key_t, class value_t> class inthashtable_tpl;
 template<class value_t> class stringhashtable_tpl;
 template<class key_t, class value_t> class ptrhashtable_tpl;
 template<class T> class slist_tpl;
+template<class T> class vector_tpl;
 
 
 
@@ -76,10 +77,26 @@ class obj_reader_t
 	typedef inthashtable_tpl<obj_type, stringhashtable_tpl<slist_tpl<obj_besch_t**> > > unresolved_map;
 	static unresolved_map unresolved;
 	static ptrhashtable_tpl<obj_besch_t **, int>  fatals;
+	//
+	// data kept by read_node() for register_obj(), see set_deferred()
+	//
+	static ptrhashtable_tpl<obj_besch_t *, void *> deferred;
+
+	// a node waiting for register_obj(), with the address of the pointer to it
+	struct registration_t {
+		obj_reader_t *reader;
+		obj_besch_t **data;
+	};
+	struct pak_list_t;
 
 	static void read_file(const char *name);
-	static void read_nodes(FILE* fp, obj_besch_t*& data, int register_nodes,uint32 version);
-	static void skip_nodes(FILE *fp,uint32 version);
+	static void read_pak(char *buf, size_t size, const char *name, obj_besch_t *&data, vector_tpl<registration_t> &registrations);
+	static void read_nodes(char *&p, const char *end, obj_besch_t*& data, int register_nodes,uint32 version, vector_tpl<registration_t> &registrations);
+	static void skip_nodes(char *&p, const char *end, uint32 version);
+	static void register_objs(const vector_tpl<registration_t> &registrations);
+
+	static bool read_next_file(pak_list_t &list);
+	static void read_files_part(void *args, int nr);
 
 protected:
 	static void delete_node(obj_besch_t *node);
@@ -91,13 +108,25 @@ protected:
 	static void xref_to_resolve(obj_type type, const char *name, obj_besch_t **dest, bool fatal);
 	static void resolve_xrefs();
 
+	/**
+	 * read_node() runs in several threads while a directory is loaded,
+	 * and register_obj() is called afterwards in the order of the files.
+	 * So read_node() must not look at other objects; anything which needs
+	 * them waits for register_obj(), which gets data for this back from
+	 * get_deferred() (once, it is removed then).
+	 */
+	static void set_deferred(obj_besch_t *besch, void *data);
+	static void *get_deferred(obj_besch_t *besch);
+
 	/**
 	 * Hajo 11-Oct-03:
 	 * this method reads a node. I made this virtual to
 	 * allow subclasses to define their own strategies how to
 	 * read nodes.
+	 * besch_buf points to the node.size bytes of the node in the
+	 * mapped pak file; it is only valid during this call.
 	 */
-	virtual obj_besch_t *read_node(FILE *fp, obj_node_info_t &node);
+	virtual obj_besch_t *read_node(char *besch_buf, obj_node_info_t &node);
 	virtual void register_obj(obj_besch_t *&/*data*/) {}
 	virtual bool successfully_loaded() const { return true; }
 
@@ -30,15 +30,11 @@ bool roadsign_reader_t::successfully_loaded() const
 }
 
 
-obj_besch_t * roadsign_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t * roadsign_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
-
 	roadsign_besch_t *besch = new roadsign_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
 	char * p = besch_buf;
 
 	const uint16 v = decode_uint16(p);
@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "../sound_besch.h"
 #include "sound_reader.h"
@@ -11,20 +13,20 @@
 void sound_reader_t::register_obj(obj_besch_t *&data)
 {
 	sound_besch_t *besch = static_cast<sound_besch_t *>(data);
+	if(  char *const wavname = static_cast<char *>(get_deferred(besch))  ) {
+		besch->nr = sound_besch_t::get_sound_id(wavname);
+		free(wavname);
+	}
 	sound_besch_t::register_besch(besch);
 	DBG_DEBUG("sound_reader_t::read_node()","sound %s registered at %i",besch->get_name(),besch->sound_id);
 }
 
 
-obj_besch_t * sound_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t * sound_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
-
 	sound_besch_t *besch = new sound_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-		// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
 	char * p = besch_buf;
 
 	const uint16 v = decode_uint16(p);
@@ -39,7 +41,11 @@ obj_besch_t * sound_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 		besch->nr = decode_uint16(p);
 		uint16 len = decode_uint16(p);
 		if(  len>0  ) {
-			besch->nr = besch->get_sound_id(p);
+			// the sound is looked up in register_obj(), since loading it is not thread safe
+			char *const wavname = (char *)malloc(len + 1);
+			memcpy(wavname, p, len);
+			wavname[len] = 0;
+			set_deferred(besch, wavname);
 		}
 	}
 	else {
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 #include "../../simdebug.h"
 
 #include "../text_besch.h"
@@ -7,13 +8,12 @@
 #include "../obj_node_info.h"
 
 
-obj_besch_t * text_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t * text_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
 	text_besch_t* besch = new(node.size) text_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch->text, node.size, 1, fp);
+	memcpy(besch->text, besch_buf, node.size);
 
 //	DBG_DEBUG("text_reader_t::read_node()", "%s",besch->get_text() );
 
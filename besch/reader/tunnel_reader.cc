@@ -49,7 +49,7 @@ void tunnel_reader_t::convert_old_tunnel(tunnel_besch_t *besch)
 }
 
 
-obj_besch_t * tunnel_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t * tunnel_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
 	tunnel_besch_t *besch = new tunnel_besch_t();
 	besch->topspeed = 0;	// indicate, that we have to convert this to reasonable date, when read completely
@@ -57,10 +57,6 @@ obj_besch_t * tunnel_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 
 	if(node.size>0) {
 		// newer versioned node
-		ALLOCA(char, besch_buf, node.size);
-
-		fread(besch_buf, node.size, 1, fp);
-
 		char * p = besch_buf;
 
 		const uint16 v = decode_uint16(p);
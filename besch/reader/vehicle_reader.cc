@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "../../simdebug.h"
 #include "../../simconst.h"
 #include "../../bauer/vehikelbauer.h"
@@ -15,6 +17,17 @@
 void vehicle_reader_t::register_obj(obj_besch_t *&data)
 {
 	vehikel_besch_t *besch = static_cast<vehikel_besch_t *>(data);
+	if(besch->sound==LOAD_SOUND) {
+		char *const wavname = static_cast<char *>(get_deferred(besch));
+		besch->sound = (sint8)sound_besch_t::get_sound_id(wavname);
+DBG_MESSAGE("vehicle_reader_t::register_obj()","sound %s to %i",wavname,besch->sound);
+		free(wavname);
+	}
+	else if(besch->sound>=0  &&  besch->sound<=MAX_OLD_SOUNDS) {
+		sint16 old_id = besch->sound;
+		besch->sound = (sint8)sound_besch_t::get_compatible_sound_id((sint8)old_id);
+DBG_MESSAGE("vehicle_reader_t::register_obj()","old sound %i to %i",old_id,besch->sound);
+	}
 	vehikelbauer_t::register_besch(besch);
 	obj_for_xref(get_type(), besch->get_name(), data);
 
@@ -30,15 +43,11 @@ bool vehicle_reader_t::successfully_loaded() const
 }
 
 
-obj_besch_t *vehicle_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t *vehicle_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
-
 	vehikel_besch_t *besch = new vehikel_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
 	char * p = besch_buf;
 
 	// Hajo: old versions of PAK files have no version stamp.
@@ -597,13 +606,8 @@ obj_besch_t *vehicle_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 		for(uint8 i=0; i<len; i++) {
 			wavname[i] = decode_sint8(p);
 		}
-		besch->sound = (sint8)sound_besch_t::get_sound_id(wavname);
-DBG_MESSAGE("vehicle_reader_t::register_obj()","sound %s to %i",wavname,besch->sound);
-	}
-	else if(besch->sound>=0  &&  besch->sound<=MAX_OLD_SOUNDS) {
-		sint16 old_id = besch->sound;
-		besch->sound = (sint8)sound_besch_t::get_compatible_sound_id((sint8)old_id);
-DBG_MESSAGE("vehicle_reader_t::register_obj()","old sound %i to %i",old_id,besch->sound);
+		// the sound is looked up in register_obj()
+		set_deferred(besch, strdup(wavname));
 	}
 	besch->loaded();
 
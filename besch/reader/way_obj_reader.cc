@@ -27,16 +27,12 @@ bool way_obj_reader_t::successfully_loaded() const
 }
 
 
-obj_besch_t * way_obj_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t * way_obj_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
-	ALLOCA(char, besch_buf, node.size);
-
 	way_obj_besch_t *besch = new way_obj_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 	// DBG_DEBUG("way_reader_t::read_node()", "node size = %d", node.size);
 
-	// Hajo: Read data
-	fread(besch_buf, node.size, 1, fp);
 	char * p = besch_buf;
 
 	// Hajo: old versions of PAK files have no version stamp.
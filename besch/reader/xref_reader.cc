@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 #include "../../simdebug.h"
 #include "../xref_besch.h"
 #include "xref_reader.h"
@@ -6,17 +7,15 @@
 #include "../obj_node_info.h"
 
 
-obj_besch_t * xref_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_besch_t * xref_reader_t::read_node(char *besch_buf, obj_node_info_t &node)
 {
 	xref_besch_t* besch = new(node.size - 4 - 1) xref_besch_t();
 	besch->node_info = new obj_besch_t*[node.children];
 
-	char buf[4 + 1];
-	fread(buf, 1, 5, fp);
-	char* p = buf;
+	char* p = besch_buf;
 	besch->type = static_cast<obj_type>(decode_uint32(p));
 	besch->fatal = (decode_uint8(p) != 0);
-	fread(besch->name, 1, node.size - 4 - 1, fp);
+	memcpy(besch->name, p, node.size - 4 - 1);
 
 //	DBG_DEBUG("xref_reader_t::read_node()", "%s",besch->get_text() );
 
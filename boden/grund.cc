@@ -614,6 +614,8 @@ void grund_t::calc_bild()
 	dinge.calc_bild();
 	// since bridges may alter images of ways, this order is needed!
 	calc_bild_internal();
+	// also the cached ground must be drawn again
+	set_flag(dirty);
 }
 
 
@@ -682,6 +684,8 @@ void grund_t::mark_image_dirty()
 		const sint16 y = (diff.x+diff.y)*(rasterweite/4) + tile_raster_scale_y( -get_disp_height()*TILE_HEIGHT_STEP, rasterweite) + ((display_get_width()/rasterweite)&1)*(rasterweite/4);
 		// mark the region after the image as dirty
 		display_mark_img_dirty( bild_nr, x+welt->get_x_off(), y+welt->get_y_off() );
+		// and the ground there must be drawn again
+		display_ground_cache_invalidate_img( bild_nr, x+welt->get_x_off(), y+welt->get_y_off() );
 	}
 }
 
@@ -983,6 +987,21 @@ void grund_t::display_if_visible(sint16 xpos, sint16 ypos, sint16 raster_tile_wi
 }
 
 
+bool grund_t::is_boden_dirty() const
+{
+	if(  get_flag(grund_t::dirty)  ||  (get_typ()==wasser  &&  wasser_t::change_stage)  ) {
+		return true;
+	}
+	// the ways are drawn with the ground
+	for(  uint8 i=0;  i<offsets[flags/has_way1];  i++  ) {
+		if(  obj_bei(i)->get_flag(ding_t::dirty)  ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
 hang_t::typ grund_t::get_disp_way_slope() const
 {
 	if (is_visible()) {
@@ -469,6 +469,12 @@ public:
 	 */
 	void display_if_visible(sint16 xpos, sint16 ypos, sint16 raster_tile_width);
 
+	/**
+	 * True, if display_if_visible() may draw something else than in the last frame,
+	 * since the ground, its ways or the water animation changed.
+	 */
+	bool is_boden_dirty() const;
+
 	/**
 	 * displays everything that is on a tile - the main display routine for objects on tiles
 	 * @param is_global set to true, if this is called during the whole screen update
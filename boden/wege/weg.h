@@ -339,7 +339,7 @@ public:
 	// this is needed during a change from crossing to tram track
 	void clear_crossing() { flags &= ~HAS_CROSSING; }
 
-	inline void set_bild( image_id b ) { bild = b; }
+	inline void set_bild( image_id b ) { bild = b; set_flag(ding_t::dirty); }
 	image_id get_bild() const {return bild;}
 
 	inline void set_after_bild( image_id b ) { after_bild = b; }
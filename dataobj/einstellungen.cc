@@ -1788,6 +1788,9 @@ void settings_t::parse_simuconf(tabfile_t& simuconf, sint16& disp_width, sint16&
 	}
 
 	umgebung_t::autosave = (contents.get_int("autosave", umgebung_t::autosave) );
+	umgebung_t::delta_autosaves = contents.get_int("delta_autosaves", umgebung_t::delta_autosaves );
+	umgebung_t::image_cache_size = contents.get_int("image_cache_size", umgebung_t::image_cache_size );
+	umgebung_t::ground_cache = contents.get_int("ground_cache", umgebung_t::ground_cache ) != 0;
 
 	// routing stuff
 	uint16 city_short_range_percentage = passenger_routing_local_chance;
@@ -2383,6 +2386,8 @@ void settings_t::parse_simuconf(tabfile_t& simuconf, sint16& disp_width, sint16&
 		loadsave_t::set_savemode(loadsave_t::bzip2 );
 	} else if(strcmp(str, "xml_bzip2") == 0) {
 		loadsave_t::set_savemode(loadsave_t::xml_bzip2 );
+	} else if(strcmp(str, "zipped_blocks") == 0) {
+		loadsave_t::set_savemode(loadsave_t::zipped_blocks );
 	}
 
 	str = contents.get("autosaveformat" );
@@ -2399,6 +2404,8 @@ void settings_t::parse_simuconf(tabfile_t& simuconf, sint16& disp_width, sint16&
 		loadsave_t::set_autosavemode(loadsave_t::bzip2 );
 	} else if(strcmp(str, "xml_bzip2") == 0) {
 		loadsave_t::set_autosavemode(loadsave_t::xml_bzip2 );
+	} else if(strcmp(str, "zipped_blocks") == 0) {
+		loadsave_t::set_autosavemode(loadsave_t::zipped_blocks );
 	}
 
 	/*
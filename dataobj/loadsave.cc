@@ -17,7 +17,9 @@
 #include "../besch/grund_besch.h"
 
 #include "../utils/simstring.h"
+#include "../utils/simthread.h"
 
+#include <time.h>
 #include <zlib.h> 
 #include <bzlib.h>
 
@@ -75,23 +77,667 @@ void *loadsave_thread( void *ptr )
 #endif
 
 
+/*
+ * The zipped_blocks format: the magic and the block size, then the blocks.
+ * In front of each block are its packed and its unpacked length (32 bit,
+ * little endian), followed by the deflated data. A packed length of zero
+ * ends the file. Since the lengths tell where each block starts, the blocks
+ * are compressed and uncompressed independently and hence in parallel.
+ * The result does not depend on the number of threads.
+ *
+ * Segmented files have some more entries with a special packed length and
+ * without data: LS_BLOCK_SEGMENT starts the segment with the id given as
+ * unpacked length, LS_BLOCK_ID gives the id of the file. In a file saved
+ * against a base, LS_BLOCK_BASE is followed by the id and the name (the
+ * unpacked length is the length of the name) of the base file, and
+ * LS_BLOCK_REFERENCE stands for the blocks of a segment of the base.
+ */
+#define LS_BLOCK_MAGIC "SBLK"
+#define LS_BLOCK_SIZE (256*1024)
+// larger block sizes in a file are considered broken
+#define LS_BLOCK_MAX_SIZE (16*1024*1024)
+#if MULTI_THREAD>1
+// blocks packed or unpacked at once
+#define LS_BLOCKS (MULTI_THREAD*2)
+#else
+#define LS_BLOCKS (1)
+#endif
+
+#define LS_BLOCK_SEGMENT   (0xFFFFFFFFu)
+#define LS_BLOCK_ID        (0xFFFFFFFEu)
+#define LS_BLOCK_BASE      (0xFFFFFFFDu)
+#define LS_BLOCK_REFERENCE (0xFFFFFFFCu)
+// larger packed lengths are one of the above
+#define LS_BLOCK_SPECIAL   (0xFFFFFFF0u)
+
+#if MULTI_THREAD>1
+// for the segment starts, which are added by the main thread
+static pthread_mutex_t segment_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+struct ls_block_t {
+	char *raw;
+	uint32 raw_len;
+	char *packed;
+	uint32 packed_len;
+	bool ok;
+};
+
+struct segment_start_t {
+	uint64 pos;
+	uint32 id;
+	segment_start_t() : pos(0), id(0) {}
+	segment_start_t(uint64 p, uint32 i) : pos(p), id(i) {}
+};
+
+struct block_stream_t {
+	ls_block_t block[LS_BLOCKS];
+	uint32 block_size;
+	uint32 packed_size;	// space for a packed block
+	int count;	// blocks filled
+	int curr;	// when reading: the block at the read position
+	uint32 pos;	// when reading: the position in this block
+	bool eof;	// when reading: the end block was reached
+	bool error;
+	// when reading from memory
+	const char *in_data;
+	size_t in_len, in_pos;
+	std::string filename;	// when reading: to find the base file
+
+	// when writing segments
+	const savegame_segments_t *ref;	// segments of the base
+	savegame_segments_t *rec;	// segments written
+	vector_tpl<segment_start_t> starts;	// from loadsave_t::start_segment()
+	uint32 next_start;
+	uint64 pos_in;	// bytes passed to block_write()
+	uint32 segment;	// the current one
+	uLong crc, adler;
+	uint64 seg_len;
+	char *seg_buf;	// data of the current segment, until it is known whether it changed
+	size_t seg_buf_len, seg_buf_size;
+
+	// when reading a file with references
+	file_descriptors_t *base_fd;
+	uint32 base_segment;	// segment at the read position of the base file
+	bool base_end;
+	bool copying;	// reading the blocks of a segment of the base
+};
+
+
 struct file_descriptors_t {
 	FILE *fp;
 	gzFile gzfp;
 	BZFILE *bzfp;
 	int bse;
-	file_descriptors_t() : fp(NULL), gzfp(NULL), bzfp(NULL), bse(BZ_OK+1) {}
+	// for zipped_blocks
+	block_stream_t *bs;
+	// for writing a memory file: instead of fp
+	memory_file_t *mem;
+	file_descriptors_t() : fp(NULL), gzfp(NULL), bzfp(NULL), bse(BZ_OK+1), bs(NULL), mem(NULL) {}
 };
 
 
+static block_stream_t *block_open(uint32 block_size)
+{
+	block_stream_t *bs = new block_stream_t;
+	bs->block_size = block_size;
+	bs->packed_size = compressBound( block_size );
+	for(  int i=0;  i<LS_BLOCKS;  i++  ) {
+		bs->block[i].raw = MALLOCN( char, block_size );
+		bs->block[i].raw_len = 0;
+		bs->block[i].packed = MALLOCN( char, bs->packed_size );
+		bs->block[i].packed_len = 0;
+	}
+	bs->count = 0;
+	bs->curr = 0;
+	bs->pos = 0;
+	bs->eof = false;
+	bs->error = false;
+	bs->in_data = NULL;
+	bs->in_len = bs->in_pos = 0;
+	bs->ref = NULL;
+	bs->rec = NULL;
+	bs->next_start = 0;
+	bs->pos_in = 0;
+	bs->segment = 0;
+	bs->crc = bs->adler = 0;
+	bs->seg_len = 0;
+	bs->seg_buf = NULL;
+	bs->seg_buf_len = bs->seg_buf_size = 0;
+	bs->base_fd = NULL;
+	bs->base_segment = 0;
+	bs->base_end = false;
+	bs->copying = false;
+	return bs;
+}
+
+
+static void block_close(block_stream_t *bs)
+{
+	for(  int i=0;  i<LS_BLOCKS;  i++  ) {
+		free( bs->block[i].raw );
+		free( bs->block[i].packed );
+	}
+	free( bs->seg_buf );
+	if(  bs->base_fd  ) {
+		fclose( bs->base_fd->fp );
+		delete bs->base_fd;
+	}
+	delete bs;
+}
+
+
+// writes to the file or appends to the memory file
+static bool block_out(file_descriptors_t *fd, const void *data, size_t len)
+{
+	if(  memory_file_t *mem = fd->mem  ) {
+		if(  mem->len + len > mem->size  ) {
+			mem->size = mem->size ? mem->size * 2 : LS_BUF_SIZE;
+			if(  mem->size < mem->len + len  ) {
+				mem->size = mem->len + len;
+			}
+			mem->data = REALLOC( mem->data, char, mem->size );
+		}
+		memcpy( mem->data + mem->len, data, len );
+		mem->len += len;
+		return true;
+	}
+	return fwrite( data, 1, len, fd->fp ) == len;
+}
+
+
+// reads exactly len bytes from the file or the memory file
+static bool block_in(file_descriptors_t *fd, void *data, size_t len)
+{
+	block_stream_t *bs = fd->bs;
+	if(  bs  &&  bs->in_data  ) {
+		if(  bs->in_pos + len > bs->in_len  ) {
+			return false;
+		}
+		memcpy( data, bs->in_data + bs->in_pos, len );
+		bs->in_pos += len;
+		return true;
+	}
+	return fread( data, 1, len, fd->fp ) == len;
+}
+
+
+static bool block_header_in(file_descriptors_t *fd, uint32 &packed_len, uint32 &raw_len)
+{
+	uint32 header[2];
+	if(  !block_in( fd, header, sizeof(header) )  ) {
+		return false;
+	}
+	packed_len = endian( header[0] );
+	raw_len = endian( header[1] );
+	return true;
+}
+
+
+static bool block_header_out(file_descriptors_t *fd, uint32 packed_len, uint32 raw_len)
+{
+	uint32 header[2];
+	header[0] = endian( packed_len );
+	header[1] = endian( raw_len );
+	return block_out( fd, header, sizeof(header) );
+}
+
+
+typedef struct {
+	block_stream_t *bs;
+	int step;	// every step-th block from the number of the part on
+	bool pack;
+} block_run_param_t;
+
+
+static void block_part(void *ptr, int nr)
+{
+	block_run_param_t *param = reinterpret_cast<block_run_param_t *>(ptr);
+	block_stream_t *bs = param->bs;
+	for(  int i=nr;  i<bs->count;  i+=param->step  ) {
+		ls_block_t &b = bs->block[i];
+		if(  param->pack  ) {
+			uLongf len = bs->packed_size;
+			b.ok = compress2( (Bytef *)b.packed, &len, (const Bytef *)b.raw, b.raw_len, Z_DEFAULT_COMPRESSION ) == Z_OK;
+			b.packed_len = (uint32)len;
+		}
+		else {
+			uLongf len = bs->block_size;
+			b.ok = uncompress( (Bytef *)b.raw, &len, (const Bytef *)b.packed, b.packed_len ) == Z_OK  &&  len == b.raw_len;
+		}
+	}
+}
+
+
+// packs or unpacks all filled blocks
+static void block_run(block_stream_t *bs, bool pack)
+{
+	block_run_param_t param;
+	param.bs = bs;
+#if MULTI_THREAD>1
+	param.step = min( MULTI_THREAD, bs->count );
+#else
+	param.step = 1;
+#endif
+	param.pack = pack;
+	run_parallel( block_part, &param, param.step );
+}
+
+
+// packs and writes the filled blocks
+static void block_flush(file_descriptors_t *fd)
+{
+	block_stream_t *bs = fd->bs;
+	if(  bs->count == 0  ) {
+		return;
+	}
+	block_run( bs, true );
+	for(  int i=0;  i<bs->count;  i++  ) {
+		ls_block_t &b = bs->block[i];
+		if(  !b.ok  ||  !block_header_out( fd, b.packed_len, b.raw_len )  ||  !block_out( fd, b.packed, b.packed_len )  ) {
+			bs->error = true;
+		}
+		b.raw_len = 0;
+	}
+	bs->count = 0;
+}
+
+
+static void block_raw_write(file_descriptors_t *fd, const char *p, size_t len)
+{
+	block_stream_t *bs = fd->bs;
+	while(  len > 0  ) {
+		ls_block_t &b = bs->block[bs->count];
+		const size_t space = bs->block_size - b.raw_len;
+		const uint32 n = (uint32)(len < space ? len : space);
+		memcpy( b.raw + b.raw_len, p, n );
+		b.raw_len += n;
+		p += n;
+		len -= n;
+		if(  b.raw_len == bs->block_size  ) {
+			bs->count++;
+			if(  bs->count == LS_BLOCKS  ) {
+				block_flush( fd );
+			}
+		}
+	}
+}
+
+
+// writes all data so far, then an entry without data
+static void block_special_out(file_descriptors_t *fd, uint32 packed_len, uint32 raw_len)
+{
+	block_stream_t *bs = fd->bs;
+	if(  bs->block[bs->count].raw_len > 0  ) {
+		bs->count++;
+	}
+	block_flush( fd );
+	if(  !block_header_out( fd, packed_len, raw_len )  ) {
+		bs->error = true;
+	}
+}
+
+
+static void block_end_segment(file_descriptors_t *fd)
+{
+	block_stream_t *bs = fd->bs;
+	const uint32 id = bs->segment;
+	if(  id == 0  ) {
+		return;
+	}
+	savegame_segments_t::segment_t seg;
+	seg.checksum = ((uint64)bs->crc << 32) | bs->adler;
+	seg.len = bs->seg_len;
+	if(  bs->rec  ) {
+		bs->rec->segments.store_at( id, seg );
+	}
+	if(  bs->ref  ) {
+		if(  id < bs->ref->segments.get_count()  &&  bs->ref->segments[id].len == seg.len  &&  bs->ref->segments[id].checksum == seg.checksum  ) {
+			// unchanged since the base
+			block_special_out( fd, LS_BLOCK_REFERENCE, id );
+		}
+		else {
+			block_raw_write( fd, bs->seg_buf, bs->seg_buf_len );
+		}
+		bs->seg_buf_len = 0;
+	}
+	bs->segment = 0;
+}
+
+
+static void block_start_segment(file_descriptors_t *fd, uint32 id)
+{
+	block_stream_t *bs = fd->bs;
+	block_end_segment( fd );
+	if(  bs->rec  ) {
+		// also for id 0, since it ends the previous segment when copied
+		block_special_out( fd, LS_BLOCK_SEGMENT, id );
+	}
+	bs->segment = id;
+	bs->crc = crc32( 0, NULL, 0 );
+	bs->adler = adler32( 0, NULL, 0 );
+	bs->seg_len = 0;
+}
+
+
+static void block_segment_data(file_descriptors_t *fd, const char *p, size_t len)
+{
+	block_stream_t *bs = fd->bs;
+	if(  bs->segment == 0  ) {
+		block_raw_write( fd, p, len );
+		return;
+	}
+	bs->crc = crc32( bs->crc, (const Bytef *)p, (uInt)len );
+	bs->adler = adler32( bs->adler, (const Bytef *)p, (uInt)len );
+	bs->seg_len += len;
+	if(  bs->ref  ) {
+		// kept until the end of the segment
+		if(  bs->seg_buf_len + len > bs->seg_buf_size  ) {
+			bs->seg_buf_size = bs->seg_buf_size ? bs->seg_buf_size * 2 : LS_BUF_SIZE;
+			if(  bs->seg_buf_size < bs->seg_buf_len + len  ) {
+				bs->seg_buf_size = bs->seg_buf_len + len;
+			}
+			bs->seg_buf = REALLOC( bs->seg_buf, char, bs->seg_buf_size );
+		}
+		memcpy( bs->seg_buf + bs->seg_buf_len, p, len );
+		bs->seg_buf_len += len;
+	}
+	else {
+		block_raw_write( fd, p, len );
+	}
+}
+
+
+// returns the next segment start, if it is at the current position
+static bool block_next_start(block_stream_t *bs, segment_start_t &start, uint64 &next_pos)
+{
+	bool now = false;
+	next_pos = (uint64)-1;
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &segment_mutex );
+#endif
+	if(  bs->next_start < bs->starts.get_count()  ) {
+		start = bs->starts[bs->next_start];
+		next_pos = start.pos;
+		if(  start.pos == bs->pos_in  ) {
+			bs->next_start++;
+			now = true;
+		}
+	}
+#if MULTI_THREAD>1
+	pthread_mutex_unlock( &segment_mutex );
+#endif
+	return now;
+}
+
+
+static size_t block_write(file_descriptors_t *fd, const void *buf, size_t len)
+{
+	block_stream_t *bs = fd->bs;
+	if(  bs->ref == NULL  &&  bs->rec == NULL  ) {
+		block_raw_write( fd, (const char *)buf, len );
+		return len;
+	}
+	const char *p = (const char *)buf;
+	size_t left = len;
+	while(  left > 0  ) {
+		segment_start_t start;
+		uint64 next_pos;
+		if(  block_next_start( bs, start, next_pos )  ) {
+			block_start_segment( fd, start.id );
+			continue;
+		}
+		// up to the next segment start
+		const uint64 to_start = next_pos - bs->pos_in;
+		const size_t n = left < to_start ? left : (size_t)to_start;
+		block_segment_data( fd, p, n );
+		bs->pos_in += n;
+		p += n;
+		left -= n;
+	}
+	return len;
+}
+
+
+// writes the last blocks and the end block
+static void block_finish(file_descriptors_t *fd)
+{
+	block_stream_t *bs = fd->bs;
+	if(  bs->ref  ||  bs->rec  ) {
+		segment_start_t start;
+		uint64 next_pos;
+		while(  block_next_start( bs, start, next_pos )  ) {
+			block_start_segment( fd, start.id );
+		}
+		block_end_segment( fd );
+	}
+	block_special_out( fd, 0, 0 );
+}
+
+
+// opens the base file of a file with references
+static bool block_open_base(file_descriptors_t *fd, uint32 name_len)
+{
+	block_stream_t *bs = fd->bs;
+	uint32 id;
+	char name[1024];
+	if(  bs->base_fd  ||  name_len >= lengthof(name)  ||  !block_in( fd, &id, sizeof(id) )  ||  !block_in( fd, name, name_len )  ) {
+		return false;
+	}
+	name[name_len] = 0;
+	id = endian( id );
+
+	// the base is in the same folder
+	std::string path = bs->filename;
+	const size_t sep = path.find_last_of( "/\\" );
+	path = (sep == std::string::npos ? std::string() : path.substr( 0, sep + 1 )) + name;
+
+	FILE *fp = fopen( path.c_str(), "rb" );
+	if(  fp == NULL  ) {
+		dbg->error( "loadsave_t::rd_open()", "cannot open base savegame %s", path.c_str() );
+		return false;
+	}
+	bs->base_fd = new file_descriptors_t();
+	bs->base_fd->fp = fp;
+	char magic[4];
+	uint32 block_size, packed_len, raw_len;
+	if(  fread( magic, 4, 1, fp ) != 1  ||  memcmp( magic, LS_BLOCK_MAGIC, 4 ) != 0
+	     ||  fread( &block_size, sizeof(block_size), 1, fp ) != 1  ||  endian( block_size ) != bs->block_size
+	     ||  !block_header_in( bs->base_fd, packed_len, raw_len )  ||  packed_len != LS_BLOCK_ID  ||  raw_len != id  ) {
+		dbg->error( "loadsave_t::rd_open()", "base savegame %s does not match", path.c_str() );
+		return false;
+	}
+	return true;
+}
+
+
+bool loadsave_t::get_base_name(const char *filename, std::string &base_name)
+{
+	FILE *fp = fopen( filename, "rb" );
+	if(  fp == NULL  ) {
+		return false;
+	}
+	bool found = false;
+	char magic[4];
+	uint32 block_size;
+	if(  fread( magic, 4, 1, fp ) == 1  &&  memcmp( magic, LS_BLOCK_MAGIC, 4 ) == 0  &&  fread( &block_size, sizeof(block_size), 1, fp ) == 1  ) {
+		// the reference follows the id of the file, if any
+		uint32 header[2];
+		while(  !found  &&  fread( header, sizeof(header), 1, fp ) == 1  ) {
+			const uint32 packed_len = endian( header[0] );
+			const uint32 name_len = endian( header[1] );
+			if(  packed_len == LS_BLOCK_BASE  ) {
+				uint32 id;
+				char name[1024];
+				if(  name_len > 0  &&  name_len < lengthof(name)  &&  fread( &id, sizeof(id), 1, fp ) == 1  &&  fread( name, name_len, 1, fp ) == 1  ) {
+					name[name_len] = 0;
+					base_name = name;
+					found = true;
+				}
+				break;
+			}
+			if(  packed_len != LS_BLOCK_ID  ) {
+				break;
+			}
+		}
+	}
+	fclose( fp );
+	return found;
+}
+
+
+// positions the base file after the start of segment id
+static bool block_seek_base(block_stream_t *bs, uint32 id)
+{
+	file_descriptors_t *base = bs->base_fd;
+	if(  base == NULL  ) {
+		return false;
+	}
+	while(  bs->base_segment != id  ) {
+		uint32 packed_len, raw_len;
+		if(  bs->base_end  ||  !block_header_in( base, packed_len, raw_len )  ||  packed_len == 0  ) {
+			bs->base_end = true;
+			return false;
+		}
+		if(  packed_len == LS_BLOCK_SEGMENT  ) {
+			bs->base_segment = raw_len;
+		}
+		else if(  packed_len < LS_BLOCK_SPECIAL  &&  fseek( base->fp, (long)packed_len, SEEK_CUR ) != 0  ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+// reads and unpacks the next blocks
+static void block_fill(file_descriptors_t *fd)
+{
+	block_stream_t *bs = fd->bs;
+	bs->count = 0;
+	bs->curr = 0;
+	bs->pos = 0;
+	while(  !bs->eof  &&  bs->count < LS_BLOCKS  ) {
+		ls_block_t &b = bs->block[bs->count];
+		// the blocks of a referenced segment come from the base
+		file_descriptors_t *src = bs->copying ? bs->base_fd : fd;
+		uint32 packed_len, raw_len;
+		if(  !block_header_in( src, packed_len, raw_len )  ) {
+			bs->eof = bs->error = true;
+			break;
+		}
+		if(  bs->copying  ) {
+			if(  packed_len == 0  ||  packed_len == LS_BLOCK_SEGMENT  ) {
+				// the segment ends here
+				bs->copying = false;
+				bs->base_end = packed_len == 0;
+				bs->base_segment = raw_len;
+				continue;
+			}
+		}
+		else if(  packed_len == 0  ) {
+			bs->eof = true;
+			break;
+		}
+		else if(  packed_len == LS_BLOCK_SEGMENT  ||  packed_len == LS_BLOCK_ID  ) {
+			// only needed when this is a base
+			continue;
+		}
+		else if(  packed_len == LS_BLOCK_BASE  ) {
+			if(  !block_open_base( fd, raw_len )  ) {
+				bs->eof = bs->error = true;
+				break;
+			}
+			continue;
+		}
+		else if(  packed_len == LS_BLOCK_REFERENCE  ) {
+			if(  !block_seek_base( bs, raw_len )  ) {
+				bs->eof = bs->error = true;
+				break;
+			}
+			bs->copying = true;
+			continue;
+		}
+		if(  packed_len > bs->packed_size  ||  raw_len > bs->block_size  ||  !block_in( src, b.packed, packed_len )  ) {
+			bs->eof = bs->error = true;
+			break;
+		}
+		b.packed_len = packed_len;
+		b.raw_len = raw_len;
+		bs->count++;
+	}
+	if(  bs->count > 0  ) {
+		block_run( bs, false );
+		for(  int i=0;  i<bs->count;  i++  ) {
+			if(  !bs->block[i].ok  ) {
+				bs->count = i;
+				bs->eof = bs->error = true;
+				break;
+			}
+		}
+	}
+	if(  bs->error  ) {
+		dbg->error( "loadsave_t::read()", "broken or truncated block" );
+	}
+}
+
+
+static size_t block_read(file_descriptors_t *fd, void *buf, size_t len)
+{
+	block_stream_t *bs = fd->bs;
+	char *p = (char *)buf;
+	size_t done = 0;
+	while(  done < len  ) {
+		if(  bs->curr >= bs->count  ) {
+			if(  bs->eof  ) {
+				break;
+			}
+			block_fill( fd );
+			continue;
+		}
+		ls_block_t &b = bs->block[bs->curr];
+		const size_t avail = b.raw_len - bs->pos;
+		const uint32 n = (uint32)(len - done < avail ? len - done : avail);
+		memcpy( p + done, b.raw + bs->pos, n );
+		done += n;
+		bs->pos += n;
+		if(  bs->pos == b.raw_len  ) {
+			bs->curr++;
+			bs->pos = 0;
+		}
+	}
+	return done;
+}
+
+
+static bool block_is_eof(const block_stream_t *bs)
+{
+	return bs->curr >= bs->count  &&  bs->eof;
+}
+
+
+bool memory_file_t::write_file(const char *filename) const
+{
+	FILE *fp = fopen( filename, "wb" );
+	if(  fp == NULL  ) {
+		return false;
+	}
+	const bool ok = fwrite( data, 1, len, fp ) == len;
+	return fclose( fp ) == 0  &&  ok;
+}
+
+
 loadsave_t::mode_t loadsave_t::save_mode = bzip2;	// default to use for saving
-loadsave_t::mode_t loadsave_t::autosave_mode = zipped;	// default to use for autosaving
+loadsave_t::mode_t loadsave_t::autosave_mode = zipped_blocks;	// default to use for autosaving
 
 loadsave_t::loadsave_t() : filename()
 {
 	mode = 0;
 	saving = false;
 	buffered = false;
+	stream_pos = 0;
+	seg_base = NULL;
+	seg_written = NULL;
 	fd = new file_descriptors_t();
 }
 
@@ -169,9 +815,15 @@ bool loadsave_t::rd_open(const char *filename)
 		// most likely not existing
 		return false;
 	}
-	// now check for BZ2 format
+	// now check for BZ2 or block format
 	char buf[512];
-	if(  fread( buf, 1, 512, fd->fp )==512  ) {
+	const size_t n = fread( buf, 1, 512, fd->fp );
+	if(  n>=8  &&  memcmp( buf, LS_BLOCK_MAGIC, 4 )==0  ) {
+		mode = zipped_blocks;
+		fseek(fd->fp,4,SEEK_SET);
+		return rd_open_blocks( filename );
+	}
+	if(  n==512  ) {
 		if(  buf[0]=='B'  &&  buf[1]=='Z'  ) {
 			mode = bzip2;
 		}
@@ -210,6 +862,79 @@ bool loadsave_t::rd_open(const char *filename)
 		}
 		gzgets(fd->gzfp, buf, 512);
 	}
+	return rd_open_header( buf, filename );
+}
+
+
+bool loadsave_t::rd_open(const memory_file_t *mem)
+{
+	close();
+
+	version = 0;
+	mode = zipped_blocks;
+	experimental_version = 0;
+	if(  mem->len<8  ||  memcmp( mem->data, LS_BLOCK_MAGIC, 4 )!=0  ) {
+		return false;
+	}
+	fd->bs = block_open( LS_BLOCK_SIZE );
+	fd->bs->in_data = mem->data;
+	fd->bs->in_len = mem->len;
+	fd->bs->in_pos = 4;
+	return rd_open_blocks( "(memory)" );
+}
+
+
+// after the magic: reads the block size and the first line
+bool loadsave_t::rd_open_blocks(const char *filename)
+{
+	uint32 block_size;
+	if(  fd->bs  ) {
+		block_in( fd, &block_size, sizeof(block_size) );
+	}
+	else if(  fread( &block_size, sizeof(block_size), 1, fd->fp )!=1  ) {
+		close();
+		return false;
+	}
+	block_size = endian( block_size );
+	if(  block_size==0  ||  block_size>LS_BLOCK_MAX_SIZE  ) {
+		close();
+		return false;
+	}
+	if(  fd->bs  &&  fd->bs->block_size!=block_size  ) {
+		// memory file with another block size
+		block_stream_t *bs = block_open( block_size );
+		bs->in_data = fd->bs->in_data;
+		bs->in_len = fd->bs->in_len;
+		bs->in_pos = fd->bs->in_pos;
+		block_close( fd->bs );
+		fd->bs = bs;
+	}
+	else if(  fd->bs==NULL  ) {
+		fd->bs = block_open( block_size );
+	}
+	fd->bs->filename = filename;
+	saving = false;
+
+	// first line, like gzgets()
+	char buf[512];
+	int i = 0;
+	while(  i < 511  ) {
+		const int c = lsgetc();
+		if(  c < 0  ) {
+			break;
+		}
+		buf[i++] = c;
+		if(  c == '\n'  ) {
+			break;
+		}
+	}
+	buf[i] = 0;
+	return rd_open_header( buf, filename );
+}
+
+
+bool loadsave_t::rd_open_header(char *buf, const char *filename)
+{
 	saving = false;
 
 	if (strstart(buf, SAVEGAME_PREFIX)) {
@@ -296,6 +1021,12 @@ bool loadsave_t::wr_open(const char *filename, mode_t m, const char *pak_extensi
 		// no compression
 		fd->fp = fopen(filename, "wb");
 	}
+	else if(  is_zipped_blocks()  ) {
+		fd->fp = fopen(filename, "wb");
+		if(  fd->fp  ) {
+			wr_open_blocks( seg_base, seg_written );
+		}
+	}
 	else if(  is_bzip2()  ) {
 		// XML or bzip ...
 		fd->fp = fopen(filename, "wb");
@@ -315,10 +1046,79 @@ bool loadsave_t::wr_open(const char *filename, mode_t m, const char *pak_extensi
 		fd->fp = fopen(filename, "wb");
 	}
 
+	// the segments are only for this file
+	seg_base = NULL;
+	seg_written = NULL;
+
 	// check whether we could open the file
 	if(  is_zipped()  ?  fd->gzfp == NULL  :  fd->fp == NULL  ) {
 		return false;
 	}
+	return wr_open_header( pak_extension, savegame_version, savegame_version_ex, filename );
+}
+
+
+bool loadsave_t::wr_open(memory_file_t *mem, const char *pak_extension, const char *savegame_version, const char *savegame_version_ex)
+{
+	mode = zipped_blocks;
+	close();
+
+	mem->len = 0;
+	fd->mem = mem;
+	wr_open_blocks( NULL, NULL );
+	return wr_open_header( pak_extension, savegame_version, savegame_version_ex, "(memory)" );
+}
+
+
+// writes the magic and the block size
+void loadsave_t::wr_open_blocks(const savegame_segments_t *base, savegame_segments_t *written)
+{
+	fd->bs = block_open( LS_BLOCK_SIZE );
+	const uint32 block_size = endian( (uint32)LS_BLOCK_SIZE );
+	block_out( fd, LS_BLOCK_MAGIC, 4 );
+	block_out( fd, &block_size, sizeof(block_size) );
+	stream_pos = 0;
+
+	if(  written  ) {
+		// any number different from the last file will do
+		static uint32 last_id = 0;
+		uint32 id = (uint32)time(NULL);
+		if(  id <= last_id  ) {
+			id = last_id + 1;
+		}
+		last_id = id;
+		written->segments.clear();
+		written->file_id = id;
+		block_header_out( fd, LS_BLOCK_ID, id );
+		fd->bs->rec = written;
+	}
+	if(  base  &&  base->file_id != 0  ) {
+		const uint32 id = endian( base->file_id );
+		block_header_out( fd, LS_BLOCK_BASE, (uint32)base->filename.length() );
+		block_out( fd, &id, sizeof(id) );
+		block_out( fd, base->filename.c_str(), base->filename.length() );
+		fd->bs->ref = base;
+	}
+}
+
+
+void loadsave_t::start_segment(uint32 id)
+{
+	if(  saving  &&  fd->bs  &&  (fd->bs->ref  ||  fd->bs->rec)  ) {
+		// takes effect when the data written so far has reached the blocks
+#if MULTI_THREAD>1
+		pthread_mutex_lock( &segment_mutex );
+#endif
+		fd->bs->starts.append( segment_start_t( stream_pos, id ) );
+#if MULTI_THREAD>1
+		pthread_mutex_unlock( &segment_mutex );
+#endif
+	}
+}
+
+
+bool loadsave_t::wr_open_header(const char *pak_extension, const char *savegame_version, const char *savegame_version_ex, const char *filename)
+{
 	saving = true;
 
 	// get the right extension
@@ -384,7 +1184,7 @@ const char *loadsave_t::close()
 	const char *success = NULL;
 
 	if(  is_xml()  &&  saving  &&  (!is_bzip2()  ||  fd->bse==BZ_OK)
-	     &&  (is_zipped()  ?  fd->gzfp != NULL :  fd->fp != NULL) ) {
+	     &&  (is_zipped()  ?  fd->gzfp != NULL :  fd->fp != NULL  ||  fd->mem != NULL) ) {
 		// only write when close and no error occurred
 		const char *end = "\n</Simutrans>\n";
 		write( end, strlen(end) );
@@ -398,6 +1198,17 @@ const char *loadsave_t::close()
 		gzclose(fd->gzfp);
 		fd->gzfp = NULL;
 	}
+	if(  fd->bs  ) {
+		if(  saving  ) {
+			block_finish( fd );
+		}
+		if(  fd->bs->error  ) {
+			success = saving ? "cannot write block" : "broken block";
+		}
+		block_close( fd->bs );
+		fd->bs = NULL;
+		fd->mem = NULL;
+	}
 	if(  is_bzip2()  &&  fd->fp ) {
 		if(   saving  ) {
 			/* BZLIB seems to eat the last byte, if it is at odd position
@@ -457,14 +1268,14 @@ bool loadsave_t::is_eof()
 #if MULTI_THREAD>1
 			pthread_mutex_lock(&loadsave_mutex);
 #endif
-			r = buf_pos[0]>=buf_len[0]  &&  buf_pos[1]>=buf_len[1]  &&  gzeof(fd->gzfp)!=0;
+			r = buf_pos[0]>=buf_len[0]  &&  buf_pos[1]>=buf_len[1]  &&  (fd->bs ? block_is_eof(fd->bs) : gzeof(fd->gzfp)!=0);
 #if MULTI_THREAD>1
 			pthread_mutex_unlock(&loadsave_mutex);
 #endif
 			return r;
 		}
 		else {
-			return gzeof(fd->gzfp)!=0;
+			return fd->bs ? block_is_eof(fd->bs) : gzeof(fd->gzfp)!=0;
 		}
 	}
 }
@@ -489,6 +1300,7 @@ int loadsave_t::lsgetc()
 
 size_t loadsave_t::write(const void *buf, size_t len)
 {
+	stream_pos += len;
 	if(  buffered  ) {
 		if(  buf_pos[curr_buff]+len<=LS_BUF_SIZE  ) {
 			// room in the buffer, copy it all
@@ -523,7 +1335,10 @@ size_t loadsave_t::write(const void *buf, size_t len)
 		}
 	}
 	else {
-		if(  is_zipped()  ) {
+		if(  fd->bs  ) {
+			return block_write( fd, buf, len );
+		}
+		else if(  is_zipped()  ) {
 			return gzwrite(fd->gzfp, const_cast<void *>(buf), len);
 		}
 		else if(  is_bzip2()  ) {
@@ -541,7 +1356,10 @@ size_t loadsave_t::write(const void *buf, size_t len)
 void loadsave_t::flush_buffer(int buf_num)
 {
 	int bse = fd->bse;
-	if(  is_zipped()  ) {
+	if(  fd->bs  ) {
+		block_write( fd, ls_buf[buf_num], buf_pos[buf_num] );
+	}
+	else if(  is_zipped()  ) {
 		gzwrite(fd->gzfp, ls_buf[buf_num], buf_pos[buf_num]);
 	}
 	else if(  is_bzip2()  ) {
@@ -616,6 +1434,9 @@ size_t loadsave_t::read(void *buf, size_t len)
 			}
 			return fd->bse==BZ_OK ? len : 0;
 		}
+		else if(  fd->bs  ) {
+			return block_read( fd, buf, len );
+		}
 		else {
 			return gzread(fd->gzfp, buf, len);
 		}
@@ -636,6 +1457,9 @@ int loadsave_t::fill_buffer(int buf_num)
 			r = 0;
 		}
 	}
+	else if(  fd->bs  ) {
+		r = (int)block_read( fd, ls_buf[buf_num], LS_BUF_SIZE );
+	}
 	else {
 		r = gzread(fd->gzfp, ls_buf[buf_num], LS_BUF_SIZE);
 	}
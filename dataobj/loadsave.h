@@ -12,13 +12,62 @@
 #define NOMINMAX 1
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string>
 
 #include "../simtypes.h"
+#include "../tpl/vector_tpl.h"
 
 class plainstring;
 struct file_descriptors_t;
 
+
+/**
+ * A savegame kept in memory instead of a file, e.g. for the transfer to
+ * network clients. The data has the zipped_blocks format, i.e. it is
+ * identical to a file saved with loadsave_t::zipped_blocks.
+ */
+class memory_file_t {
+public:
+	char *data;
+	size_t len;	// used bytes
+	size_t size;	// allocated bytes
+
+	memory_file_t() : data(NULL), len(0), size(0) {}
+	~memory_file_t() { free(data); }
+
+	// writes the data unchanged to a file, which can be loaded normally
+	bool write_file(const char *filename) const;
+
+private:
+	memory_file_t(const memory_file_t&);
+	memory_file_t& operator=(const memory_file_t&);
+};
+
+/**
+ * Checksums of the segments of a zipped_blocks savegame (see
+ * loadsave_t::start_segment()). A later savegame can refer to the
+ * segments of this base file instead of repeating them.
+ */
+class savegame_segments_t {
+public:
+	struct segment_t {
+		uint64 checksum;
+		uint64 len;
+		segment_t() : checksum(0), len(0) {}
+	};
+
+	uint32 file_id;	// 0 if no file was written
+	std::string filename;	// of the base file, without path; set by the caller
+	vector_tpl<segment_t> segments;	// by segment id
+	uint32 deltas;	// savegames referring to this base, counted by the caller
+
+	savegame_segments_t() : file_id(0), deltas(0) {}
+
+	void clear() { file_id = 0; filename.clear(); segments.clear(); deltas = 0; }
+};
+
+
 /**
  * loadsave_t:
  *
@@ -28,6 +77,8 @@ struct file_descriptors_t;
  * </p>
  * Can now read and write 3 formats: text, binary and zipped
  * Input format is automatically detected.
+ * zipped_blocks splits the data into blocks, which are compressed
+ * by several threads (with MULTI_THREAD>1).
  * Output format has a default, changeable with set_savemode, but can be
  * overwritten in wr_open.
  *
@@ -37,7 +88,7 @@ struct file_descriptors_t;
 
 class loadsave_t {
 public:
-	enum mode_t { text=1, xml=2, binary=0, zipped=4, xml_zipped=6, bzip2=8, xml_bzip2=10 };
+	enum mode_t { text=1, xml=2, binary=0, zipped=4, xml_zipped=6, bzip2=8, xml_bzip2=10, zipped_blocks=16 };
 
 private:
 	int mode;
@@ -50,6 +101,9 @@ private:
 	uint32 version;
 	uint32 experimental_version;
 	int ident;		// only for XML formatting
+	uint64 stream_pos;	// bytes written, for the segments
+	const savegame_segments_t *seg_base;	// until wr_open()
+	savegame_segments_t *seg_written;
 	char pak_extension[256];	// name of the pak folder during savetime
 
 	std::string filename;	// the current name ...
@@ -66,6 +120,12 @@ private:
 
 	void rdwr_xml_number(sint64 &s, const char *typ);
 
+	// the parts of rd_open() and wr_open() after the file was opened
+	bool rd_open_header(char *buf, const char *filename);
+	bool wr_open_header(const char *pak_extension, const char *savegame_version, const char *savegame_version_ex, const char *filename);
+	bool rd_open_blocks(const char *filename);
+	void wr_open_blocks(const savegame_segments_t *base, savegame_segments_t *written);
+
 
 	loadsave_t(const loadsave_t&);
 	loadsave_t& operator=(const loadsave_t&);
@@ -88,8 +148,36 @@ public:
 
 	bool rd_open(const char *filename);
 	bool wr_open(const char *filename, mode_t mode, const char *pak_extension, const char *savegame_version, const char *savegame_version_ex );
+
+	/**
+	 * Like rd_open() and wr_open(), but with a savegame in memory (always zipped_blocks).
+	 * The memory_file_t must exist until close(); when writing, old data is replaced.
+	 */
+	bool rd_open(const memory_file_t *mem);
+	bool wr_open(memory_file_t *mem, const char *pak_extension, const char *savegame_version, const char *savegame_version_ex );
 	const char *close();
 
+	/**
+	 * Only for zipped_blocks and before wr_open(): the data is split into the
+	 * segments started by start_segment(). Their checksums are recorded in
+	 * *written, so that the file can serve as base of later savegames.
+	 * Segments with the same data as in *base are only referred to; such a
+	 * savegame is loaded together with the base file from the same folder.
+	 */
+	void set_segments(const savegame_segments_t *base, savegame_segments_t *written) { seg_base = base; seg_written = written; }
+
+	/**
+	 * Starts a segment at the current position, ending the previous one.
+	 * Id 0 is never referred to (use it for data which changes always).
+	 */
+	void start_segment(uint32 id);
+
+	/**
+	 * Gets the name of the base file of a file saved against a base.
+	 * @return false if the file does not refer to a base
+	 */
+	static bool get_base_name(const char *filename, std::string &base_name);
+
 	static void set_savemode(mode_t mode) { save_mode = mode; }
 	static void set_autosavemode(mode_t mode) { autosave_mode = mode; }
 
@@ -105,6 +193,7 @@ public:
 	bool is_saving() const { return saving; }
 	bool is_zipped() const { return mode&zipped; }
 	bool is_bzip2() const { return mode&bzip2; }
+	bool is_zipped_blocks() const { return mode&zipped_blocks; }
 	bool is_xml() const { return mode&xml; }
 	uint32 get_version() const { return version; }
 	uint32 get_experimental_version() const { return experimental_version; }
@@ -32,6 +32,8 @@ enum {
 	NWC_SCENARIO,
 	NWC_SCENARIO_RULES,
 	NWC_ROUTESEARCH,
+	NWC_WORLD_HASH,
+	NWC_RESYNC,
 	NWC_COUNT
 };
 
@@ -111,6 +113,7 @@ public:
 		SRVC_UNLOCK_COMPANY   = 13,
 		SRVC_REMOVE_COMPANY   = 14,
 		SRVC_LOCK_COMPANY     = 15,
+		SRVC_GET_PROFILE      = 16,
 		SRVC_MAX
 	};
 
@@ -14,9 +14,15 @@
 #include "../simversion.h"
 #include "../simwin.h"
 #include "../simmesg.h"
+#include "../simprofile.h"
 #include "../simsys.h"
 #include "../dataobj/umgebung.h"
 #include "../player/simplay.h"
+#include "../player/finance.h"
+#include "../simhalt.h"
+#include "../path_explorer.h"
+#include "../simfab.h"
+#include "../bauer/warenbauer.h"
 #include "../gui/player_frame_t.h"
 #include "../utils/cbuffer_t.h"
 #include "../utils/csv.h"
@@ -49,6 +55,8 @@ network_command_t* network_command_t::read_from_packet(packet_t *p)
 		case NWC_SCENARIO_RULES:
 		                      nwc = new nwc_scenario_rules_t(); break;
 		case NWC_ROUTESEARCH: nwc = new nwc_routesearch_t(); break;
+		case NWC_WORLD_HASH:  nwc = new nwc_world_hash_t(); break;
+		case NWC_RESYNC:      nwc = new nwc_resync_t(); break;
 		default:
 			dbg->warning("network_command_t::read_from_socket", "received unknown packet id %d", p->get_id());
 	}
@@ -675,7 +683,7 @@ void nwc_sync_t::do_command(karte_t *welt)
 		}
 	}
 	// transfer game, all clients need to sync (save, reload, and pause)
-	// now save and send
+	// the game is saved to and loaded from memory, the disk is much too slow for large maps
 	chdir( umgebung_t::user_dir );
 	if(  !umgebung_t::server  ) {
 		char fn[256];
@@ -684,9 +692,10 @@ void nwc_sync_t::do_command(karte_t *welt)
 		bool old_restore_UI = umgebung_t::restore_UI;
 		umgebung_t::restore_UI = true;
 
-		welt->save( fn, loadsave_t::autosave_mode, SERVER_SAVEGAME_VER_NR, EXPERIMENTAL_VER_NR, false );
+		memory_file_t mem;
+		welt->save( &mem, SERVER_SAVEGAME_VER_NR, EXPERIMENTAL_VER_NR );
 		uint32 old_sync_steps = welt->get_sync_steps();
-		welt->load( fn );
+		welt->load( fn, &mem );
 		umgebung_t::restore_UI = old_restore_UI;
 
 		// pause clients, restore steps
@@ -727,11 +736,12 @@ void nwc_sync_t::do_command(karte_t *welt)
 		sprintf( fn, "server%d-network.sve", umgebung_t::server );
 		bool old_restore_UI = umgebung_t::restore_UI;
 		umgebung_t::restore_UI = true;
-		welt->save( fn, loadsave_t::save_mode, SERVER_SAVEGAME_VER_NR, EXPERIMENTAL_VER_NR, false );
+		memory_file_t mem;
+		welt->save( &mem, SERVER_SAVEGAME_VER_NR, EXPERIMENTAL_VER_NR );
 
 		// ok, now sending game
 		// this sends nwc_game_t
-		const char *err = network_send_file( client_id, fn );
+		const char *err = network_send_file( client_id, &mem );
 		if (err) {
 			dbg->warning("nwc_sync_t::do_command","send game failed with: %s", err);
 		}
@@ -745,8 +755,12 @@ void nwc_sync_t::do_command(karte_t *welt)
 		}
 
 		uint32 old_sync_steps = welt->get_sync_steps();
-		welt->load( fn );
+		welt->load( fn, &mem );
 		umgebung_t::restore_UI = old_restore_UI;
+		// still written to disk (without compressing again) for recovering after a restart
+		if(  !mem.write_file( fn )  ) {
+			dbg->warning("nwc_sync_t::do_command", "could not write %s", fn);
+		}
 
 		// restore steps
 		welt->network_game_set_pause( false, old_sync_steps);
@@ -945,11 +959,36 @@ path_explorer_t::limit_set_t nwc_routesearch_t::calc_min_limits()
 	return result_set;
 }
 
+nwc_check_t::nwc_check_t() : network_world_command_t(NWC_CHECK, 0, 0), server_sync_step(0)
+{
+	for(  uint8 s = 0;  s < world_hash_t::SUBSYSTEM_COUNT;  s++  ) {
+		server_subsystem_hash[s] = 0;
+	}
+}
+
+
+nwc_check_t::nwc_check_t(uint32 sync_steps, uint32 map_counter, const checklist_t &server_checklist_, uint32 server_sync_step_, const world_hash_t &world_hash) :
+	network_world_command_t(NWC_CHECK, sync_steps, map_counter),
+	server_checklist(server_checklist_),
+	server_sync_step(server_sync_step_)
+{
+	const bool hashed = world_hash.get_sync_step() == server_sync_step;
+	for(  uint8 s = 0;  s < world_hash_t::SUBSYSTEM_COUNT;  s++  ) {
+		server_subsystem_hash[s] = hashed ? world_hash.get_subsystem_hash(s) : 0;
+	}
+}
+
+
 void nwc_check_t::rdwr()
 {
 	network_world_command_t::rdwr();
 	server_checklist.rdwr(packet);
 	packet->rdwr_long(server_sync_step);
+	if(  server_checklist.world_hash != 0  ) {
+		for(  uint8 s = 0;  s < world_hash_t::SUBSYSTEM_COUNT;  s++  ) {
+			packet->rdwr_long(server_subsystem_hash[s]);
+		}
+	}
 	if (packet->is_loading()  &&  umgebung_t::server) {
 		// server does not receive nwc_check_t-commands
 		packet->failed();
@@ -957,6 +996,406 @@ void nwc_check_t::rdwr()
 }
 
 
+uint32 nwc_world_hash_t::pending = 0;
+uint32 nwc_world_hash_t::pending_map_counter = 0;
+uint32 nwc_world_hash_t::pending_since = 0;
+uint32 nwc_world_hash_t::requests = 0;
+bool nwc_world_hash_t::resync_possible = false;
+vector_tpl<uint8> nwc_world_hash_t::resync_subsystems;
+vector_tpl<uint32> nwc_world_hash_t::resync_leaves;
+
+// at most this many requests are sent when looking for a difference
+#define MAX_WORLD_HASH_REQUESTS (16)
+
+// at most this many objects are resynced, else the client rejoins
+#define MAX_RESYNC_OBJECTS (32)
+
+// ms to wait for the answers of the server
+#define WORLD_HASH_TIMEOUT (10000)
+
+
+bool nwc_world_hash_t::find_difference(karte_t *welt, const nwc_check_t *nwcheck)
+{
+	const world_hash_t &world_hash = welt->get_world_hash();
+	if(  nwcheck->server_checklist.world_hash == 0  ||  world_hash.get_sync_step() != nwcheck->server_sync_step  ) {
+		return false;
+	}
+	pending = 0;
+	requests = 0;
+	pending_map_counter = welt->get_map_counter();
+	pending_since = dr_time();
+	resync_subsystems.clear();
+	resync_leaves.clear();
+	// only the world hash may differ, a different random seed cannot be repaired
+	checklist_t own = welt->get_checklist_at( nwcheck->server_sync_step );
+	own.world_hash = nwcheck->server_checklist.world_hash;
+	resync_possible = own == nwcheck->server_checklist;
+	for(  uint8 s = 0;  s < world_hash_t::SUBSYSTEM_COUNT;  s++  ) {
+		if(  world_hash.get_subsystem_hash(s) != nwcheck->server_subsystem_hash[s]  ) {
+			dbg->warning("nwc_world_hash_t::find_difference", "%s differ from server at sync_step=%u", world_hash_t::get_subsystem_name(s), world_hash.get_sync_step() );
+			request( welt, s, all_groups );
+		}
+	}
+	return pending > 0;
+}
+
+
+bool nwc_world_hash_t::is_pending(const karte_t *welt)
+{
+	return pending > 0  &&  pending_map_counter == welt->get_map_counter()  &&  !is_timed_out(welt);
+}
+
+
+bool nwc_world_hash_t::is_timed_out(const karte_t *welt)
+{
+	return pending > 0  &&  pending_map_counter == welt->get_map_counter()  &&  (uint32)dr_time() - pending_since > WORLD_HASH_TIMEOUT;
+}
+
+
+void nwc_world_hash_t::request(karte_t *welt, uint8 subsystem, uint32 group)
+{
+	pending++;
+	requests++;
+	network_send_server( new nwc_world_hash_t( welt->get_world_hash().get_sync_step(), welt->get_map_counter(), subsystem, group ) );
+}
+
+
+bool nwc_world_hash_t::execute(karte_t *welt)
+{
+	const world_hash_t &world_hash = welt->get_world_hash();
+	if(  umgebung_t::server  ) {
+		// send the hashes of the next level back
+		nwc_world_hash_t nwc(sync_step, map_counter, subsystem, group);
+		if(  map_counter == welt->get_map_counter()  &&  sync_step == world_hash.get_sync_step()  &&  subsystem < world_hash_t::SUBSYSTEM_COUNT  ) {
+			nwc.available = true;
+			if(  group == all_groups  ) {
+				nwc.hashes = world_hash.get_groups(subsystem);
+			}
+			else {
+				world_hash.get_group_leaves( subsystem, group, nwc.hashes );
+			}
+		}
+		if(  !nwc.send( get_sender() )  ) {
+			dbg->warning("nwc_world_hash_t::execute", "send of NWC_WORLD_HASH failed");
+		}
+	}
+	else if(  is_pending(welt)  ) {
+		pending--;
+		compare(welt);
+		if(  pending == 0  ) {
+			if(  resync_possible  &&  !resync_leaves.empty()  ) {
+				// ask the server for its state of these objects
+				dbg->warning("nwc_world_hash_t::execute", "requesting resync of %u objects", resync_leaves.get_count() );
+				nwc_resync_t *nwc = new nwc_resync_t( welt->get_sync_steps(), welt->get_map_counter() );
+				nwc->subsystems = resync_subsystems;
+				nwc->leaves = resync_leaves;
+				network_send_server( nwc );
+			}
+			else {
+				dbg->warning("nwc_world_hash_t::execute", "disconnecting due to checklist mismatch");
+				welt->network_disconnect();
+			}
+		}
+	}
+	return true;
+}
+
+
+void nwc_world_hash_t::compare(karte_t *welt)
+{
+	const world_hash_t &world_hash = welt->get_world_hash();
+	if(  !available  ||  sync_step != world_hash.get_sync_step()  ) {
+		dbg->warning("nwc_world_hash_t::compare", "hashes of %s at sync_step=%u not available any more", world_hash_t::get_subsystem_name(subsystem), sync_step );
+		resync_possible = false;
+		return;
+	}
+	vector_tpl<uint32> own;
+	if(  group == all_groups  ) {
+		own = world_hash.get_groups(subsystem);
+	}
+	else {
+		world_hash.get_group_leaves( subsystem, group, own );
+	}
+	const uint32 count = max( own.get_count(), hashes.get_count() );
+	for(  uint32 i = 0;  i < count;  i++  ) {
+		if(  i < own.get_count()  &&  i < hashes.get_count()  &&  own[i] == hashes[i]  ) {
+			continue;
+		}
+		if(  group == all_groups  ) {
+			if(  requests < MAX_WORLD_HASH_REQUESTS  ) {
+				request( welt, subsystem, i );
+			}
+			else {
+				// not all differences are known
+				resync_possible = false;
+			}
+		}
+		else {
+			const uint32 leaf = group * world_hash_t::group_size + i;
+			cbuffer_t buf;
+			world_hash.describe_leaf( welt, subsystem, leaf, buf );
+			dbg->warning("nwc_world_hash_t::compare", "differs from server at sync_step=%u: %s", sync_step, (const char *)buf );
+			// halts are asked for by their id, since their list may have changed since the hashing
+			const bool known = subsystem != world_hash_t::HALTS  ||  world_hash.get_halt(leaf).is_bound();
+			if(  nwc_resync_t::can_resync(subsystem)  &&  known  &&  i < hashes.get_count()  &&  resync_leaves.get_count() < MAX_RESYNC_OBJECTS  ) {
+				resync_subsystems.append( subsystem );
+				resync_leaves.append( subsystem == world_hash_t::HALTS ? world_hash.get_halt(leaf).get_id() : leaf );
+			}
+			else {
+				resync_possible = false;
+			}
+		}
+	}
+}
+
+
+void nwc_world_hash_t::rdwr()
+{
+	network_command_t::rdwr();
+	packet->rdwr_long(sync_step);
+	packet->rdwr_long(map_counter);
+	packet->rdwr_byte(subsystem);
+	packet->rdwr_long(group);
+	packet->rdwr_bool(available);
+	uint32 count = hashes.get_count();
+	packet->rdwr_long(count);
+	if(  packet->is_loading()  ) {
+		hashes.clear();
+		if(  count > world_hash_t::group_size * 4  ) {
+			packet->failed();
+			return;
+		}
+		for(  uint32 i = 0;  i < count;  i++  ) {
+			uint32 hash = 0;
+			packet->rdwr_long(hash);
+			hashes.append(hash);
+		}
+	}
+	else {
+		for(  uint32 i = 0;  i < count;  i++  ) {
+			packet->rdwr_long(hashes[i]);
+		}
+	}
+}
+
+
+// the saved objects must fit into one packet
+#define MAX_RESYNC_DATA (MAX_PACKET_LEN - 512)
+
+// end of the objects in the data of nwc_resync_t
+#define RESYNC_END (255)
+
+vector_tpl<uint32> nwc_resync_t::last_resync;
+
+
+bool nwc_resync_t::can_resync(uint8 subsystem)
+{
+	return subsystem == world_hash_t::HALTS  ||  subsystem == world_hash_t::FACTORIES  ||  subsystem == world_hash_t::PLAYERS;
+}
+
+
+void nwc_resync_t::rdwr()
+{
+	network_world_command_t::rdwr();
+	uint16 count = subsystems.get_count();
+	packet->rdwr_short(count);
+	for(  uint16 i = 0;  i < count;  i++  ) {
+		uint8 subsystem = packet->is_saving() ? subsystems[i] : 0;
+		uint32 leaf = packet->is_saving() ? leaves[i] : 0;
+		packet->rdwr_byte(subsystem);
+		packet->rdwr_long(leaf);
+		if(  packet->is_loading()  ) {
+			subsystems.append( subsystem );
+			leaves.append( leaf );
+		}
+	}
+	uint32 len = (uint32)data.len;
+	packet->rdwr_long(len);
+	if(  packet->is_loading()  ) {
+		if(  len > MAX_RESYNC_DATA  ) {
+			packet->failed();
+			return;
+		}
+		free( data.data );
+		data.data = (char *)malloc( len );
+		data.size = data.len = len;
+	}
+	for(  uint32 i = 0;  i < len;  i++  ) {
+		packet->rdwr_byte( ((uint8 *)data.data)[i] );
+	}
+}
+
+
+bool nwc_resync_t::execute(karte_t *welt)
+{
+	if(  !umgebung_t::server  ) {
+		// the answer: put it into the command queue
+		return network_world_command_t::execute(welt);
+	}
+
+	const uint32 client_id = socket_list_t::get_client_id( get_sender() );
+	if(  !is_valid_request( welt, client_id )  ) {
+		return true;
+	}
+	// the objects as they are now, i.e. after the current sync step
+	nwc_resync_t nwc( welt->get_sync_steps(), welt->get_map_counter() );
+	if(  !save_objects( welt, &nwc )  ) {
+		return true;
+	}
+	if(  nwc.data.len > MAX_RESYNC_DATA  ) {
+		// too large, the client has to rejoin
+		dbg->warning("nwc_resync_t::execute", "%u bytes are too much, disconnecting client %u", (uint32)nwc.data.len, client_id );
+		socket_list_t::remove_client( get_sender() );
+		return true;
+	}
+	while(  last_resync.get_count() <= client_id  ) {
+		last_resync.append( 0xFFFFFFFFu );
+	}
+	last_resync[client_id] = welt->get_sync_steps();
+	if(  !nwc.send( get_sender() )  ) {
+		dbg->warning("nwc_resync_t::execute", "send of NWC_RESYNC failed");
+	}
+	return true;
+}
+
+
+bool nwc_resync_t::is_valid_request(karte_t *welt, uint32 client_id) const
+{
+	if(  !socket_list_t::is_valid_client_id( client_id )  ||  !socket_list_t::get_client( client_id ).is_active()  ) {
+		dbg->warning("nwc_resync_t::is_valid_request", "not from an active client" );
+		return false;
+	}
+	if(  get_map_counter() != welt->get_map_counter()  ) {
+		dbg->warning("nwc_resync_t::is_valid_request", "request of client %u from another world", client_id );
+		return false;
+	}
+	if(  client_id < last_resync.get_count()  &&  last_resync[client_id] != 0xFFFFFFFFu  &&  welt->get_sync_steps() - last_resync[client_id] < world_hash_t::interval  ) {
+		dbg->warning("nwc_resync_t::is_valid_request", "client %u asks again too soon", client_id );
+		return false;
+	}
+	// only what a client finds with nwc_world_hash_t
+	if(  subsystems.empty()  ||  subsystems.get_count() > MAX_RESYNC_OBJECTS  ||  subsystems.get_count() != leaves.get_count()  ) {
+		dbg->warning("nwc_resync_t::is_valid_request", "client %u asks for %u objects", client_id, subsystems.get_count() );
+		return false;
+	}
+	for(  uint32 i = 0;  i < subsystems.get_count();  i++  ) {
+		if(  !can_resync( subsystems[i] )  ) {
+			dbg->warning("nwc_resync_t::is_valid_request", "client %u asks for %s", client_id, world_hash_t::get_subsystem_name( subsystems[i] ) );
+			return false;
+		}
+	}
+	return true;
+}
+
+
+// saves the requested objects of the server, which are then replaced on the client
+bool nwc_resync_t::save_objects(karte_t *welt, nwc_resync_t *answer) const
+{
+	loadsave_t file;
+	if(  !file.wr_open( &answer->data, umgebung_t::objfilename.c_str(), SERVER_SAVEGAME_VER_NR, EXPERIMENTAL_VER_NR )  ) {
+		return false;
+	}
+	for(  uint32 i = 0;  i < subsystems.get_count();  i++  ) {
+		uint8 subsystem = subsystems[i];
+		const uint32 leaf = leaves[i];
+		if(  subsystem == world_hash_t::HALTS  ) {
+			// the leaf is the id of the halt
+			halthandle_t halt;
+			if(  leaf < halthandle_t::get_size()  ) {
+				halt.set_id( (uint16)leaf );
+			}
+			if(  !halt.is_bound()  ) {
+				dbg->warning("nwc_resync_t::save_objects", "halt %u missing", leaf );
+				file.close();
+				return false;
+			}
+			uint16 id = halt.get_id();
+			koord pos = halt->get_basis_pos();
+			file.rdwr_byte(subsystem);
+			file.rdwr_short(id);
+			pos.rdwr(&file);
+			halt->rdwr_goods( &file, warenbauer_t::get_max_catg_index() );
+		}
+		else if(  subsystem == world_hash_t::FACTORIES  &&  leaf < welt->get_fab_list().get_count()  ) {
+			fabrik_t *fab = welt->get_fab_list()[leaf];
+			koord3d pos = fab->get_pos();
+			file.rdwr_byte(subsystem);
+			pos.rdwr(&file);
+			fab->rdwr_goods(&file);
+		}
+		else if(  subsystem == world_hash_t::PLAYERS  &&  leaf < MAX_PLAYER_COUNT  &&  welt->get_spieler(leaf)  ) {
+			uint8 player_nr = leaf;
+			file.rdwr_byte(subsystem);
+			file.rdwr_byte(player_nr);
+			welt->get_spieler(player_nr)->get_finance()->rdwr(&file);
+		}
+	}
+	uint8 end = RESYNC_END;
+	file.rdwr_byte(end);
+	file.close();
+	return true;
+}
+
+
+void nwc_resync_t::do_command(karte_t *welt)
+{
+	loadsave_t file;
+	if(  !file.rd_open(&data)  ) {
+		dbg->error("nwc_resync_t::do_command", "cannot read the objects");
+		return;
+	}
+	uint8 subsystem = RESYNC_END;
+	file.rdwr_byte(subsystem);
+	while(  subsystem != RESYNC_END  ) {
+		if(  subsystem == world_hash_t::HALTS  ) {
+			uint16 id = 0;
+			koord pos;
+			file.rdwr_short(id);
+			pos.rdwr(&file);
+			halthandle_t halt;
+			if(  id < halthandle_t::get_size()  ) {
+				halt.set_id(id);
+			}
+			if(  !halt.is_bound()  ||  halt->get_basis_pos() != pos  ) {
+				// another halt here, it cannot be repaired
+				dbg->warning("nwc_resync_t::do_command", "halt %u at %s missing, disconnecting", id, pos.get_str() );
+				file.close();
+				welt->network_disconnect();
+				return;
+			}
+			halt->remove_all_goods();
+			halt->rdwr_goods( &file, warenbauer_t::get_max_catg_index() );
+		}
+		else if(  subsystem == world_hash_t::FACTORIES  ) {
+			koord3d pos;
+			pos.rdwr(&file);
+			fabrik_t *fab = fabrik_t::get_fab( welt, pos.get_2d() );
+			if(  fab == NULL  ) {
+				dbg->warning("nwc_resync_t::do_command", "factory at %s missing", pos.get_str() );
+				break;
+			}
+			fab->rdwr_goods(&file);
+		}
+		else if(  subsystem == world_hash_t::PLAYERS  ) {
+			uint8 player_nr = 0;
+			file.rdwr_byte(player_nr);
+			spieler_t *sp = welt->get_spieler(player_nr);
+			if(  sp == NULL  ) {
+				dbg->warning("nwc_resync_t::do_command", "player %u missing", player_nr );
+				break;
+			}
+			sp->get_finance()->rdwr(&file);
+		}
+		else {
+			break;
+		}
+		dbg->message("nwc_resync_t::do_command", "resynced %s at sync_step=%u", world_hash_t::get_subsystem_name(subsystem), welt->get_sync_steps() );
+		file.rdwr_byte(subsystem);
+	}
+	file.close();
+}
+
+
 void network_broadcast_world_command_t::rdwr()
 {
 	network_world_command_t::rdwr();
@@ -1635,6 +2074,19 @@ bool nwc_service_t::execute(karte_t *welt)
 			break;
 		}
 
+		case SRVC_GET_PROFILE: {
+			cbuffer_t buf;
+			profiler::print(buf);
+			buf.append("\n");
+			path_explorer_t::print_memory_usage(buf);
+
+			nwc_service_t nws;
+			nws.flag = flag;
+			nws.text = strdup(buf);
+			nws.send(packet->get_sender());
+			break;
+		}
+
 		default: ;
 	}
 	return true; // to delete
@@ -2,6 +2,7 @@
 #define _NETWORK_CMD_INGAME_H_
 
 #include "network_cmd.h"
+#include "world_hash.h"
 #include "../simworld.h"
 #include "../tpl/slist_tpl.h"
 #include "../utils/plainstring.h"
@@ -258,22 +259,79 @@ private:
  * nwc_check_t
  * @from-server:
  *		@data checklist random seed and quickstone next check entries at previous sync_step
+ *		@data hashes of the subsystems, if the world was hashed at this sync_step
  *		clients: check random seed, if check fails disconnect.
  *		the check is done in karte_t::interactive
  */
 class nwc_check_t : public network_world_command_t {
 public:
-	nwc_check_t() : network_world_command_t(NWC_CHECK, 0, 0), server_sync_step(0) { }
-	nwc_check_t(uint32 sync_steps, uint32 map_counter, const checklist_t &server_checklist_, uint32 server_sync_step_) : network_world_command_t(NWC_CHECK, sync_steps, map_counter), server_checklist(server_checklist_), server_sync_step(server_sync_step_) {};
+	nwc_check_t();
+	nwc_check_t(uint32 sync_steps, uint32 map_counter, const checklist_t &server_checklist_, uint32 server_sync_step_, const world_hash_t &world_hash);
 	virtual void rdwr();
 	virtual void do_command(karte_t*) { }
 	virtual const char* get_name() { return "nwc_check_t"; }
 	checklist_t server_checklist;
 	uint32 server_sync_step;
+	uint32 server_subsystem_hash[world_hash_t::SUBSYSTEM_COUNT];
 	// no action required -> can be ignored if too old
 	virtual bool ignore_old_events() const { return true; }
 };
 
+/**
+ * nwc_world_hash_t
+ * @from-client:
+ *		@data sync_step and map_counter of the world hash
+ *		@data subsystem and group (all_groups for the group hashes of the subsystem)
+ *		server sends the requested leaf or group hashes back
+ * @from-server:
+ *		@data the same and the hashes (none if the server has hashed the world again meanwhile)
+ *		client compares them with its own hashes and logs the differing objects,
+ *		when all answers are there it asks for a resync of them or disconnects
+ */
+class nwc_world_hash_t : public network_command_t {
+public:
+	static const uint32 all_groups = 0xFFFFFFFFu;
+
+	nwc_world_hash_t() : network_command_t(NWC_WORLD_HASH), sync_step(0), map_counter(0), subsystem(0), group(all_groups), available(false) { }
+	nwc_world_hash_t(uint32 sync_step_, uint32 map_counter_, uint8 subsystem_, uint32 group_) : network_command_t(NWC_WORLD_HASH), sync_step(sync_step_), map_counter(map_counter_), subsystem(subsystem_), group(group_), available(false) { }
+	virtual bool execute(karte_t *);
+	virtual void rdwr();
+	virtual const char* get_name() { return "nwc_world_hash_t"; }
+
+	/**
+	 * Client: starts fetching the hashes of the subsystems which differ from the server.
+	 * @return false if the world was not hashed at the sync step of the check
+	 */
+	static bool find_difference(karte_t *welt, const nwc_check_t *nwcheck);
+
+	/// Client: true while waiting for the answers, but not longer than WORLD_HASH_TIMEOUT
+	static bool is_pending(const karte_t *welt);
+
+	/// Client: true if the answers did not arrive in time
+	static bool is_timed_out(const karte_t *welt);
+
+private:
+	uint32 sync_step;
+	uint32 map_counter;
+	uint8 subsystem;
+	uint32 group;
+	bool available;
+	vector_tpl<uint32> hashes;
+
+	static uint32 pending;
+	static uint32 pending_map_counter;
+	static uint32 pending_since;
+	static uint32 requests;
+
+	// the differing objects, if all of them can be resynced
+	static bool resync_possible;
+	static vector_tpl<uint8> resync_subsystems;
+	static vector_tpl<uint32> resync_leaves;
+
+	static void request(karte_t *welt, uint8 subsystem, uint32 group);
+	void compare(karte_t *welt);
+};
+
 /**
  * commands that need to be executed at a certain syncstep
  * the command will be cloned at the server and broadcasted to all clients
@@ -344,6 +402,48 @@ private:
 	nwc_chg_player_t& operator=(const nwc_chg_player_t&);
 };
 
+/**
+ * nwc_resync_t
+ * @from-client:
+ *		@data objects (subsystem and leaf of world_hash_t, for halts their id) which differ from the server
+ *		server checks the request, saves the objects and sends them back to this client only
+ *		(at most one request per client and world_hash_t::interval)
+ * @from-server:
+ *		@data the saved objects, sync_step is the sync step at which they were saved
+ *		the client replaces the state of these objects when it reaches this sync step
+ * Only halts (waiting goods), factories (stock) and players (finances) can be replaced in place.
+ * The server and the other clients are never changed.
+ */
+class nwc_resync_t : public network_world_command_t {
+public:
+	nwc_resync_t() : network_world_command_t(NWC_RESYNC, 0, 0) { }
+	nwc_resync_t(uint32 sync_step, uint32 map_counter) : network_world_command_t(NWC_RESYNC, sync_step, map_counter) { }
+	virtual bool execute(karte_t *);
+	virtual void rdwr();
+	virtual void do_command(karte_t*);
+	virtual const char* get_name() { return "nwc_resync_t"; }
+
+	/// true if the objects of this subsystem of world_hash_t can be resynced
+	static bool can_resync(uint8 subsystem);
+
+	vector_tpl<uint8> subsystems;
+	vector_tpl<uint32> leaves;
+private:
+	memory_file_t data;
+
+	// server: sync step of the last resync of each client
+	static vector_tpl<uint32> last_resync;
+
+	/// server: true if this request of client_id may be answered
+	bool is_valid_request(karte_t *welt, uint32 client_id) const;
+
+	/// server: saves the requested objects into the data of answer
+	bool save_objects(karte_t *welt, nwc_resync_t *answer) const;
+
+	nwc_resync_t(const nwc_resync_t&);
+	nwc_resync_t& operator=(const nwc_resync_t&);
+};
+
 /**
  * nwc_tool_t
  * @from-client: client sends tool init/work
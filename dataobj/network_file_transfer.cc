@@ -274,6 +274,36 @@ error:
 	return "Client closed connection during transfer";
 }
 
+
+const char *network_send_file( uint32 client_id, const memory_file_t *mem )
+{
+	const long length = (long)mem->len;
+	long bytes_sent = 0;
+
+	// send size of file
+	nwc_game_t nwc(length);
+	SOCKET s = socket_list_t::get_socket(client_id);
+	if (s==INVALID_SOCKET  ||  !nwc.send(s)) {
+		return "Client closed connection during transfer";
+	}
+
+	if(length>0) {
+		loadingscreen_t ls( translator::translate("Transferring game ..."), length, true, true );
+
+		while(  bytes_sent < length  ) {
+			const uint16 bytes = (uint16)min( length - bytes_sent, 32768l );
+			uint16 dummy;
+			if( !network_send_data(s, mem->data + bytes_sent, bytes, dummy, 250) ) {
+				socket_list_t::remove_client(s);
+				return "Client closed connection during transfer";
+			}
+			bytes_sent += bytes;
+			ls.set_progress( bytes_sent );
+		}
+	}
+	return NULL;
+}
+
 /*
   POST a message (poststr) to an HTTP server at the specified address and relative path (name)
   Optionally: Receive response to file localname
@@ -11,6 +11,7 @@
 class cbuffer_t;
 class karte_t;
 class gameinfo_t;
+class memory_file_t;
 
 // connect to address (cp), receive gameinfo, close
 const char *network_gameinfo(const char *cp, gameinfo_t *gi);
@@ -21,6 +22,9 @@ const char* network_connect(const char *cp, karte_t *world);
 // sending file over network
 const char *network_send_file( uint32 client_id, const char *filename );
 
+// sending a savegame from memory, received like a file
+const char *network_send_file( uint32 client_id, const memory_file_t *mem );
+
 // receive file (directly to disk)
 char const* network_receive_file(SOCKET const s, char const* const save_as, long const length);
 
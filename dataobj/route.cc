@@ -22,6 +22,7 @@
 #include "../boden/grund.h"
 #include "../ifc/fahrer.h"
 #include "loadsave.h"
+#include "marker.h"
 #include "route.h"
 #include "umgebung.h"
 #include "../besch/bruecke_besch.h"
@@ -41,6 +42,10 @@
 #include "../simsys.h"
 #endif
 
+#if MULTI_THREAD>1
+#include <pthread.h>
+#endif
+
 
 
 void route_t::kopiere(const route_t *r)
@@ -134,22 +139,27 @@ static bool is_in_list(vector_tpl<route_t::ANode*> const& list, grund_t const* c
 uint32 route_t::MAX_STEP=0;
 uint32 route_t::max_used_steps=0;
 route_t::ANode *route_t::_nodes[MAX_NODES_ARRAY];
+marker_t *route_t::_markers[MAX_NODES_ARRAY];
 bool route_t::_nodes_in_use[MAX_NODES_ARRAY]; // semaphores, since we only have few nodes arrays in memory
+koord route_t::nodes_world_size;
+
+#if MULTI_THREAD>1
+static pthread_mutex_t route_nodes_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 void route_t::INIT_NODES(uint32 max_route_steps, const koord &world_size)
 {
 	for (int i = 0; i < MAX_NODES_ARRAY; ++i)
 	{
 		_nodes[i] = NULL;
+		_markers[i] = NULL;
 		_nodes_in_use[i] = false;
 	}
 
 	// may need very much memory => configurable
+	// the arrays themselves are only allocated when first needed, see GET_NODES()
 	MAX_STEP = min(max_route_steps, world_size.x * world_size.y); 
-	for (int i = 0; i < MAX_NODES_ARRAY; ++i)
-	{
-		_nodes[i] = new ANode[MAX_STEP + 4 + 2];
-	}
+	nodes_world_size = world_size;
 }
 
 void route_t::TERM_NODES()
@@ -161,29 +171,67 @@ void route_t::TERM_NODES()
 		{
 			delete [] _nodes[i];
 			_nodes[i] = NULL;
+			delete _markers[i];
+			_markers[i] = NULL;
 			_nodes_in_use[i] = false;
 		}
 	}
 }
 
-uint8 route_t::GET_NODES(ANode **nodes) 
+uint8 route_t::GET_NODES(ANode **nodes, marker_t **marker)
 {
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &route_nodes_mutex );
+#endif
 	for (int i = 0; i < MAX_NODES_ARRAY; ++i)
 		if (!_nodes_in_use[i])
 		{
 			_nodes_in_use[i] = true;
+			if (_nodes[i] == NULL)
+			{
+				_nodes[i] = new ANode[MAX_STEP + 4 + 2];
+			}
 			*nodes = _nodes[i];
+			if (marker)
+			{
+				if (_markers[i] == NULL)
+				{
+					_markers[i] = new marker_t(nodes_world_size.x, nodes_world_size.y);
+				}
+				*marker = _markers[i];
+			}
+#if MULTI_THREAD>1
+			pthread_mutex_unlock( &route_nodes_mutex );
+#endif
 			return i;
 		}
+#if MULTI_THREAD>1
+	pthread_mutex_unlock( &route_nodes_mutex );
+#endif
 	dbg->fatal("GET_NODE","called while list in use");
 	return 0;
 }
 
-void route_t::RELEASE_NODES(uint8 nodes_index) 
+void route_t::RELEASE_NODES(uint8 nodes_index, uint32 used_steps)
 {
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &route_nodes_mutex );
+#endif
 	if (!_nodes_in_use[nodes_index])
+	{
+#if MULTI_THREAD>1
+		pthread_mutex_unlock( &route_nodes_mutex );
+#endif
 		dbg->fatal("RELEASE_NODE","called while list free"); 
+	}
 	_nodes_in_use[nodes_index] = false; 
+	if (max_used_steps < used_steps)
+	{
+		max_used_steps = used_steps;
+	}
+#if MULTI_THREAD>1
+	pthread_mutex_unlock( &route_nodes_mutex );
+#endif
 }
 
 
@@ -214,12 +262,6 @@ bool route_t::find_route(karte_t *welt, const koord3d start, fahrer_t *fahr, con
 
 //	INT_CHECK("route 347");
 
-	// nothing in lists
-	// NOTE: This will have to be reworked substantially if this algorithm
-	// is to be multi-threaded anywhere: a specific vector or hashtable will 
-	// have to be used instead.
-	welt->unmarkiere_alle();
-
 	// there are several variant for maintaining the open list
 	// however, only binary heap and HOT queue with binary heap are worth considering
 #if defined(tpl_HOT_queue_tpl_h)
@@ -249,14 +291,14 @@ bool route_t::find_route(karte_t *welt, const koord3d start, fahrer_t *fahr, con
 	}
 
 	ANode *nodes;
-	uint8 ni = GET_NODES(&nodes);
+	marker_t *marker;
+	uint8 ni = GET_NODES(&nodes, &marker);
+
+	// nothing in lists
+	marker->unmarkiere_alle();
 
 	uint32 step = 0;
 	ANode* tmp = &nodes[step++];
-	if (route_t::max_used_steps < step)
-	{
-		route_t::max_used_steps = step;
-	}
 	tmp->parent = NULL;
 	tmp->gr = g;
 	tmp->count = 0;
@@ -277,7 +319,7 @@ bool route_t::find_route(karte_t *welt, const koord3d start, fahrer_t *fahr, con
 		ANode *test_tmp = queue.pop();
 
 		// already in open or closed (i.e. all processed nodes) list?
-		if(welt->ist_markiert(test_tmp->gr))
+		if(marker->ist_markiert(test_tmp->gr))
 		{
 			// we were already here on a faster route, thus ignore this branch
 			// (trading speed against memory consumption)
@@ -286,7 +328,7 @@ bool route_t::find_route(karte_t *welt, const koord3d start, fahrer_t *fahr, con
 
 		tmp = test_tmp;
 		gr = tmp->gr;
-		welt->markiere(gr);
+		marker->markiere(gr);
 
 		// already there
 		if(fahr->ist_ziel(gr, tmp->parent == NULL ? NULL : tmp->parent->gr))
@@ -371,7 +413,7 @@ bool route_t::find_route(karte_t *welt, const koord3d start, fahrer_t *fahr, con
 				&& koord_distance(start.get_2d(),gr->get_pos().get_2d()+koord::nsow[r]) < max_depth	// not too far away
 				&& gr->get_neighbour(to, wegtyp, ribi_t::nsow[r])  // is connected
 				&& fahr->ist_befahrbar(to)	// can be driven on
-				&& !welt->ist_markiert(to) // Not in the closed list
+				&& !marker->ist_markiert(to) // Not in the closed list
 			) {
 
 				weg_t* w = to->get_weg(fahr->get_waytype());
@@ -399,10 +441,6 @@ bool route_t::find_route(karte_t *welt, const koord3d start, fahrer_t *fahr, con
 
 				// Add new node
 				ANode* k = &nodes[step++];
-				if (route_t::max_used_steps < step)
-				{
-					route_t::max_used_steps = step;
-				}
 
 				k->parent = tmp;
 				k->gr = to;
@@ -451,15 +489,16 @@ bool route_t::find_route(karte_t *welt, const koord3d start, fahrer_t *fahr, con
 		}
 	}
 
-	RELEASE_NODES(ni);
+	RELEASE_NODES(ni, step);
 	return ok;
 }
 
 
 
-ribi_t::ribi *get_next_dirs(const koord gr_pos, const koord ziel)
+// fills next_ribi with the directions to test, best first
+// (no static buffer here, since several searches may run at the same time)
+static void get_next_dirs(const koord gr_pos, const koord ziel, ribi_t::ribi *next_ribi)
 {
-	static ribi_t::ribi next_ribi[4];
 	if( abs(gr_pos.x-ziel.x)>abs(gr_pos.y-ziel.y) ) {
 		next_ribi[0] = (ziel.x>gr_pos.x) ? ribi_t::ost : ribi_t::west;
 		next_ribi[1] = (ziel.y>gr_pos.y) ? ribi_t::sued : ribi_t::nord;
@@ -470,7 +509,6 @@ ribi_t::ribi *get_next_dirs(const koord gr_pos, const koord ziel)
 	}
 	next_ribi[2] = ribi_t::rueckwaerts( next_ribi[1] );
 	next_ribi[3] = ribi_t::rueckwaerts( next_ribi[0] );
-	return next_ribi;
 }
 
 
@@ -543,13 +581,12 @@ bool route_t::intern_calc_route(karte_t *welt, const koord3d ziel, const koord3d
 #endif
 
 	ANode *nodes;
-	uint8 ni = GET_NODES(&nodes);
+	marker_t *marker;
+	uint8 ni = GET_NODES(&nodes, &marker);
 
 	uint32 step = 0;
 	ANode* tmp = &nodes[step];
 	step ++;
-	if (route_t::max_used_steps < step)
-		route_t::max_used_steps = step;
 
 	tmp->parent = NULL;
 	tmp->gr = welt->lookup(start);
@@ -560,7 +597,7 @@ bool route_t::intern_calc_route(karte_t *welt, const koord3d ziel, const koord3d
 	tmp->ribi_from = ribi_t::alle;
 
 	// nothing in lists
-	welt->unmarkiere_alle();
+	marker->unmarkiere_alle();
 
 	// clear the queue (should be empty anyhow)
 	queue.clear();
@@ -585,7 +622,7 @@ bool route_t::intern_calc_route(karte_t *welt, const koord3d ziel, const koord3d
 		}
 		else {
 			tmp = queue.pop();
-			if(welt->ist_markiert(tmp->gr)) {
+			if(marker->ist_markiert(tmp->gr)) {
 				// we were already here on a faster route, thus ignore this branch
 				// (trading speed against memory consumption)
 				continue;
@@ -593,7 +630,7 @@ bool route_t::intern_calc_route(karte_t *welt, const koord3d ziel, const koord3d
 		}
 
 		gr = tmp->gr;
-		welt->markiere(gr);
+		marker->markiere(gr);
 
 		// we took the target pos out of the closed list
 		if(ziel==gr->get_pos())
@@ -608,7 +645,8 @@ bool route_t::intern_calc_route(karte_t *welt, const koord3d ziel, const koord3d
 		// mask direction we came from
 		const ribi_t::ribi ribi =  fahr->get_ribi(gr)  &  ( ~ribi_t::rueckwaerts(tmp->ribi_from) );
 
-		const ribi_t::ribi *next_ribi = get_next_dirs(gr->get_pos().get_2d(),ziel.get_2d());
+		ribi_t::ribi next_ribi[4];
+		get_next_dirs(gr->get_pos().get_2d(), ziel.get_2d(), next_ribi);
 		for(int r=0; r<4; r++) {
 
 			// a way in our direction?
@@ -628,7 +666,7 @@ bool route_t::intern_calc_route(karte_t *welt, const koord3d ziel, const koord3d
 			}
 
 			// a way goes here, and it is not marked (i.e. in the closed list)
-			if((to || gr->get_neighbour(to, wegtyp, next_ribi[r])) && fahr->ist_befahrbar(to) && !welt->ist_markiert(to)) 
+			if((to || gr->get_neighbour(to, wegtyp, next_ribi[r])) && fahr->ist_befahrbar(to) && !marker->ist_markiert(to)) 
 			{
 				// Do not go on a tile, where a oneway sign forbids going.
 				// This saves time and fixed the bug, that a oneway sign on the final tile was ignored.
@@ -726,8 +764,6 @@ bool route_t::intern_calc_route(karte_t *welt, const koord3d ziel, const koord3d
 				// add new
 				ANode* k = &nodes[step];
 				step ++;
-				if (route_t::max_used_steps < step)
-					route_t::max_used_steps = step;
 
 				k->parent = tmp;
 				k->gr = to;
@@ -776,7 +812,7 @@ bool route_t::intern_calc_route(karte_t *welt, const koord3d ziel, const koord3d
 		ok = true;
 	}
 
-	RELEASE_NODES(ni);
+	RELEASE_NODES(ni, step);
 	return ok;
 }
 
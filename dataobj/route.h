@@ -17,6 +17,7 @@
 class karte_t;
 class fahrer_t;
 class grund_t;
+class marker_t;
 
 /**
  * Routen, zB fr Fahrzeuge
@@ -68,17 +69,24 @@ public:
 #endif
 	};
 
-// These will need to be made non-static if this is ever to be threaded.
+// One node array (and marker) is needed for every search running at the same time:
+// the main thread may nest two searches, and every route search thread needs its own.
 private:
+#if MULTI_THREAD>1
+	static const uint8 MAX_NODES_ARRAY = MULTI_THREAD + 1;
+#else
 	static const uint8 MAX_NODES_ARRAY = 2;
-	static ANode *_nodes[MAX_NODES_ARRAY]; 
+#endif
+	static ANode *_nodes[MAX_NODES_ARRAY];
+	static marker_t *_markers[MAX_NODES_ARRAY];
 	static bool _nodes_in_use[MAX_NODES_ARRAY]; // semaphores, since we only have few nodes arrays in memory
+	static koord nodes_world_size;
 public:
 	static uint32 MAX_STEP;
 	static uint32 max_used_steps;
 	static void INIT_NODES(uint32 max_route_steps, const koord &world_size);
-	static uint8 GET_NODES(ANode **nodes); 
-	static void RELEASE_NODES(uint8 nodes_index);
+	static uint8 GET_NODES(ANode **nodes, marker_t **marker = NULL);
+	static void RELEASE_NODES(uint8 nodes_index, uint32 used_steps = 0);
 	static void TERM_NODES();
 
 	static inline uint32 calc_distance( const koord3d &p1, const koord3d &p2 )
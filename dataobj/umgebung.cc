@@ -22,6 +22,8 @@ const char *umgebung_t::savegame_ex_version_str = EXPERIMENTAL_VER_NR;
 bool umgebung_t::straight_way_without_control = false;
 bool umgebung_t::networkmode = false;
 bool umgebung_t::restore_UI = false;
+uint32 umgebung_t::image_cache_size = 0;
+bool umgebung_t::ground_cache = true;
 extern uint16 network_server_port;
 uint16 const &umgebung_t::server = network_server_port;
 
@@ -95,6 +97,7 @@ sint32 umgebung_t::intercity_road_length;
 plainstring umgebung_t::river_type[10];
 uint8 umgebung_t::river_types;
 sint32 umgebung_t::autosave;
+sint32 umgebung_t::delta_autosaves;
 uint32 umgebung_t::fps;
 sint16 umgebung_t::max_acceleration;
 bool umgebung_t::show_tooltips;
@@ -186,6 +189,7 @@ void umgebung_t::init()
 
 	/* prissi: autosave every x months (0=off) */
 	autosave = 0;
+	delta_autosaves = 0;
 
 	// default: make 25 frames per second (if possible)
 	fps=25;
@@ -38,6 +38,12 @@ public:
 	/// name of the directory to the pak-set
 	static std::string objfilename;
 
+	/// limit for the zoomed and recoloured images in MB (0 = unlimited)
+	static uint32 image_cache_size;
+
+	/// keep the drawn ground of the world view and draw it only again where it changed
+	static bool ground_cache;
+
 
 	/**
 	 * @name Network-related settings
@@ -365,6 +371,9 @@ public:
 	/// @author prissi
 	static sint32 autosave;
 
+	/// autosaves with only the changed tiles between two full ones (needs zipped_blocks)
+	static sint32 delta_autosaves;
+
 
 	/**
 	 * @name Midi/sound options
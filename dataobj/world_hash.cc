@@ -0,0 +1,280 @@
+/*
+ * This file is part of the Simutrans project under the artistic license.
+ * (see license.txt)
+ */
+
+#include "world_hash.h"
+
+#include "../simworld.h"
+#include "../simconvoi.h"
+#include "../simhalt.h"
+#include "../simfab.h"
+#include "../simcity.h"
+#include "../simplan.h"
+#include "../boden/grund.h"
+#include "../bauer/warenbauer.h"
+#include "../player/simplay.h"
+#include "../player/finance.h"
+#include "../vehicle/simvehikel.h"
+#include "../utils/cbuffer_t.h"
+
+
+const uint32 world_hash_t::interval;
+const sint16 world_hash_t::stripe_rows;
+const uint32 world_hash_t::group_size;
+
+
+static inline uint32 hash_add(uint32 hash, uint32 value)
+{
+	hash = (hash ^ value) * 0x9E3779B1u;
+	return hash ^ (hash >> 15);
+}
+
+
+static inline uint32 hash_add(uint32 hash, sint64 value)
+{
+	return hash_add( hash_add( hash, (uint32)value ), (uint32)((uint64)value >> 32) );
+}
+
+
+// hash of a list of hashes, including their number
+static uint32 hash_list(const uint32 *hashes, uint32 count)
+{
+	uint32 hash = hash_add( 0u, count );
+	for(  uint32 i = 0;  i < count;  i++  ) {
+		hash = hash_add( hash, hashes[i] );
+	}
+	return hash;
+}
+
+
+world_hash_t::world_hash_t() :
+	sync_step(0xFFFFFFFFu),
+	root(0),
+	work_step(0xFFFFFFFFu)
+{
+	for(  uint8 s = 0;  s < SUBSYSTEM_COUNT;  s++  ) {
+		subsystem_hash[s] = 0;
+		work_count[s] = 0;
+	}
+}
+
+
+bool world_hash_t::step(karte_t *welt, uint32 sync_step_)
+{
+	const uint32 part = sync_step_ % interval;
+	if(  part == 0  ) {
+		// start with the objects that are there now
+		const koord size = welt->get_size();
+		work_count[MAP] = (size.y + stripe_rows - 1) / stripe_rows;
+		work_count[CONVOYS] = welt->convoys().get_count();
+		work_halts.clear();
+		FOR(slist_tpl<halthandle_t>, const halt, haltestelle_t::get_alle_haltestellen()) {
+			work_halts.append( halt );
+		}
+		work_count[HALTS] = work_halts.get_count();
+		work_count[FACTORIES] = welt->get_fab_list().get_count();
+		work_count[CITIES] = welt->get_staedte().get_count();
+		work_count[PLAYERS] = MAX_PLAYER_COUNT;
+		for(  uint8 s = 0;  s < SUBSYSTEM_COUNT;  s++  ) {
+			work_leaves[s].clear();
+			work_leaves[s].resize( work_count[s] );
+		}
+		work_step = sync_step_;
+	}
+	else if(  work_step == 0xFFFFFFFFu  ||  work_step + part != sync_step_  ) {
+		// not started here or a sync step was missed
+		work_step = 0xFFFFFFFFu;
+		return false;
+	}
+
+	for(  uint8 s = 0;  s < SUBSYSTEM_COUNT;  s++  ) {
+		const uint32 end = (uint32)( ((uint64)work_count[s] * (part + 1)) / interval );
+		for(  uint32 i = work_leaves[s].get_count();  i < end;  i++  ) {
+			work_leaves[s].append( calc_leaf( welt, s, i ) );
+		}
+	}
+
+	if(  part == interval - 1  ) {
+		finish( sync_step_ );
+		work_step = 0xFFFFFFFFu;
+		return true;
+	}
+	return false;
+}
+
+
+void world_hash_t::finish(uint32 sync_step_)
+{
+	uint32 hashes[SUBSYSTEM_COUNT];
+	for(  uint8 s = 0;  s < SUBSYSTEM_COUNT;  s++  ) {
+		leaves[s] = work_leaves[s];
+		const uint32 count = leaves[s].get_count();
+		groups[s].clear();
+		for(  uint32 i = 0;  i < count;  i += group_size  ) {
+			const uint32 n = min( group_size, count - i );
+			groups[s].append( hash_list( &leaves[s][i], n ) );
+		}
+		subsystem_hash[s] = hash_add( hash_list( groups[s].begin(), groups[s].get_count() ), count );
+		hashes[s] = subsystem_hash[s];
+	}
+	halts = work_halts;
+	root = hash_list( hashes, SUBSYSTEM_COUNT );
+	// zero means not hashed in the checklist
+	if(  root == 0  ) {
+		root = 1;
+	}
+	sync_step = sync_step_;
+}
+
+
+uint32 world_hash_t::calc_leaf(karte_t *welt, uint8 subsystem, uint32 leaf) const
+{
+	uint32 hash = 0;
+	switch(  subsystem  ) {
+		// the grounds and the static objects on them; vehicles are in their convoys
+		case MAP: {
+			const koord size = welt->get_size();
+			const sint16 y0 = leaf * stripe_rows;
+			const sint16 y_end = min( y0 + stripe_rows, size.y );
+			for(  sint16 y = y0;  y < y_end;  y++  ) {
+				for(  sint16 x = 0;  x < size.x;  x++  ) {
+					const planquadrat_t *plan = welt->access(x, y);
+					for(  uint8 i = 0;  i < plan->get_boden_count();  i++  ) {
+						const grund_t *gr = plan->get_boden_bei(i);
+						hash = hash_add( hash, (uint32)gr->get_typ() | ((uint32)(uint8)gr->get_hoehe() << 8) | ((uint32)gr->get_grund_hang() << 16) );
+						for(  uint8 j = 0;  j < gr->get_top();  j++  ) {
+							const ding_t *d = gr->obj_bei(j);
+							if(  !d->is_moving()  ) {
+								hash = hash_add( hash, (uint32)d->get_typ() | ((uint32)(uint8)d->get_player_nr() << 8) );
+							}
+						}
+					}
+				}
+			}
+			break;
+		}
+
+		case CONVOYS:
+			if(  leaf < welt->convoys().get_count()  ) {
+				const convoihandle_t cnv = welt->convoys()[leaf];
+				hash = hash_add( (uint32)cnv->get_state(), (uint32)cnv->get_akt_speed() );
+				hash = hash_add( hash, cnv->get_jahresgewinn() );
+				for(  uint8 i = 0;  i < cnv->get_vehikel_anzahl();  i++  ) {
+					const vehikel_t *v = cnv->get_vehikel(i);
+					const koord3d pos = v->get_pos();
+					hash = hash_add( hash, (uint32)(uint16)pos.x | ((uint32)(uint16)pos.y << 16) );
+					hash = hash_add( hash, (uint32)(uint8)pos.z | ((uint32)v->get_fracht_menge() << 8) );
+				}
+			}
+			break;
+
+		// the waiting goods of the halts
+		case HALTS:
+			if(  work_halts[leaf].is_bound()  ) {
+				const halthandle_t halt = work_halts[leaf];
+				const koord pos = halt->get_basis_pos();
+				hash = hash_add( 0u, (uint32)(uint16)pos.x | ((uint32)(uint16)pos.y << 16) );
+				for(  uint16 i = 0;  i < warenbauer_t::get_waren_anzahl();  i++  ) {
+					hash = hash_add( hash, halt->get_ware_summe( warenbauer_t::get_info(i) ) );
+				}
+			}
+			break;
+
+		case FACTORIES:
+			if(  leaf < welt->get_fab_list().get_count()  ) {
+				const fabrik_t *fab = welt->get_fab_list()[leaf];
+				const koord3d pos = fab->get_pos();
+				hash = hash_add( (uint32)(uint16)pos.x | ((uint32)(uint16)pos.y << 16), (uint32)fab->get_prodfactor() );
+				FOR(array_tpl<ware_production_t>, const& ware, fab->get_eingang()) {
+					hash = hash_add( hash, (uint32)ware.menge );
+				}
+				FOR(array_tpl<ware_production_t>, const& ware, fab->get_ausgang()) {
+					hash = hash_add( hash, (uint32)ware.menge );
+				}
+			}
+			break;
+
+		case CITIES:
+			if(  leaf < welt->get_staedte().get_count()  ) {
+				const stadt_t *city = welt->get_staedte()[leaf];
+				const koord pos = city->get_pos();
+				hash = hash_add( (uint32)(uint16)pos.x | ((uint32)(uint16)pos.y << 16), (uint32)city->get_einwohner() );
+				hash = hash_add( hash, city->get_buildings() );
+			}
+			break;
+
+		case PLAYERS: {
+			spieler_t *sp = welt->get_spieler(leaf);
+			hash = sp ? hash_add( 1u, sp->get_finance()->get_account_balance() ) : 0;
+			break;
+		}
+	}
+	return hash;
+}
+
+
+void world_hash_t::get_group_leaves(uint8 subsystem, uint32 group, vector_tpl<uint32> &hashes) const
+{
+	const vector_tpl<uint32> &list = leaves[subsystem];
+	for(  uint32 i = group * group_size;  i < list.get_count()  &&  i < (group + 1) * group_size;  i++  ) {
+		hashes.append( list[i] );
+	}
+}
+
+
+const char *world_hash_t::get_subsystem_name(uint8 subsystem)
+{
+	static const char *const names[SUBSYSTEM_COUNT] = { "map", "convoys", "halts", "factories", "cities", "players" };
+	return subsystem < SUBSYSTEM_COUNT ? names[subsystem] : "?";
+}
+
+
+void world_hash_t::describe_leaf(karte_t *welt, uint8 subsystem, uint32 leaf, cbuffer_t &buf) const
+{
+	switch(  subsystem  ) {
+		case MAP:
+			buf.printf( "map rows %u-%u", leaf * stripe_rows, (leaf + 1) * stripe_rows - 1 );
+			return;
+
+		case CONVOYS:
+			if(  leaf < welt->convoys().get_count()  ) {
+				convoihandle_t cnv = welt->convoys()[leaf];
+				buf.printf( "convoy %s at %s", cnv->get_name(), cnv->get_pos().get_str() );
+				return;
+			}
+			break;
+
+		case HALTS:
+			if(  get_halt(leaf).is_bound()  ) {
+				const halthandle_t halt = get_halt(leaf);
+				buf.printf( "halt %s at %s", halt->get_name(), halt->get_basis_pos().get_str() );
+				return;
+			}
+			break;
+
+		case FACTORIES:
+			if(  leaf < welt->get_fab_list().get_count()  ) {
+				const fabrik_t *fab = welt->get_fab_list()[leaf];
+				buf.printf( "factory %s at %s", fab->get_name(), fab->get_pos().get_str() );
+				return;
+			}
+			break;
+
+		case CITIES:
+			if(  leaf < welt->get_staedte().get_count()  ) {
+				const stadt_t *city = welt->get_staedte()[leaf];
+				buf.printf( "city %s", city->get_name() );
+				return;
+			}
+			break;
+
+		case PLAYERS:
+			if(  leaf < MAX_PLAYER_COUNT  &&  welt->get_spieler(leaf)  ) {
+				buf.printf( "player %s", welt->get_spieler(leaf)->get_name() );
+				return;
+			}
+			break;
+	}
+	buf.printf( "%s #%u (missing here)", get_subsystem_name(subsystem), leaf );
+}
@@ -0,0 +1,101 @@
+/*
+ * This file is part of the Simutrans project under the artistic license.
+ * (see license.txt)
+ */
+
+#ifndef world_hash_h
+#define world_hash_h
+
+#include "../simtypes.h"
+#include "../tpl/vector_tpl.h"
+#include "../halthandle_t.h"
+
+class karte_t;
+class cbuffer_t;
+
+
+/**
+ * Hashes of the simulation state to find desyncs in network games.
+ *
+ * Each subsystem (map stripes, convoys, halts, ...) has one hash per object.
+ * These leaves are combined in groups of group_size, the groups into the hash
+ * of the subsystem and the subsystems into the root.
+ * The hashing is spread over the sync steps of an interval: at each sync
+ * step, every subsystem hashes its next 1/interval of the objects that it
+ * had at the start of the interval. Server and clients hash the same
+ * objects at the same sync steps; the root of an interval is part of the
+ * checklist of its last sync step. When it differs, the subsystem, group and leaf hashes of the server are fetched
+ * one level after the other, until the differing objects are known.
+ * Objects are identified by their position in the lists of the world, which
+ * is the same on all machines as long as they are in sync.
+ */
+class world_hash_t
+{
+public:
+	enum subsystem_t { MAP, CONVOYS, HALTS, FACTORIES, CITIES, PLAYERS, SUBSYSTEM_COUNT };
+
+	/// sync steps over which one hashing of the world is spread
+	static const uint32 interval = 256;
+
+	/// map rows per leaf of the map
+	static const sint16 stripe_rows = 16;
+
+	/// leaves per group
+	static const uint32 group_size = 256;
+
+private:
+	uint32 sync_step;
+	uint32 root;
+	uint32 subsystem_hash[SUBSYSTEM_COUNT];
+	vector_tpl<uint32> groups[SUBSYSTEM_COUNT];
+	vector_tpl<uint32> leaves[SUBSYSTEM_COUNT];
+	// the halts of the leaves, which are hashed in this order
+	vector_tpl<halthandle_t> halts;
+
+	// the hashing in progress, started at work_step (0xFFFFFFFF if none)
+	uint32 work_step;
+	uint32 work_count[SUBSYSTEM_COUNT];
+	vector_tpl<uint32> work_leaves[SUBSYSTEM_COUNT];
+	vector_tpl<halthandle_t> work_halts;
+
+	/// hash of the object leaf, 0 if it is gone since the start of the interval
+	uint32 calc_leaf(karte_t *welt, uint8 subsystem, uint32 leaf) const;
+
+	void finish(uint32 sync_step);
+
+public:
+	world_hash_t();
+
+	/**
+	 * Hashes the part of the world for this sync step. The hashing starts at
+	 * the multiples of interval; without the start (e.g. after joining) the
+	 * interval is skipped.
+	 * @return true, if this sync step completed the hashing; then get_root()
+	 *         is the new root
+	 */
+	bool step(karte_t *welt, uint32 sync_step);
+
+	/// the last sync step of the last complete hashing, 0xFFFFFFFF if there was none
+	uint32 get_sync_step() const { return sync_step; }
+
+	uint32 get_root() const { return root; }
+
+	uint32 get_subsystem_hash(uint8 subsystem) const { return subsystem_hash[subsystem]; }
+
+	const vector_tpl<uint32> &get_groups(uint8 subsystem) const { return groups[subsystem]; }
+
+	const vector_tpl<uint32> &get_leaves(uint8 subsystem) const { return leaves[subsystem]; }
+
+	/// the leaves of group, appended to hashes
+	void get_group_leaves(uint8 subsystem, uint32 group, vector_tpl<uint32> &hashes) const;
+
+	static const char *get_subsystem_name(uint8 subsystem);
+
+	/// the halt of this leaf of HALTS, unbound if it is gone
+	halthandle_t get_halt(uint32 leaf) const { return leaf < halts.get_count() ? halts[leaf] : halthandle_t(); }
+
+	/// appends a description of the object with the hash leaf to buf
+	void describe_leaf(karte_t *welt, uint8 subsystem, uint32 leaf, cbuffer_t &buf) const;
+};
+
+#endif
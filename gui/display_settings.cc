@@ -78,7 +78,8 @@
 #define PHASE_FILL_MATRIX				(PHASE_FILTER_ELIGIBLE+13)
 #define PHASE_EXPLORE_PATHS				(PHASE_FILL_MATRIX+13)
 #define PHASE_REROUTE_GOODS				(PHASE_EXPLORE_PATHS+13)
-#define PATH_EXPLORE_STATUS				(PHASE_REROUTE_GOODS+13)
+#define PATH_EXPLORE_INCREMENTAL		(PHASE_REROUTE_GOODS+13)
+#define PATH_EXPLORE_STATUS				(PATH_EXPLORE_INCREMENTAL+13)
 
 
 #define BOTTOM							(PATH_EXPLORE_STATUS+30)
@@ -543,6 +544,15 @@ void color_gui_t::zeichnen(koord pos, koord gr)
 	len = 15+display_proportional_clip(x+10, y+PHASE_REROUTE_GOODS, translator::translate("Re-route goods:"), ALIGN_LEFT, text_colour, true);
 	display_proportional_clip(x+len, y+PHASE_REROUTE_GOODS, ntos(path_explorer_t::get_limit_reroute_goods(), "%lu"), ALIGN_LEFT, figure_colour, true);
 
+	// incremental path updates out of all path explorations, and share of the full exploration work saved by them
+	const uint64 explore_done = path_explorer_t::get_explore_iterations_done();
+	const uint64 explore_saved = path_explorer_t::get_explore_iterations_saved();
+	sprintf( buf, "%u/%u, %u%% saved", path_explorer_t::get_incremental_explore_count(),
+		path_explorer_t::get_incremental_explore_count() + path_explorer_t::get_full_explore_count(),
+		(unsigned)( explore_done + explore_saved ? explore_saved * 100u / ( explore_done + explore_saved ) : 0 ) );
+	len = 15+display_proportional_clip(x+10, y+PATH_EXPLORE_INCREMENTAL, translator::translate("Incremental paths:"), ALIGN_LEFT, text_colour, true);
+	display_proportional_clip(x+len, y+PATH_EXPLORE_INCREMENTAL, buf, ALIGN_LEFT, figure_colour, true);
+
 	len = 15+display_proportional_clip(x+10, y+PATH_EXPLORE_STATUS, translator::translate("Status:"), ALIGN_LEFT, text_colour, true);
 	display_proportional_clip(x+len, y+PATH_EXPLORE_STATUS, status_string, ALIGN_LEFT, figure_colour, true);
 
@@ -24,12 +24,25 @@
 #include "../simgraph.h"
 #include "../simtools.h"
 #include "../player/simplay.h"
+#include "../vehicle/simvehikel.h"
 
 #include "../tpl/inthashtable_tpl.h"
 #include "../tpl/slist_tpl.h"
+#include "../utils/simthread.h"
 
 #include <math.h>
 
+#if MULTI_THREAD>1
+#include <pthread.h>
+static pthread_mutex_t layer_job_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+// more changes of a hidden layer are not recorded, it is recalculated then
+#define MAX_CHANGED_TILES (4096)
+
+// tiles of a layer calculated per redraw and thread
+#define LAYER_TILES_PER_THREAD (65536)
+
 sint32 reliefkarte_t::max_cargo=0;
 sint32 reliefkarte_t::max_passed=0;
 
@@ -714,36 +727,59 @@ uint8 reliefkarte_t::calc_relief_farbe(const grund_t *gr)
 }
 
 
-void reliefkarte_t::calc_map_pixel(const koord k)
+// the sum of a statistic of the (maximum two) ways of this ground, or -1 without ways
+static sint32 get_way_statistics(const grund_t *gr, int type)
 {
-	// we ignore requests, when nothing visible ...
-	if(!is_visible) {
-		return;
+	const weg_t *w = gr->hat_wege() ? gr->get_weg_nr(0) : NULL;
+	if(  w==NULL  ) {
+		return -1;
+	}
+	sint32 sum = w->get_statistics(type);
+	if(  const weg_t *w2 = gr->get_weg_nr(1)  ) {
+		sum += w2->get_statistics(type);
+	}
+	return sum;
+}
+
+
+// the level of the building on this ground, or -1 without one
+static sint32 get_building_level(const grund_t *gr)
+{
+	if(  gr->get_typ() == grund_t::fundament  ) {
+		if(  const gebaeude_t *gb = gr->find<gebaeude_t>()  ) {
+			if(  gb->get_haustyp() != gebaeude_t::unbekannt  ) {
+				return gb->get_tile()->get_besch()->get_level();
+			}
+		}
 	}
+	return -1;
+}
 
+
+/**
+ * The color of a tile in this mode (without vehicles). Called from several threads
+ * during calc_layer(), so only the maxima may be changed, and only if asked to.
+ */
+uint8 reliefkarte_t::calc_tile_color(const koord k, const MAP_MODES layer_mode, const bool update_maximum) const
+{
 	// always use to uppermost ground
 	const planquadrat_t *plan=welt->lookup(k);
 	if(plan==NULL  ||  plan->get_boden_count()==0) {
-		return;
+		return COL_BLACK;
 	}
 	const grund_t *gr=plan->get_boden_bei(plan->get_boden_count()-1);
 
-	if(  mode!=MAP_PAX_DEST  &&  gr->get_convoi_vehicle()  ) {
-		set_relief_farbe( k, VEHIKEL_KENN );
-		return;
-	}
-
 	// first use ground color
-	set_relief_farbe( k, calc_relief_farbe(gr) );
+	uint8 color = calc_relief_farbe(gr);
 
-	switch(mode&~MAP_MODE_FLAGS) {
+	switch(layer_mode) {
 		// show passenger coverage
 		// display coverage
 		case MAP_PASSENGER:
 			if(  plan->get_haltlist_count()>0  ) {
 				halthandle_t halt = plan->get_haltlist()[0].halt;
 				if(  halt->get_pax_enabled()  &&  !halt->get_connexions(0)->empty() ){
-					set_relief_farbe( k, halt->get_besitzer()->get_player_color1() + 3 );
+					color = halt->get_besitzer()->get_player_color1() + 3;
 				}
 			}
 			break;
@@ -754,60 +790,33 @@ void reliefkarte_t::calc_map_pixel(const koord k)
 			if(  plan->get_haltlist_count()>0  ) {
 				halthandle_t halt = plan->get_haltlist()[0].halt;
 				if(  halt->get_post_enabled()  &&  !halt->get_connexions(1)->empty()  ) {
-					set_relief_farbe( k, halt->get_besitzer()->get_player_color1() + 3 );
+					color = halt->get_besitzer()->get_player_color1() + 3;
 				}
 			}
 			break;
 
 		// show usage
 		case MAP_FREIGHT:
-			// need to init the maximum?
-			if(max_cargo==0) {
-				max_cargo = 1;
-				calc_map();
-			}
-			else if(  gr->hat_wege()  ) {
-				// now calc again ...
-				sint32 cargo=0;
-
-				// maximum two ways for one ground
-				const weg_t *w=gr->get_weg_nr(0);
-				if(w) {
-					cargo = w->get_statistics(WAY_STAT_GOODS);
-					const weg_t *w=gr->get_weg_nr(1);
-					if(w) {
-						cargo += w->get_statistics(WAY_STAT_GOODS);
-					}
-					if(  cargo > max_cargo  ) {
+			{
+				const sint32 cargo = get_way_statistics( gr, WAY_STAT_GOODS );
+				if(  cargo >= 0  ) {
+					if(  update_maximum  &&  cargo > max_cargo  ) {
 						max_cargo = cargo;
 					}
-					set_relief_farbe(k, calc_severity_color_log(cargo, max_cargo));
+					color = calc_severity_color_log( cargo, max_cargo );
 				}
 			}
 			break;
 
 		// show traffic (=convois/month)
 		case MAP_TRAFFIC:
-			// need to init the maximum?
-			if(  max_passed==0  ) {
-				max_passed = 1;
-				calc_map();
-			}
-			else if(gr->hat_wege()) {
-				// now calc again ...
-				sint32 passed=0;
-
-				// maximum two ways for one ground
-				const weg_t *w=gr->get_weg_nr(0);
-				if(w) {
-					passed = w->get_statistics(WAY_STAT_CONVOIS);
-					if(  weg_t *w=gr->get_weg_nr(1)  ) {
-						passed += w->get_statistics(WAY_STAT_CONVOIS);
-					}
-					if(  passed > max_passed  ) {
+			{
+				const sint32 passed = get_way_statistics( gr, WAY_STAT_CONVOIS );
+				if(  passed >= 0  ) {
+					if(  update_maximum  &&  passed > max_passed  ) {
 						max_passed = passed;
 					}
-					set_relief_farbe_area(k, 1, calc_severity_color_log( passed, max_passed ) );
+					color = calc_severity_color_log( passed, max_passed );
 				}
 			}
 			break;
@@ -817,15 +826,10 @@ void reliefkarte_t::calc_map_pixel(const koord k)
 			// show track
 			if (gr->hat_weg(track_wt)) {
 				const schiene_t * sch = (const schiene_t *) (gr->get_weg(track_wt));
-				if(sch->is_electrified()) {
-					set_relief_farbe(k, COL_RED);
-				}
-				else {
-					set_relief_farbe(k, COL_WHITE);
-				}
+				color = sch->is_electrified() ? COL_RED : COL_WHITE;
 				// show signals
 				if(sch->has_sign()  ||  sch->has_signal()) {
-					set_relief_farbe(k, COL_YELLOW);
+					color = COL_YELLOW;
 				}
 			}
 			break;
@@ -835,7 +839,7 @@ void reliefkarte_t::calc_map_pixel(const koord k)
 			{
 				sint32 speed=gr->get_max_speed();
 				if(speed) {
-					set_relief_farbe(k, calc_severity_color(gr->get_max_speed(), 450));
+					color = calc_severity_color(speed, 450);
 				}
 			}
 			break;
@@ -845,14 +849,14 @@ void reliefkarte_t::calc_map_pixel(const koord k)
 			{
 				const leitung_t* lt = gr->find<leitung_t>();
 				if(lt!=NULL) {
-					set_relief_farbe(k, calc_severity_color(lt->get_net()->get_demand(),lt->get_net()->get_supply()) );
+					color = calc_severity_color(lt->get_net()->get_demand(),lt->get_net()->get_supply());
 				}
 			}
 			break;
 
 		case MAP_FOREST:
 			if(  gr->get_top()>1  &&  gr->obj_bei(gr->get_top()-1)->get_typ()==ding_t::baum  ) {
-				set_relief_farbe(k, COL_GREEN );
+				color = COL_GREEN;
 			}
 			break;
 
@@ -860,34 +864,27 @@ void reliefkarte_t::calc_map_pixel(const koord k)
 			// show ownership
 			{
 				if(  gr->is_halt()  ) {
-					set_relief_farbe(k, gr->get_halt()->get_besitzer()->get_player_color1()+3);
+					color = gr->get_halt()->get_besitzer()->get_player_color1()+3;
 				}
 				else if(  weg_t *weg = gr->get_weg_nr(0)  ) {
-					set_relief_farbe(k, weg->get_besitzer()==NULL ? COL_ORANGE : weg->get_besitzer()->get_player_color1()+3 );
+					color = weg->get_besitzer()==NULL ? COL_ORANGE : weg->get_besitzer()->get_player_color1()+3;
 				}
 				if(  gebaeude_t *gb = gr->find<gebaeude_t>()  ) {
 					if(  gb->get_besitzer()!=NULL  ) {
-						set_relief_farbe(k, gb->get_besitzer()->get_player_color1()+3 );
+						color = gb->get_besitzer()->get_player_color1()+3;
 					}
 				}
 				break;
 			}
 
 		case MAP_LEVEL:
-			if(  max_building_level == 0  ) {
-				// init maximum
-				max_building_level = 1;
-				calc_map();
-			}
-			else if(  gr->get_typ() == grund_t::fundament  ) {
-				if(  gebaeude_t *gb = gr->find<gebaeude_t>()  ) {
-					if(  gb->get_haustyp() != gebaeude_t::unbekannt  ) {
-						sint32 level = gb->get_tile()->get_besch()->get_level();
-						if(  level > max_building_level  ) {
-							max_building_level = level;
-						}
-						set_relief_farbe_area(k, 1, calc_severity_color( level, max_building_level ) );
+			{
+				const sint32 level = get_building_level( gr );
+				if(  level >= 0  ) {
+					if(  update_maximum  &&  level > max_building_level  ) {
+						max_building_level = level;
 					}
+					color = calc_severity_color( level, max_building_level );
 				}
 			}
 			break;
@@ -895,6 +892,212 @@ void reliefkarte_t::calc_map_pixel(const koord k)
 		default:
 			break;
 	}
+	return color;
+}
+
+
+void reliefkarte_t::calc_map_pixel(const koord k)
+{
+	// we ignore requests, when nothing visible ...
+	if(!is_visible) {
+		// ... but then the layers miss this change
+		layers_outdated = true;
+		return;
+	}
+	if(  !welt->is_within_limits(k)  ) {
+		return;
+	}
+
+	for(  int i = 0;  i < MAX_MAP_LAYERS;  i++  ) {
+		map_layer_t &l = layers[i];
+		if(  l.colors==NULL  ) {
+			continue;
+		}
+		if(  &l == layer  ) {
+			l.colors->at(k) = calc_tile_color( k, l.mode, true );
+		}
+		else if(  l.changed.get_count() < MAX_CHANGED_TILES  ) {
+			// updated when shown again
+			l.changed.append( k );
+		}
+		else {
+			// too many changes: recalculate all
+			l.done_rows = 0;
+			l.changed.clear();
+		}
+	}
+	calc_vehicle_pixel( k );
+}
+
+
+void reliefkarte_t::calc_vehicle_pixel(const koord k)
+{
+	if(  !is_visible  ||  layer==NULL  ||  !welt->is_within_limits(k)  ) {
+		return;
+	}
+
+	// always use to uppermost ground
+	const planquadrat_t *plan=welt->lookup(k);
+	if(  plan->get_boden_count()==0  ) {
+		return;
+	}
+
+	if(  mode!=MAP_PAX_DEST  &&  plan->get_boden_bei(plan->get_boden_count()-1)->get_convoi_vehicle()  ) {
+		set_relief_farbe( k, VEHIKEL_KENN );
+	}
+	else {
+		set_relief_farbe( k, layer->colors->at(k) );
+	}
+}
+
+
+// calculates the rows of the job until none is left
+void reliefkarte_t::calc_layer_rows(void *ptr, int)
+{
+	layer_job_t *job = (layer_job_t *)ptr;
+	const MAP_MODES m = job->layer->mode;
+	const sint16 width = welt->get_size().x;
+	sint32 maximum = 0;
+
+	while(  true  ) {
+#if MULTI_THREAD>1
+		pthread_mutex_lock( &layer_job_mutex );
+#endif
+		koord k( 0, job->next_row );
+		if(  k.y < job->end_row  ) {
+			job->next_row++;
+		}
+#if MULTI_THREAD>1
+		pthread_mutex_unlock( &layer_job_mutex );
+#endif
+		if(  k.y >= job->end_row  ) {
+			break;
+		}
+
+		for(  k.x = 0;  k.x < width;  k.x++  ) {
+			if(  job->maximum_only  ) {
+				const planquadrat_t *plan = welt->lookup(k);
+				if(  plan->get_boden_count()>0  ) {
+					const grund_t *gr = plan->get_boden_bei(plan->get_boden_count()-1);
+					const sint32 value = m==MAP_LEVEL ? get_building_level(gr) : get_way_statistics( gr, m==MAP_FREIGHT ? WAY_STAT_GOODS : WAY_STAT_CONVOIS );
+					maximum = max( maximum, value );
+				}
+			}
+			else {
+				job->layer->colors->at(k) = job->karte->calc_tile_color( k, m, false );
+			}
+		}
+	}
+
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &layer_job_mutex );
+#endif
+	job->maximum = max( job->maximum, maximum );
+#if MULTI_THREAD>1
+	pthread_mutex_unlock( &layer_job_mutex );
+#endif
+}
+
+
+void reliefkarte_t::run_layer_job(layer_job_t &job)
+{
+#if MULTI_THREAD>1
+	// a few rows are not worth the threads
+	run_parallel( calc_layer_rows, &job, job.end_row - job.next_row >= 2*MULTI_THREAD ? MULTI_THREAD : 1 );
+#else
+	calc_layer_rows( &job, 0 );
+#endif
+}
+
+
+void reliefkarte_t::calc_layer(map_layer_t *l, sint16 rows)
+{
+	layer_job_t job;
+	job.karte = this;
+	job.layer = l;
+	job.maximum = 1;
+
+	if(  l->done_rows==0  &&  l->max_rows < welt->get_size().y  &&  (l->mode==MAP_FREIGHT  ||  l->mode==MAP_TRAFFIC  ||  l->mode==MAP_LEVEL)  ) {
+		// the severity colors need the maximum of the whole map first, also searched some rows at a time
+		if(  l->max_rows==0  ) {
+			l->maximum = 1;
+		}
+		job.next_row = l->max_rows;
+		job.end_row = (sint16)min( (sint32)welt->get_size().y, (sint32)l->max_rows + rows );
+		job.maximum = l->maximum;
+		job.maximum_only = true;
+		run_layer_job( job );
+		l->maximum = job.maximum;
+		l->max_rows = job.end_row;
+		if(  l->max_rows == welt->get_size().y  ) {
+			switch(  l->mode  ) {
+				case MAP_FREIGHT: max_cargo = l->maximum; break;
+				case MAP_TRAFFIC: max_passed = l->maximum; break;
+				default: max_building_level = l->maximum; break;
+			}
+		}
+		return;
+	}
+
+	job.next_row = l->done_rows;
+	job.end_row = (sint16)min( (sint32)welt->get_size().y, (sint32)l->done_rows + rows );
+	job.maximum_only = false;
+	run_layer_job( job );
+	l->done_rows = job.end_row;
+	// the next recalculation searches the maximum again
+	l->max_rows = 0;
+}
+
+
+// the layer for this mode, maybe replacing the least recently used one
+reliefkarte_t::map_layer_t *reliefkarte_t::get_layer(MAP_MODES layer_mode)
+{
+	const koord size = welt->get_size();
+	map_layer_t *l = NULL;
+	for(  int i = 0;  i < MAX_MAP_LAYERS;  i++  ) {
+		if(  layers[i].colors  &&  layers[i].mode==layer_mode  ) {
+			l = &layers[i];
+		}
+	}
+
+	if(  l==NULL  ) {
+		l = layers;
+		for(  int i = 1;  i < MAX_MAP_LAYERS  &&  l->colors;  i++  ) {
+			if(  layers[i].colors==NULL  ||  layers[i].last_used < l->last_used  ) {
+				l = &layers[i];
+			}
+		}
+		if(  l->colors==NULL  ||  (sint16)l->colors->get_width()!=size.x  ||  (sint16)l->colors->get_height()!=size.y  ) {
+			delete l->colors;
+			l->colors = new array2d_tpl<uint8>( size.x, size.y );
+		}
+		l->colors->init( COL_BLACK );
+		l->mode = layer_mode;
+		l->done_rows = 0;
+		l->max_rows = 0;
+		l->changed.clear();
+	}
+	else {
+		// catch up with the changes while not shown
+		FOR(vector_tpl<koord>, const k, l->changed) {
+			l->colors->at(k) = calc_tile_color( k, layer_mode, true );
+		}
+		l->changed.clear();
+	}
+
+	l->last_used = ++layer_counter;
+	return l;
+}
+
+
+// all layers are recalculated, but shown until then
+void reliefkarte_t::invalidate_layers()
+{
+	for(  int i = 0;  i < MAX_MAP_LAYERS;  i++  ) {
+		layers[i].done_rows = 0;
+		layers[i].max_rows = 0;
+		layers[i].changed.clear();
+	}
 }
 
 
@@ -915,38 +1118,62 @@ void reliefkarte_t::calc_map_groesse()
 
 void reliefkarte_t::calc_map()
 {
-	// only use bitmap size like screen size
-	koord relief_size( min( get_groesse().x, new_size.x ), min( get_groesse().y, new_size.y ) );
-	// actually the following line should reduce new/deletes, but does not work properly
-	if(  relief==NULL  ||  (sint16)relief->get_width()!=relief_size.x  ||  (sint16)relief->get_height()!=relief_size.y  ) {
-		delete relief;
-		relief = new array2d_tpl<unsigned char> (relief_size.x,relief_size.y);
-	}
-	cur_off = new_off;
-	cur_size = new_size;
-	needs_redraw = false;
-	is_visible = true;
+	invalidate_layers();
+	needs_redraw = true;
+}
 
-	// redraw the map
+
+// draws the rows from y_start to y_end of the current layer, as far as visible
+void reliefkarte_t::draw_layer_rows(sint16 y_start, sint16 y_end)
+{
+	koord k;
 	if(  !isometric  ) {
-		koord k;
 		koord start_off = koord( (cur_off.x*zoom_out)/zoom_in, (cur_off.y*zoom_out)/zoom_in );
 		koord end_off = start_off+koord( (relief->get_width()*zoom_out)/zoom_in+1, (relief->get_height()*zoom_out)/zoom_in+1 );
-		for(  k.y=start_off.y;  k.y<end_off.y;  k.y+=zoom_out  ) {
+		end_off.x = min( end_off.x, welt->get_size().x );
+		end_off.y = min( end_off.y, y_end );
+		// only every zoom_out row is shown
+		k.y = start_off.y;
+		if(  y_start > k.y  ) {
+			k.y += ((y_start - k.y + zoom_out - 1) / zoom_out) * zoom_out;
+		}
+		for(  ;  k.y<end_off.y;  k.y+=zoom_out  ) {
 			for(  k.x=start_off.x;  k.x<end_off.x;  k.x+=zoom_out  ) {
-				calc_map_pixel(k);
+				set_relief_farbe( k, layer->colors->at(k) );
 			}
 		}
 	}
 	else {
-		// always the whole map ...
-		if(isometric) {
-			relief->init( COL_BLACK );
+		// the tiles in the rectangle around the visible part of the diamond
+		koord lo = welt->get_size(), hi( 0, 0 );
+		for(  int i = 0;  i < 4;  i++  ) {
+			koord corner = cur_off + koord( (i&1) ? relief->get_width() : 0, (i&2) ? relief->get_height() : 0 );
+			screen_to_karte( corner );
+			lo.x = min( lo.x, corner.x );
+			lo.y = min( lo.y, corner.y );
+			hi.x = max( hi.x, corner.x );
+			hi.y = max( hi.y, corner.y );
+		}
+		const sint16 margin = 2 + zoom_out;
+		lo.x = max( 0, lo.x-margin );
+		hi.x = min( (sint32)welt->get_size().x, hi.x+margin );
+		hi.y = min( (sint32)y_end, hi.y+margin );
+		for(  k.y=max( (sint32)y_start, lo.y-margin );  k.y < hi.y;  k.y++  ) {
+			for(  k.x=lo.x;  k.x < hi.x;  k.x++  ) {
+				set_relief_farbe( k, layer->colors->at(k) );
+			}
 		}
-		koord k;
-		for(  k.y=0;  k.y < welt->get_size().y;  k.y++  ) {
-			for(  k.x=0;  k.x < welt->get_size().x;  k.x++  ) {
-				calc_map_pixel(k);
+	}
+}
+
+
+// the vehicles and the tourist spots, factories or depots on top of the layer
+void reliefkarte_t::draw_overlays()
+{
+	if(  mode!=MAP_PAX_DEST  ) {
+		FOR(vector_tpl<convoihandle_t>, const cnv, welt->convoys()) {
+			for(  uint8 i = 0;  i < cnv->get_vehikel_anzahl();  i++  ) {
+				calc_vehicle_pixel( cnv->get_vehikel(i)->get_pos().get_2d() );
 			}
 		}
 	}
@@ -996,6 +1223,31 @@ void reliefkarte_t::calc_map()
 }
 
 
+// redraws the visible part from the layer of the current mode
+void reliefkarte_t::draw_map()
+{
+	// only use bitmap size like screen size
+	koord relief_size( min( get_groesse().x, new_size.x ), min( get_groesse().y, new_size.y ) );
+	// actually the following line should reduce new/deletes, but does not work properly
+	if(  relief==NULL  ||  (sint16)relief->get_width()!=relief_size.x  ||  (sint16)relief->get_height()!=relief_size.y  ) {
+		delete relief;
+		relief = new array2d_tpl<unsigned char> (relief_size.x,relief_size.y);
+	}
+	cur_off = new_off;
+	cur_size = new_size;
+	needs_redraw = false;
+	is_visible = true;
+
+	layer = get_layer( (MAP_MODES)(mode & ~MAP_MODE_FLAGS) );
+
+	if(isometric) {
+		relief->init( COL_BLACK );
+	}
+	draw_layer_rows( 0, welt->get_size().y );
+	draw_overlays();
+}
+
+
 reliefkarte_t::reliefkarte_t()
 {
 	relief = NULL;
@@ -1006,6 +1258,16 @@ reliefkarte_t::reliefkarte_t()
 	city = NULL;
 	cur_off = new_off = cur_size = new_size = koord(0,0);
 	needs_redraw = true;
+	for(  int i = 0;  i < MAX_MAP_LAYERS;  i++  ) {
+		layers[i].colors = NULL;
+		layers[i].done_rows = 0;
+		layers[i].max_rows = 0;
+		layers[i].maximum = 1;
+		layers[i].last_used = 0;
+	}
+	layer = NULL;
+	layer_counter = 0;
+	layers_outdated = false;
 }
 
 
@@ -1014,6 +1276,9 @@ reliefkarte_t::~reliefkarte_t()
 	if(relief != NULL) {
 		delete relief;
 	}
+	for(  int i = 0;  i < MAX_MAP_LAYERS;  i++  ) {
+		delete layers[i].colors;
+	}
 }
 
 
@@ -1033,6 +1298,13 @@ void reliefkarte_t::set_welt(karte_t *welt)
 		delete relief;
 		relief = NULL;
 	}
+	for(  int i = 0;  i < MAX_MAP_LAYERS;  i++  ) {
+		delete layers[i].colors;
+		layers[i].colors = NULL;
+		layers[i].changed.clear();
+	}
+	layer = NULL;
+	layers_outdated = false;
 	needs_redraw = true;
 	is_visible = false;
 
@@ -1055,6 +1327,8 @@ void reliefkarte_t::set_mode(MAP_MODES new_mode)
 
 void reliefkarte_t::neuer_monat()
 {
+	// the statistics changed
+	invalidate_layers();
 	needs_redraw = true;
 }
 
@@ -1171,9 +1445,26 @@ void reliefkarte_t::zeichnen(koord pos)
 		last_mode = mode;
 	}
 
+	if(  layers_outdated  ) {
+		invalidate_layers();
+		layers_outdated = false;
+		needs_redraw = true;
+	}
+
 	if(  needs_redraw  ||  cur_off!=new_off  ||  cur_size!=new_size  ) {
-		calc_map();
-		needs_redraw = false;
+		draw_map();
+	}
+	else if(  layer  &&  layer->done_rows < welt->get_size().y  ) {
+		// calculate the layer some rows at a time, so the game does not stop
+#if MULTI_THREAD>1
+		const sint32 tiles = LAYER_TILES_PER_THREAD * MULTI_THREAD;
+#else
+		const sint32 tiles = LAYER_TILES_PER_THREAD;
+#endif
+		const sint16 y_start = layer->done_rows;
+		calc_layer( layer, (sint16)max( (sint32)1, min( (sint32)welt->get_size().y, tiles / welt->get_size().x ) ) );
+		draw_layer_rows( y_start, layer->done_rows );
+		draw_overlays();
 	}
 
 	if(relief==NULL) {
@@ -1184,7 +1475,7 @@ void reliefkarte_t::zeichnen(koord pos)
 		const unsigned long current_pax_destinations = city->get_pax_destinations_new_change();
 		if(  pax_destinations_last_change > current_pax_destinations  ) {
 			// new month started.
-			calc_map();
+			draw_map();
 		}
 		else if(  pax_destinations_last_change < current_pax_destinations  ) {
 			// new pax_dest in city.
@@ -1739,7 +2030,7 @@ void reliefkarte_t::set_city( const stadt_t* _city )
 		if(  _city  ) {
 			pax_destinations_last_change = _city->get_pax_destinations_new_change();
 		}
-		calc_map();
+		needs_redraw = true;
 	}
 }
 
@@ -21,6 +21,9 @@ class loadsave_t;
 
 #define MAX_SEVERITY_COLORS 10
 #define MAX_MAP_ZOOM 4
+
+// the number of map modes whose colours are kept
+#define MAX_MAP_LAYERS 4
 // set to zero to use the small font
 #define ALWAYS_LARGE 1
 
@@ -77,6 +80,58 @@ private:
 
 	void set_relief_farbe_area(koord k, int areasize, uint8 color);
 
+	/**
+	 * The colours of all tiles of the world in one map mode (without vehicles).
+	 * Changed tiles are updated via calc_map_pixel(), so scrolling, zooming
+	 * and switching back to a mode only redraw from here.
+	 */
+	struct map_layer_t {
+		MAP_MODES mode;
+		array2d_tpl<uint8> *colors;
+		// the rows from here on must be (re)calculated
+		sint16 done_rows;
+		// before row 0, the rows searched so far for the maximum of the severity colors
+		sint16 max_rows;
+		sint32 maximum;
+		// tiles changed while another layer was shown
+		vector_tpl<koord> changed;
+		uint32 last_used;
+	};
+
+	map_layer_t layers[MAX_MAP_LAYERS];
+
+	// the layer of the current mode
+	map_layer_t *layer;
+	uint32 layer_counter;
+
+	// true, if changes were missed while the map was not visible
+	bool layers_outdated;
+
+	// rows of a layer shared by several threads
+	struct layer_job_t {
+		const reliefkarte_t *karte;
+		map_layer_t *layer;
+		sint16 next_row, end_row;
+		// only find the maximum for the severity colors
+		bool maximum_only;
+		sint32 maximum;
+	};
+
+	static void calc_layer_rows(void *job, int);
+	void run_layer_job(layer_job_t &job);
+
+	map_layer_t *get_layer(MAP_MODES layer_mode);
+	void invalidate_layers();
+
+	// calculates some more rows of this layer
+	void calc_layer(map_layer_t *l, sint16 rows);
+	uint8 calc_tile_color(koord k, MAP_MODES layer_mode, bool update_maximum) const;
+
+	// redraw from the current layer
+	void draw_map();
+	void draw_layer_rows(sint16 y_start, sint16 y_end);
+	void draw_overlays();
+
 	// all stuff connected with schedule display
 	class line_segment_t
 	{
@@ -211,6 +266,10 @@ public:
 	// update color with render mode (but few are ignored ... )
 	void calc_map_pixel(const koord k);
 
+	// a convoi entered or left this tile
+	void calc_vehicle_pixel(const koord k);
+
+	// everything may have changed: recalculate all tiles
 	void calc_map();
 
 	// calculates the current size of the map (but do nopt change anything else)
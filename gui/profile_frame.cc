@@ -0,0 +1,45 @@
+/*
+ * This file is part of the Simutrans project under the artistic license.
+ * (see license.txt)
+ */
+
+#include "profile_frame.h"
+#include "../simprofile.h"
+#include "../simgraph.h"
+#include "../path_explorer.h"
+#include "../dataobj/translator.h"
+
+
+profile_frame_t::profile_frame_t() :
+	gui_frame_t( translator::translate("Profiling") ),
+	txt_info(&buf)
+{
+	update_info();
+	txt_info.set_pos( koord(D_MARGIN_LEFT, D_MARGIN_TOP) );
+	add_komponente( &txt_info );
+
+	set_fenstergroesse( txt_info.get_groesse() + koord(D_MARGIN_LEFT + D_MARGIN_RIGHT, D_TITLEBAR_HEIGHT + D_MARGIN_TOP + D_MARGIN_BOTTOM) );
+}
+
+
+void profile_frame_t::update_info()
+{
+	buf.clear();
+	profiler::print( buf );
+
+	uint64 hits, misses;
+	size_t bytes;
+	display_get_image_cache_stats( hits, misses, bytes );
+	buf.printf( "\nImage cache: %u KB, %llu hits, %llu misses\n", (unsigned)(bytes >> 10), hits, misses );
+
+	buf.append( "\n" );
+	path_explorer_t::print_memory_usage( buf );
+	txt_info.recalc_size();
+}
+
+
+void profile_frame_t::zeichnen( koord pos, koord gr )
+{
+	update_info();
+	gui_frame_t::zeichnen( pos, gr );
+}
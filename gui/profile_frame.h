@@ -0,0 +1,35 @@
+/*
+ * This file is part of the Simutrans project under the artistic license.
+ * (see license.txt)
+ */
+
+#ifndef gui_profile_frame_h
+#define gui_profile_frame_h
+
+#include "gui_frame.h"
+#include "components/gui_textarea.h"
+#include "../utils/cbuffer_t.h"
+
+
+/**
+ * Debug window with the recent times of the simulation phases
+ * (see simprofile.h)
+ */
+class profile_frame_t : public gui_frame_t
+{
+private:
+	cbuffer_t buf;
+	gui_textarea_t txt_info;
+
+	void update_info();
+
+public:
+	profile_frame_t();
+
+	const char * get_hilfe_datei() const { return NULL; }
+
+	// refreshes the times before drawing
+	void zeichnen( koord pos, koord gr );
+};
+
+#endif
@@ -5,6 +5,8 @@
  */
 
 
+#include <string.h>
+
 #include "path_explorer.h"
 
 #include "tpl/slist_tpl.h"
@@ -18,6 +20,8 @@
 #include "dataobj/fahrplan.h"
 #include "simconvoi.h"
 #include "simloadingscreen.h"
+#include "utils/simthread.h"
+#include "utils/cbuffer_t.h"
 
 typedef quickstone_hashtable_tpl<haltestelle_t, haltestelle_t::connexion*> connexions_map_single_remote;
 
@@ -105,6 +109,33 @@ void path_explorer_t::step()
 }
 
 
+uint32 path_explorer_t::get_memory_usage()
+{
+	uint32 bytes = 0;
+	for (uint8 c = 0; c < max_categories; ++c)
+	{
+		bytes += goods_compartment[c].get_memory_usage();
+	}
+	return bytes;
+}
+
+
+void path_explorer_t::print_memory_usage(cbuffer_t &buf)
+{
+	buf.append( "Path explorer memory:\n" );
+	for (uint8 c = 0; c < max_categories; ++c)
+	{
+		if ( c != category_empty )
+		{
+			compartment_t &compartment = goods_compartment[c];
+			buf.printf( "%-20s %5u halts %8u KB\n", translator::translate( compartment.get_category_name() ), compartment.get_halt_count(), compartment.get_memory_usage() >> 10 );
+		}
+	}
+	buf.printf( "%-20s %5s       %8u KB\n", "working matrices", "", compartment_t::get_matrix_memory_usage() >> 10 );
+	buf.printf( "%-20s %5s       %8u KB\n", "total", "", ( get_memory_usage() + compartment_t::get_matrix_memory_usage() ) >> 10 );
+}
+
+
 void path_explorer_t::full_instant_refresh()
 {
 	// exclude empty goods (nichts)
@@ -227,6 +258,16 @@ uint32 path_explorer_t::compartment_t::local_reroute_goods = default_reroute_goo
 
 bool path_explorer_t::compartment_t::local_limits_changed = false;
 
+uint32 path_explorer_t::compartment_t::full_explore_count = 0;
+uint32 path_explorer_t::compartment_t::incremental_explore_count = 0;
+uint64 path_explorer_t::compartment_t::explore_iterations_done = 0;
+uint64 path_explorer_t::compartment_t::explore_iterations_saved = 0;
+
+path_explorer_t::compartment_t::path_element_t *path_explorer_t::compartment_t::matrix_buffer = NULL;
+path_explorer_t::compartment_t::transport_element_t *path_explorer_t::compartment_t::transport_buffer = NULL;
+uint32 path_explorer_t::compartment_t::matrix_buffer_size = 0;
+path_explorer_t::compartment_t *path_explorer_t::compartment_t::matrix_owner = NULL;
+
 uint16 path_explorer_t::compartment_t::representative_halt_count = 0;
 uint8 path_explorer_t::compartment_t::representative_category = 0;
 
@@ -234,7 +275,8 @@ path_explorer_t::compartment_t::compartment_t()
 {
 	refresh_start_time = 0;
 
-	finished_matrix = NULL;
+	finished_paths = NULL;
+	finished_row_index = NULL;
 	finished_halt_index_map = NULL;
 	finished_halt_count = 0;
 
@@ -245,6 +287,25 @@ path_explorer_t::compartment_t::compartment_t()
 	working_halt_list = NULL;
 	working_halt_count = 0;
 
+	working_paths = NULL;
+	working_transports = NULL;
+	working_row_index = NULL;
+
+	finished_transports = NULL;
+	finished_transport_keys = NULL;
+	finished_transport_count = 0;
+	finished_transfer_list = NULL;
+	finished_transfer_count = 0;
+	finished_edges = NULL;
+
+	transport_keys = NULL;
+	transport_count = 0;
+	working_edges = NULL;
+
+	explore_iterations = 0;
+	full_explore_iterations = 0;
+	explored_incrementally = false;
+
 	all_halts_list = NULL;
 	all_halts_count = 0;
 
@@ -282,40 +343,26 @@ path_explorer_t::compartment_t::compartment_t()
 
 path_explorer_t::compartment_t::~compartment_t()
 {
-	if (finished_matrix)
+	if (finished_paths)
 	{
-		for (uint16 i = 0; i < finished_halt_count; ++i)
-		{
-			delete[] finished_matrix[i];
-		}
-		delete[] finished_matrix;
+		delete[] finished_paths;
+	}
+	if (finished_row_index)
+	{
+		delete[] finished_row_index;
 	}
 	if (finished_halt_index_map)
 	{
 		delete[] finished_halt_index_map;
 	}
+	delete_retained_paths();
 
 
-	if (working_matrix)
-	{
-		for (uint16 i = 0; i < working_halt_count; ++i)
-		{
-			delete[] working_matrix[i];
-		}
-		delete[] working_matrix;
-	}
+	release_matrix();
 	if (transport_index_map)
 	{
 		delete[] transport_index_map;
 	}
-	if (transport_matrix)
-	{
-		for (uint16 i = 0; i < working_halt_count; ++i)
-		{
-			delete[] transport_matrix[i];
-		}
-		delete[] transport_matrix;
-	}
 	if (working_halt_index_map)
 	{
 		delete[] working_halt_index_map;
@@ -324,6 +371,26 @@ path_explorer_t::compartment_t::~compartment_t()
 	{
 		delete[] working_halt_list;
 	}
+	if (working_paths)
+	{
+		delete[] working_paths;
+	}
+	if (working_transports)
+	{
+		delete[] working_transports;
+	}
+	if (working_row_index)
+	{
+		delete[] working_row_index;
+	}
+	if (transport_keys)
+	{
+		delete[] transport_keys;
+	}
+	if (working_edges)
+	{
+		delete working_edges;
+	}
 
 
 	if (all_halts_list)
@@ -345,7 +412,6 @@ path_explorer_t::compartment_t::~compartment_t()
 	{
 		delete inbound_connections;
 	}
-
 	if (outbound_connections)
 	{
 		delete outbound_connections;
@@ -359,47 +425,32 @@ void path_explorer_t::compartment_t::reset(const bool reset_finished_set)
 
 	if (reset_finished_set)
 	{
-		if (finished_matrix)
+		if (finished_paths)
 		{
-			for (uint16 i = 0; i < finished_halt_count; ++i)
-			{
-				delete[] finished_matrix[i];
-			}
-			delete[] finished_matrix;
-			finished_matrix = NULL;
+			delete[] finished_paths;
+			finished_paths = NULL;
+		}
+		if (finished_row_index)
+		{
+			delete[] finished_row_index;
+			finished_row_index = NULL;
 		}
 		if (finished_halt_index_map)
 		{
 			delete[] finished_halt_index_map;
 			finished_halt_index_map = NULL;
 		}		
+		delete_retained_paths();
 		finished_halt_count = 0;
 	}
 
 
-	if (working_matrix)
-	{
-		for (uint16 i = 0; i < working_halt_count; ++i)
-		{
-			delete[] working_matrix[i];
-		}
-		delete[] working_matrix;
-		working_matrix = NULL;
-	}
+	release_matrix();
 	if (transport_index_map)
 	{
 		delete[] transport_index_map;
 		transport_index_map = NULL;
 	}
-	if (transport_matrix)
-	{
-		for (uint16 i = 0; i < working_halt_count; ++i)
-		{
-			delete[] transport_matrix[i];
-		}
-		delete[] transport_matrix;
-		transport_matrix = NULL;
-	}
 	if (working_halt_index_map)
 	{
 		delete[] working_halt_index_map;
@@ -411,6 +462,32 @@ void path_explorer_t::compartment_t::reset(const bool reset_finished_set)
 		working_halt_list = NULL;
 	}	
 	working_halt_count = 0;
+	if (working_paths)
+	{
+		delete[] working_paths;
+		working_paths = NULL;
+	}
+	if (working_transports)
+	{
+		delete[] working_transports;
+		working_transports = NULL;
+	}
+	if (working_row_index)
+	{
+		delete[] working_row_index;
+		working_row_index = NULL;
+	}
+	if (transport_keys)
+	{
+		delete[] transport_keys;
+		transport_keys = NULL;
+	}
+	transport_count = 0;
+	if (working_edges)
+	{
+		delete working_edges;
+		working_edges = NULL;
+	}
 
 
 	if (all_halts_list)
@@ -476,12 +553,20 @@ void path_explorer_t::compartment_t::reset(const bool reset_finished_set)
 void path_explorer_t::compartment_t::initialise()
 {
 	initialise_connexion_list();
+	reset_explore_statistics();
 }
 
 
 void path_explorer_t::compartment_t::finalise()
 {
 	finalise_connexion_list();
+
+	delete[] matrix_buffer;
+	matrix_buffer = NULL;
+	delete[] transport_buffer;
+	transport_buffer = NULL;
+	matrix_buffer_size = 0;
+	matrix_owner = NULL;
 }
 
 
@@ -1169,19 +1254,8 @@ void path_explorer_t::compartment_t::step()
 			{
 				if (working_halt_count > 0)
 				{
-					// build working matrix
-					working_matrix = new path_element_t*[working_halt_count];
-					for (uint16 i = 0; i < working_halt_count; ++i)
-					{
-						working_matrix[i] = new path_element_t[working_halt_count];
-					}
-
-					// build transport matrix
-					transport_matrix = new transport_element_t*[working_halt_count];
-					for (uint16 i = 0; i < working_halt_count; ++i)
-					{
-						transport_matrix[i] = new transport_element_t[working_halt_count];
-					}
+					// build working matrix and transport matrix
+					allocate_matrix();
 
 					// build transfer list
 					transfer_list = new uint16[working_halt_count];
@@ -1328,16 +1402,12 @@ void path_explorer_t::compartment_t::step()
 				statistic_iteration = 0;
 
 				// delete immediately after use
+				// -> transport index map is still needed for identifying transports in the exploration
 				if (working_halt_list)
 				{
 					delete[] working_halt_list;
 					working_halt_list = NULL;
 				}
-				if (transport_index_map)
-				{
-					delete[] transport_index_map;
-					transport_index_map = NULL;
-				}
 
 				current_phase = phase_explore_paths;	// proceed to the next phase
 				phase_counter = 0;	// reset counter
@@ -1365,23 +1435,27 @@ void path_explorer_t::compartment_t::step()
 			printf("\t\tCurrent Step : %lu \n", step_count);
 #endif
 
-			// temporary variables
-			uint16 combined_time;
-			uint32 target_member_index;
 			uint64 iterations_processed = 0;
 
+			start = dr_time();	// start timing
+
 			// initialize only when not resuming
-			if ( via_index == 0 && origin_cluster_index == 0 && target_cluster_index == 0 && origin_member_index == 0 )
+			if ( !inbound_connections )
 			{
+				if ( prepare_explore() )
+				{
+					// the paths are repaired already
+					iterations_processed = explore_iterations;
+					via_index = transfer_count;
+				}
+
 				// build data structures for inbound/outbound connections to/from transfer halts
 				inbound_connections = new connection_t(64u, working_halt_count);
 				outbound_connections = new connection_t(64u, working_halt_count);
 			}
 
-			start = dr_time();	// start timing
-
 			// for each transfer
-			while ( via_index < transfer_count )
+			while ( via_index < transfer_count && ( !use_limits || iterations_processed < limit_explore_paths ) )
 			{
 				const uint16 via = transfer_list[via_index];
 
@@ -1402,83 +1476,55 @@ void path_explorer_t::compartment_t::step()
 
 					// should take into account the iterations above
 					iterations += (uint32)working_halt_count + ( inbound_connections->get_total_member_count() << 1 );
+					explore_iterations += working_halt_count;
 				}
 
-				// for each origin cluster
-				while ( origin_cluster_index < inbound_connections->get_cluster_count() )
+				// the origin cluster members of this transfer which fit into the iteration limit (at least one)
+				explore_slice_t slice;
+				slice.compartment = this;
+				slice.via = via;
+				skip_explored_clusters(origin_cluster_index, target_cluster_index, origin_member_index);
+				slice.origin_cluster_index = origin_cluster_index;
+				slice.target_cluster_index = target_cluster_index;
+				slice.origin_member_index = origin_member_index;
+				uint64 slice_iterations = 0;
+				while ( origin_cluster_index < inbound_connections->get_cluster_count()
+						&& ( slice_iterations == 0 || !use_limits || iterations_processed + slice_iterations < limit_explore_paths ) )
 				{
-					const connection_t::connection_cluster_t &origin_cluster = (*inbound_connections)[origin_cluster_index];
-					const uint16 inbound_transport = origin_cluster.transport;
-					const vector_tpl<uint16> &origin_halt_list = origin_cluster.connected_halts;
-
-					// for each target cluster
-					while ( target_cluster_index < outbound_connections->get_cluster_count() )
-					{
-						const connection_t::connection_cluster_t &target_cluster = (*outbound_connections)[target_cluster_index];
-						const uint16 outbound_transport = target_cluster.transport;
-						if ( inbound_transport == outbound_transport && inbound_transport != 0u )
-						{
-							++target_cluster_index;
-							continue;
-						}
-						const vector_tpl<uint16> &target_halt_list = target_cluster.connected_halts;
-
-						// for each origin cluster member
-						while ( origin_member_index < origin_halt_list.get_count() )
-						{
-							const uint16 origin = origin_halt_list[origin_member_index];
-
-							// for each target cluster member
-							for ( target_member_index = 0; target_member_index < target_halt_list.get_count(); ++target_member_index )
-							{
-								const uint16 target = target_halt_list[target_member_index];
-								
-								if ( ( combined_time = working_matrix[origin][via].aggregate_time 
-													 + working_matrix[via][target].aggregate_time ) 
-											< working_matrix[origin][target].aggregate_time			   )
-								{
-									working_matrix[origin][target].aggregate_time = combined_time;
-									working_matrix[origin][target].next_transfer = working_matrix[origin][via].next_transfer;
-									transport_matrix[origin][target].first_transport = transport_matrix[origin][via].first_transport;
-									transport_matrix[origin][target].last_transport = transport_matrix[via][target].last_transport;
-								}
-							}	// loop : target cluster member
-
-							++origin_member_index;
-
-							// iteration control
-							iterations_processed += target_halt_list.get_count();
-							if ( use_limits && iterations_processed >= limit_explore_paths )
-							{
-								goto loop_termination;
-							}
-
-						}	// loop : origin cluster member
-
-						origin_member_index = 0;
-
-						++target_cluster_index;
-
-					}	// loop : target cluster
+					slice_iterations += (*outbound_connections)[target_cluster_index].connected_halts.get_count();
+					++origin_member_index;
+					skip_explored_clusters(origin_cluster_index, target_cluster_index, origin_member_index);
+				}
+				slice.end_origin_cluster_index = origin_cluster_index;
+				slice.end_target_cluster_index = target_cluster_index;
+				slice.end_origin_member_index = origin_member_index;
+
+#if MULTI_THREAD>1
+				// large slices are shared by the helper threads; the result does not depend on their number
+				slice.parts = slice_iterations >= parallel_explore_iterations ? MULTI_THREAD : 1;
+				run_parallel( explore_paths_part, &slice, slice.parts );
+#else
+				slice.parts = 1;
+				explore_paths_part( &slice, 0 );
+#endif
+				iterations_processed += slice_iterations;
+				explore_iterations += slice_iterations;
 
+				if ( origin_cluster_index == inbound_connections->get_cluster_count() )
+				{
+					origin_cluster_index = 0;
 					target_cluster_index = 0;
+					origin_member_index = 0;
 
-					++origin_cluster_index;
-
-				}	// loop : origin cluster
+					// clear the inbound/outbound connections
+					inbound_connections->reset();
+					outbound_connections->reset();
+					process_next_transfer = true;
 
-				origin_cluster_index = 0;
-
-				// clear the inbound/outbound connections
-				inbound_connections->reset();
-				outbound_connections->reset();
-				process_next_transfer = true;
-
-				++via_index;
+					++via_index;
+				}
 			}	// loop : transfer
 
-		loop_termination :
-
 			diff = dr_time() - start;	// stop timing
 
 			// iterations statistics collection
@@ -1493,107 +1539,128 @@ void path_explorer_t::compartment_t::step()
 			printf("\t\t\tPath searching -> %lu iterations takes :  %lu ms \n", static_cast<unsigned long>(iterations_processed), diff);
 #endif
 
-			if (via_index == transfer_count)
+			if ( via_index < transfer_count )
 			{
-				// iteration limit adjustment
-				if ( catg == representative_category )
+				// resume in the next step
+				return;
+			}
+
+			// iteration limit adjustment
+			if ( catg == representative_category )
+			{
+				const uint64 projected_iterations = static_cast<uint64>( statistic_iteration / statistic_duration ) * static_cast<uint64>( time_midpoint );
+				if ( projected_iterations > 0 )
 				{
-					const uint64 projected_iterations = static_cast<uint64>( statistic_iteration / statistic_duration ) * static_cast<uint64>( time_midpoint );
-					if ( projected_iterations > 0 )
+					if ( umgebung_t::networkmode )
 					{
-						if ( umgebung_t::networkmode )
+						const uint32 percentage = static_cast<uint32>( projected_iterations * 100 / local_explore_paths );
+						if ( percentage < percent_lower_limit || percentage > percent_upper_limit )
 						{
-							const uint32 percentage = static_cast<uint32>( projected_iterations * 100 / local_explore_paths );
-							if ( percentage < percent_lower_limit || percentage > percent_upper_limit )
-							{
-								local_explore_paths = projected_iterations;
-								local_limits_changed = true;
-							}
+							local_explore_paths = projected_iterations;
+							local_limits_changed = true;
 						}
-						else
+					}
+					else
+					{
+						const uint32 percentage = static_cast<uint32>( projected_iterations * 100 / limit_explore_paths );
+						if ( percentage < percent_lower_limit || percentage > percent_upper_limit )
 						{
-							const uint32 percentage = static_cast<uint32>( projected_iterations * 100 / limit_explore_paths );
-							if ( percentage < percent_lower_limit || percentage > percent_upper_limit )
-							{
-								limit_explore_paths = projected_iterations;
-							}
+							limit_explore_paths = projected_iterations;
 						}
 					}
 				}
+			}
 
-				// reset statistic variables
-				statistic_duration = 0;
-				statistic_iteration = 0;
+			// reset statistic variables
+			statistic_duration = 0;
+			statistic_iteration = 0;
 
+			delete inbound_connections;
+			inbound_connections = NULL;
+			delete outbound_connections;
+			outbound_connections = NULL;
+			process_next_transfer = true;
+			via_index = 0;
 
-				// path search completed -> delete old path info
-				if (finished_matrix)
-				{
-					for (uint16 i = 0; i < finished_halt_count; ++i)
-					{
-						delete[] finished_matrix[i];
-					}
-					delete[] finished_matrix;
-					finished_matrix = NULL;	
-				}											
-				if (finished_halt_index_map)
+			if ( !explored_incrementally )
+			{
+				full_explore_iterations = explore_iterations;
+				compact_paths();
+			}
+
+			// statistics collection
+			if ( explored_incrementally )
+			{
+				++incremental_explore_count;
+				if ( full_explore_iterations > explore_iterations )
 				{
-					delete[] finished_halt_index_map;
-					finished_halt_index_map = NULL;
+					explore_iterations_saved += full_explore_iterations - explore_iterations;
 				}
+			}
+			else
+			{
+				++full_explore_count;
+			}
+			explore_iterations_done += explore_iterations;
 
-				// transfer working to finished
-				finished_matrix = working_matrix;
-				working_matrix = NULL;
-				finished_halt_index_map = working_halt_index_map;
-				working_halt_index_map = NULL;
-				finished_halt_count = working_halt_count;
-				// working_halt_count is reset below after deleting transport matrix								
+			// path search completed -> delete old path info
+			delete_retained_paths();
+			if (finished_paths)
+			{
+				delete[] finished_paths;
+				finished_paths = NULL;
+			}
+			if (finished_row_index)
+			{
+				delete[] finished_row_index;
+				finished_row_index = NULL;
+			}
+			if (finished_halt_index_map)
+			{
+				delete[] finished_halt_index_map;
+				finished_halt_index_map = NULL;
+			}
 
-				// path search completed -> delete auxilliary data structures
-				if (transport_matrix)
-				{
-					for (uint16 i = 0; i < working_halt_count; ++i)
-					{
-						delete[] transport_matrix[i];
-					}
-					delete[] transport_matrix;
-					transport_matrix = NULL;
-				}
-				working_halt_count = 0;
-				if (transfer_list)
-				{
-					delete[] transfer_list;
-					transfer_list = NULL;
-				}
-				transfer_count = 0;
+			// transfer working to finished -> the working matrices have already been compacted and freed
+			finished_paths = working_paths;
+			working_paths = NULL;
+			finished_row_index = working_row_index;
+			working_row_index = NULL;
+			finished_halt_index_map = working_halt_index_map;
+			working_halt_index_map = NULL;
+			finished_halt_count = working_halt_count;
+			working_halt_count = 0;
+
+			// path search completed -> retain auxilliary data structures for incremental updates
+			finished_transports = working_transports;
+			working_transports = NULL;
+			finished_transport_keys = transport_keys;
+			transport_keys = NULL;
+			finished_transport_count = transport_count;
+			transport_count = 0;
+			finished_transfer_list = transfer_list;
+			transfer_list = NULL;
+			finished_transfer_count = transfer_count;
+			transfer_count = 0;
+			finished_edges = working_edges;
+			working_edges = NULL;
+
+			if (transport_index_map)
+			{
+				delete[] transport_index_map;
+				transport_index_map = NULL;
+			}
 
-				if (inbound_connections)
-				{
-					delete inbound_connections;
-					inbound_connections = NULL;
-				}
-				if (outbound_connections)
-				{
-					delete outbound_connections;
-					outbound_connections = NULL;
-				}
-				process_next_transfer = true;
+			DBG_MESSAGE("compartment_t::step()", "%s paths explored %s: %u halts, %u bytes", get_category_name(),
+				explored_incrementally ? "incrementally" : "fully", finished_halt_count, get_memory_usage());
 
-				// Debug paths : to execute, working_halt_list should not be deleted in the previous phase
-				// enumerate_all_paths(finished_matrix, working_halt_list, finished_halt_index_map, finished_halt_count);
+			current_phase = phase_reroute_goods;	// proceed to the next phase
 
-				current_phase = phase_reroute_goods;	// proceed to the next phase
+			paths_available = true;
 
-				// reset counters
-				via_index = 0;
-				origin_cluster_index = 0;
-				target_cluster_index = 0;
-				origin_member_index = 0;
+			// Debug paths : to execute, working_halt_list should not be deleted in the previous phase
+			// enumerate_all_paths(working_halt_list, finished_halt_count);
 
-				paths_available = true;
-			}
-			
 			return;
 		}
 
@@ -1715,11 +1782,410 @@ void path_explorer_t::compartment_t::step()
 }
 
 
-void path_explorer_t::compartment_t::enumerate_all_paths(const path_element_t *const *const matrix, const halthandle_t *const halt_list, 
-														 const uint16 *const halt_map, const uint16 halt_count)
+bool path_explorer_t::compartment_t::prepare_explore()
+{
+	// identify the transports of the transport indices
+	transport_count = 0;
+	if (transport_index_map)
+	{
+		for (uint32 i = 0; i < 131072; ++i)
+		{
+			if ( transport_index_map[i] > transport_count )
+			{
+				transport_count = transport_index_map[i];
+			}
+		}
+	}
+	transport_keys = new uint32[transport_count + 1u];
+	transport_keys[0] = 0;	// walking
+	if (transport_index_map)
+	{
+		for (uint32 i = 0; i < 131072; ++i)
+		{
+			if ( transport_index_map[i] )
+			{
+				transport_keys[ transport_index_map[i] ] = i;
+			}
+		}
+	}
+
+	// record the direct connections before they are combined into paths
+	working_edges = new vector_tpl<path_edge_t>(working_halt_count * 4u);
+	path_edge_t edge;
+	for ( uint16 origin = 0; origin < working_halt_count; ++origin )
+	{
+		for ( uint16 target = 0; target < working_halt_count; ++target )
+		{
+			if ( working_matrix[origin][target].aggregate_time != 65535 && origin != target )
+			{
+				edge.origin = origin;
+				edge.target = target;
+				edge.aggregate_time = working_matrix[origin][target].aggregate_time;
+				edge.transport_key = transport_keys[ transport_matrix[origin][target].first_transport ];
+				edge.target_halt = working_matrix[origin][target].next_transfer;
+				working_edges->append(edge);
+			}
+		}
+	}
+
+	explore_iterations = (uint64)working_halt_count * (uint64)working_halt_count;
+
+	explored_incrementally = update_paths();
+	if ( explored_incrementally )
+	{
+		compact_paths();
+	}
+	return explored_incrementally;
+}
+
+
+// moves the position around the current transfer to the next origin cluster member to process, skipping pairs
+// of clusters with the same transport; after the last one origin_cluster_index is the number of origin clusters
+void path_explorer_t::compartment_t::skip_explored_clusters(uint32 &origin_cluster, uint32 &target_cluster, uint32 &origin_member) const
+{
+	while ( origin_cluster < inbound_connections->get_cluster_count() )
+	{
+		const connection_t::connection_cluster_t &current_origin_cluster = (*inbound_connections)[origin_cluster];
+		while ( target_cluster < outbound_connections->get_cluster_count() )
+		{
+			const uint16 outbound_transport = (*outbound_connections)[target_cluster].transport;
+			if ( origin_member < current_origin_cluster.connected_halts.get_count()
+				 && ( current_origin_cluster.transport != outbound_transport || outbound_transport == 0u ) )
+			{
+				return;
+			}
+			origin_member = 0;
+			++target_cluster;
+		}
+		target_cluster = 0;
+		++origin_cluster;
+	}
+}
+
+
+// explores the paths of the slice through its transfer; the part nr only takes the origins with origin % parts == nr,
+// so that each row of the matrices is written by one part, and the row of the transfer itself is not written at all
+void path_explorer_t::compartment_t::explore_paths_part(void *args, int nr)
+{
+	const explore_slice_t &slice = *(const explore_slice_t *)args;
+	compartment_t &compartment = *slice.compartment;
+	path_element_t **const working_matrix = compartment.working_matrix;
+	transport_element_t **const transport_matrix = compartment.transport_matrix;
+	const uint16 via = slice.via;
+
+	// temporary variables
+	uint16 combined_time;
+	uint32 target_member_index;
+
+	uint32 origin_cluster_index = slice.origin_cluster_index;
+	uint32 target_cluster_index = slice.target_cluster_index;
+	uint32 origin_member_index = slice.origin_member_index;
+	while ( origin_cluster_index != slice.end_origin_cluster_index || target_cluster_index != slice.end_target_cluster_index
+			|| origin_member_index != slice.end_origin_member_index )
+	{
+		const uint16 origin = (*compartment.inbound_connections)[origin_cluster_index].connected_halts[origin_member_index];
+		if ( origin % slice.parts == nr )
+		{
+			const vector_tpl<uint16> &target_halt_list = (*compartment.outbound_connections)[target_cluster_index].connected_halts;
+
+			// for each target cluster member
+			for ( target_member_index = 0; target_member_index < target_halt_list.get_count(); ++target_member_index )
+			{
+				const uint16 target = target_halt_list[target_member_index];
+
+				if ( ( combined_time = working_matrix[origin][via].aggregate_time 
+									 + working_matrix[via][target].aggregate_time ) 
+							< working_matrix[origin][target].aggregate_time			   )
+				{
+					working_matrix[origin][target].aggregate_time = combined_time;
+					working_matrix[origin][target].next_transfer = working_matrix[origin][via].next_transfer;
+					transport_matrix[origin][target].first_transport = transport_matrix[origin][via].first_transport;
+					transport_matrix[origin][target].last_transport = transport_matrix[via][target].last_transport;
+				}
+			}	// loop : target cluster member
+		}
+
+		++origin_member_index;
+		compartment.skip_explored_clusters(origin_cluster_index, target_cluster_index, origin_member_index);
+	}
+}
+
+
+bool path_explorer_t::compartment_t::update_paths()
+{
+	// the last exploration must have been done on the same halts and transfers
+	if ( !finished_paths || !finished_edges || !finished_transports || finished_halt_count != working_halt_count
+		 || finished_transfer_count != transfer_count || working_halt_count == 0 )
+	{
+		return false;
+	}
+	if ( memcmp( finished_halt_index_map, working_halt_index_map, 65536 * sizeof(uint16) ) != 0
+		 || memcmp( finished_transfer_list, transfer_list, transfer_count * sizeof(uint16) ) != 0 )
+	{
+		return false;
+	}
+
+	// compare the connections -> both edge lists are sorted by origin and then target
+	vector_tpl<path_edge_t> changed_edges(64u);
+	uint32 o = 0;
+	FOR(vector_tpl<path_edge_t>, const& edge, *working_edges)
+	{
+		if ( o < finished_edges->get_count()
+			 && ( (*finished_edges)[o].origin < edge.origin
+				  || ( (*finished_edges)[o].origin == edge.origin && (*finished_edges)[o].target < edge.target ) ) )
+		{
+			// connection removed -> paths may become longer, which cannot be repaired
+			return false;
+		}
+		if ( o < finished_edges->get_count() && (*finished_edges)[o].origin == edge.origin && (*finished_edges)[o].target == edge.target )
+		{
+			const path_edge_t &old_edge = (*finished_edges)[o++];
+			if ( old_edge.transport_key != edge.transport_key || old_edge.aggregate_time < edge.aggregate_time )
+			{
+				// different transport or slower connection
+				return false;
+			}
+			if ( old_edge.aggregate_time == edge.aggregate_time )
+			{
+				continue;
+			}
+		}
+		changed_edges.append(edge);
+	}
+	if ( o < finished_edges->get_count() )
+	{
+		return false;
+	}
+
+	// each changed connection costs up to a pass over the whole matrix -> not worth it beyond the work of a full exploration
+	const uint64 matrix_size = (uint64)working_halt_count * (uint64)working_halt_count;
+	if ( (uint64)(changed_edges.get_count() + 1u) * matrix_size >= full_explore_iterations )
+	{
+		return false;
+	}
+
+	// map transport indices of the last exploration to the current ones
+	uint16 *const transport_map = new uint16[finished_transport_count + 1u];
+	transport_map[0] = 0;
+	for ( uint16 i = 1; i <= finished_transport_count; ++i )
+	{
+		transport_map[i] = transport_index_map[ finished_transport_keys[i] ];
+	}
+
+	// start from the finished paths
+	for ( uint16 origin = 0; origin < working_halt_count; ++origin )
+	{
+		path_element_t *const path_row = working_matrix[origin];
+		transport_element_t *const transport_row = transport_matrix[origin];
+		for ( uint16 target = 0; target < working_halt_count; ++target )
+		{
+			path_row[target] = path_element_t();
+			transport_row[target] = transport_element_t();
+		}
+		path_row[origin].aggregate_time = 0;
+
+		for ( uint32 e = finished_row_index[origin]; e < finished_row_index[origin + 1u]; ++e )
+		{
+			const path_entry_t &old_path = finished_paths[e];
+			const transport_element_t &old_transport = finished_transports[e];
+			if ( ( old_transport.first_transport && !transport_map[old_transport.first_transport] )
+				 || ( old_transport.last_transport && !transport_map[old_transport.last_transport] ) )
+			{
+				// a path uses a transport which no longer exists
+				delete[] transport_map;
+				return false;
+			}
+			path_row[old_path.target].aggregate_time = old_path.aggregate_time;
+			path_row[old_path.target].next_transfer = old_path.next_transfer;
+			transport_row[old_path.target].first_transport = transport_map[old_transport.first_transport];
+			transport_row[old_path.target].last_transport = transport_map[old_transport.last_transport];
+		}
+	}
+	delete[] transport_map;
+
+	// only transfers can be in the middle of a path
+	bool *const is_transfer = new bool[working_halt_count]();
+	for ( uint16 i = 0; i < transfer_count; ++i )
+	{
+		is_transfer[ transfer_list[i] ] = true;
+	}
+
+	// for each changed connection, try to improve every path by passing through it
+	FOR(vector_tpl<path_edge_t>, const& edge, changed_edges)
+	{
+		const uint16 u = edge.origin;
+		const uint16 v = edge.target;
+		const uint16 transport = transport_index_map[edge.transport_key];
+
+		for ( uint16 origin = 0; origin < working_halt_count; ++origin )
+		{
+			if ( origin != u && ( !is_transfer[u] || working_matrix[origin][u].aggregate_time == 65535
+								  || ( transport_matrix[origin][u].last_transport == transport && transport != 0u ) ) )
+			{
+				continue;
+			}
+			const uint32 origin_time = ( origin == u ? 0 : working_matrix[origin][u].aggregate_time ) + edge.aggregate_time;
+
+			for ( uint16 target = 0; target < working_halt_count; ++target )
+			{
+				if ( target == origin
+					 || ( target != v && ( !is_transfer[v] || working_matrix[v][target].aggregate_time == 65535
+										   || ( transport_matrix[v][target].first_transport == transport && transport != 0u ) ) ) )
+				{
+					continue;
+				}
+				const uint32 combined_time = origin_time + ( target == v ? 0 : working_matrix[v][target].aggregate_time );
+				if ( combined_time < working_matrix[origin][target].aggregate_time )
+				{
+					working_matrix[origin][target].aggregate_time = (uint16)combined_time;
+					working_matrix[origin][target].next_transfer = ( origin == u ? edge.target_halt : working_matrix[origin][u].next_transfer );
+					transport_matrix[origin][target].first_transport = ( origin == u ? transport : transport_matrix[origin][u].first_transport );
+					transport_matrix[origin][target].last_transport = ( target == v ? transport : transport_matrix[v][target].last_transport );
+				}
+			}
+			explore_iterations += working_halt_count;
+		}
+	}
+	delete[] is_transfer;
+
+	return true;
+}
+
+
+void path_explorer_t::compartment_t::compact_paths()
+{
+	// count the reachable targets
+	working_row_index = new uint32[working_halt_count + 1u];
+	uint32 path_count = 0;
+	for ( uint16 origin = 0; origin < working_halt_count; ++origin )
+	{
+		working_row_index[origin] = path_count;
+		for ( uint16 target = 0; target < working_halt_count; ++target )
+		{
+			if ( working_matrix[origin][target].next_transfer.is_bound() )
+			{
+				++path_count;
+			}
+		}
+	}
+	working_row_index[working_halt_count] = path_count;
+
+	// copy them into the compact rows
+	working_paths = new path_entry_t[path_count];
+	working_transports = new transport_element_t[path_count];
+	uint32 e = 0;
+	for ( uint16 origin = 0; origin < working_halt_count; ++origin )
+	{
+		for ( uint16 target = 0; target < working_halt_count; ++target )
+		{
+			if ( working_matrix[origin][target].next_transfer.is_bound() )
+			{
+				working_paths[e].target = target;
+				working_paths[e].aggregate_time = working_matrix[origin][target].aggregate_time;
+				working_paths[e].next_transfer = working_matrix[origin][target].next_transfer;
+				working_transports[e] = transport_matrix[origin][target];
+				++e;
+			}
+		}
+	}
+	release_matrix();
+}
+
+
+void path_explorer_t::compartment_t::allocate_matrix()
+{
+	if ( matrix_owner && matrix_owner != this )
+	{
+		// cannot happen as the categories are refreshed one after another, but never share the buffer
+		dbg->warning("path_explorer_t::compartment_t::allocate_matrix()", "restarting the refresh of %s", matrix_owner->get_category_name());
+		matrix_owner->reset(false);
+	}
+	release_matrix();
+
+	// enlarge the buffers, or shrink them if they are much larger than needed
+	const uint32 size = (uint32)working_halt_count * (uint32)working_halt_count;
+	if ( size > matrix_buffer_size || size < matrix_buffer_size / 4u )
+	{
+		delete[] matrix_buffer;
+		delete[] transport_buffer;
+		matrix_buffer = new path_element_t[size];
+		transport_buffer = new transport_element_t[size];
+		matrix_buffer_size = size;
+	}
+	else
+	{
+		// clear the part in use from the last refresh
+		const path_element_t empty_path;
+		const transport_element_t empty_transport;
+		for ( uint32 i = 0; i < size; ++i )
+		{
+			matrix_buffer[i] = empty_path;
+			transport_buffer[i] = empty_transport;
+		}
+	}
+
+	working_matrix = new path_element_t*[working_halt_count];
+	transport_matrix = new transport_element_t*[working_halt_count];
+	for ( uint16 i = 0; i < working_halt_count; ++i )
+	{
+		working_matrix[i] = matrix_buffer + (uint32)i * working_halt_count;
+		transport_matrix[i] = transport_buffer + (uint32)i * working_halt_count;
+	}
+	matrix_owner = this;
+}
+
+
+void path_explorer_t::compartment_t::release_matrix()
+{
+	if (working_matrix)
+	{
+		delete[] working_matrix;
+		working_matrix = NULL;
+	}
+	if (transport_matrix)
+	{
+		delete[] transport_matrix;
+		transport_matrix = NULL;
+	}
+	if ( matrix_owner == this )
+	{
+		matrix_owner = NULL;
+	}
+}
+
+
+void path_explorer_t::compartment_t::delete_retained_paths()
+{
+	if (finished_transports)
+	{
+		delete[] finished_transports;
+		finished_transports = NULL;
+	}
+	if (finished_transport_keys)
+	{
+		delete[] finished_transport_keys;
+		finished_transport_keys = NULL;
+	}
+	finished_transport_count = 0;
+	if (finished_transfer_list)
+	{
+		delete[] finished_transfer_list;
+		finished_transfer_list = NULL;
+	}
+	finished_transfer_count = 0;
+	if (finished_edges)
+	{
+		delete finished_edges;
+		finished_edges = NULL;
+	}
+}
+
+
+void path_explorer_t::compartment_t::enumerate_all_paths(const halthandle_t *const halt_list, const uint16 halt_count)
 {
 	// Debugging code : Enumerate all paths for validation
 	halthandle_t transfer_halt;
+	uint16 aggregate_time;
 
 	for (uint16 x = 0; x < halt_count; ++x)
 	{
@@ -1729,10 +2195,8 @@ void path_explorer_t::compartment_t::enumerate_all_paths(const path_element_t *c
 			{
 				// print origin
 				printf("\n\nOrigin :  %s\n", halt_list[x]->get_name());
-				
-				transfer_halt = matrix[x][y].next_transfer;
 
-				if (matrix[x][y].aggregate_time == 65535)
+				if ( !get_path_between(halt_list[x], halt_list[y], aggregate_time, transfer_halt) )
 				{
 					printf("\t\t\t\t******** No Route ********\n");
 				}
@@ -1742,11 +2206,7 @@ void path_explorer_t::compartment_t::enumerate_all_paths(const path_element_t *c
 					{
 						printf("\t\t\t\t%s\n", transfer_halt->get_name());
 
-						if ( halt_map[transfer_halt.get_id()] != 65535 )
-						{
-							transfer_halt = matrix[ halt_map[transfer_halt.get_id()] ][y].next_transfer;
-						}
-						else
+						if ( !get_path_between(transfer_halt, halt_list[y], aggregate_time, transfer_halt) )
 						{
 							printf("\t\t\t\tError!!!");
 							break;
@@ -1767,15 +2227,35 @@ bool path_explorer_t::compartment_t::get_path_between(const halthandle_t origin_
 {
 	uint32 origin_index, target_index;
 	
-	// check if origin and target halts are both present in matrix; if yes, check the validity of the next transfer
+	// check if origin and target halts are both present in matrix
 	if ( paths_available && origin_halt.is_bound() && target_halt.is_bound()
 			&& ( origin_index = finished_halt_index_map[ origin_halt.get_id() ] ) != 65535
-			&& ( target_index = finished_halt_index_map[ target_halt.get_id() ] ) != 65535
-			&& finished_matrix[origin_index][target_index].next_transfer.is_bound() )
+			&& ( target_index = finished_halt_index_map[ target_halt.get_id() ] ) != 65535 )
 	{
-		aggregate_time = finished_matrix[origin_index][target_index].aggregate_time;
-		next_transfer = finished_matrix[origin_index][target_index].next_transfer;
-		return true;
+		// binary search for the target in the row of the origin
+		uint32 low = finished_row_index[origin_index];
+		uint32 high = finished_row_index[origin_index + 1u];
+		while ( low < high )
+		{
+			const uint32 mid = ( low + high ) >> 1;
+			if ( finished_paths[mid].target < target_index )
+			{
+				low = mid + 1u;
+			}
+			else
+			{
+				high = mid;
+			}
+		}
+
+		// if found, check the validity of the next transfer
+		if ( low < finished_row_index[origin_index + 1u] && finished_paths[low].target == target_index
+				&& finished_paths[low].next_transfer.is_bound() )
+		{
+			aggregate_time = finished_paths[low].aggregate_time;
+			next_transfer = finished_paths[low].next_transfer;
+			return true;
+		}
 	}
 
 	// requested path not found
@@ -1785,6 +2265,31 @@ bool path_explorer_t::compartment_t::get_path_between(const halthandle_t origin_
 }
 
 
+uint32 path_explorer_t::compartment_t::get_memory_usage() const
+{
+	uint32 bytes = 0;
+	if (finished_row_index)
+	{
+		const uint32 path_count = finished_row_index[finished_halt_count];
+		bytes += ( finished_halt_count + 1u ) * sizeof(uint32) + path_count * ( sizeof(path_entry_t) + sizeof(transport_element_t) );
+	}
+	if (finished_halt_index_map)
+	{
+		bytes += 65536 * sizeof(uint16);
+	}
+	bytes += finished_transfer_count * sizeof(uint16);
+	if (finished_transport_keys)
+	{
+		bytes += ( finished_transport_count + 1u ) * sizeof(uint32);
+	}
+	if (finished_edges)
+	{
+		bytes += finished_edges->get_count() * sizeof(path_edge_t);
+	}
+	return bytes;
+}
+
+
 void path_explorer_t::compartment_t::set_category(uint8 category)
 { 
 	catg = category;
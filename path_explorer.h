@@ -21,6 +21,7 @@
 #include "tpl/vector_tpl.h"
 #include "tpl/quickstone_hashtable_tpl.h"
 
+class cbuffer_t;
 
 class path_explorer_t
 {
@@ -107,6 +108,14 @@ private:
 			path_element_t() : aggregate_time(65535u) { }
 		};
 
+		// element of the compact path rows, which only hold the reachable target halts
+		struct path_entry_t
+		{
+			uint16 target;
+			uint16 aggregate_time;
+			halthandle_t next_transfer;
+		};
+
 		// element used during path search only for storing best lines/convoys
 		struct transport_element_t
 		{
@@ -116,6 +125,16 @@ private:
 			transport_element_t() : first_transport(0), last_transport(0) { }
 		};
 
+		// direct connection between 2 halts as filled into the working matrix
+		struct path_edge_t
+		{
+			uint16 origin;
+			uint16 target;
+			uint16 aggregate_time;
+			uint32 transport_key;	// line id, or 65536 + lineless convoy id, or 0 for walking
+			halthandle_t target_halt;
+		};
+
 		// structure used for storing indices of halts connected to a transfer, grouped by transport
 		class connection_t
 		{
@@ -229,7 +248,10 @@ private:
 		unsigned long refresh_start_time;
 
 		// set of variables for finished path data
-		path_element_t **finished_matrix;
+		// -> the rows are stored one after another, each sorted by target index;
+		//    row i occupies [finished_row_index[i], finished_row_index[i+1])
+		path_entry_t *finished_paths;
+		uint32 *finished_row_index;
 		uint16 *finished_halt_index_map;
 		uint16 finished_halt_count;
 
@@ -241,6 +263,29 @@ private:
 		halthandle_t *working_halt_list;
 		uint16 working_halt_count;
 
+		// compact rows made from the working matrices at the end of the exploration
+		path_entry_t *working_paths;
+		transport_element_t *working_transports;
+		uint32 *working_row_index;
+
+		// set of variables retained from the last exploration for incremental updates
+		transport_element_t *finished_transports;	// in the same layout as finished_paths
+		uint32 *finished_transport_keys;
+		uint16 finished_transport_count;
+		uint16 *finished_transfer_list;
+		uint16 finished_transfer_count;
+		vector_tpl<path_edge_t> *finished_edges;
+
+		// set of variables for the same data of the current exploration
+		uint32 *transport_keys;
+		uint16 transport_count;
+		vector_tpl<path_edge_t> *working_edges;
+
+		// work done by the current exploration, and by the last full exploration
+		uint64 explore_iterations;
+		uint64 full_explore_iterations;
+		bool explored_incrementally;
+
 		// set of variables for full halt list
 		halthandle_t *all_halts_list;
 		uint16 all_halts_count;
@@ -289,6 +334,19 @@ private:
 		// an array for keeping a list of connexion hash table
 		static connexion_list_entry_t connexion_list[65536];
 
+		// storage of the working matrices, kept for the next refresh
+		// -> only one compartment at a time refreshes, so one buffer of the largest size is enough
+		static path_element_t *matrix_buffer;
+		static transport_element_t *transport_buffer;
+		static uint32 matrix_buffer_size;
+		static compartment_t *matrix_owner;
+
+		// statistics of incremental path exploration
+		static uint32 full_explore_count;
+		static uint32 incremental_explore_count;
+		static uint64 explore_iterations_done;
+		static uint64 explore_iterations_saved;
+
 		// iteration representative
 		static uint16 representative_halt_count;
 		static uint8 representative_category;
@@ -342,8 +400,43 @@ private:
 		static const uint32 percent_lower_limit = 100 - percent_deviation;
 		static const uint32 percent_upper_limit = 100 + percent_deviation;
 
-		void enumerate_all_paths(const path_element_t *const *const matrix, const halthandle_t *const halt_list,
-								 const uint16 *const halt_map, const uint16 halt_count);
+		// slices of the path exploration with at least this many iterations are shared by the helper threads
+		static const uint32 parallel_explore_iterations = 16384;
+
+		// the origin cluster members around a transfer explored at once, from the first position up to the end position
+		struct explore_slice_t
+		{
+			compartment_t *compartment;
+			uint16 via;
+			uint32 origin_cluster_index;
+			uint32 target_cluster_index;
+			uint32 origin_member_index;
+			uint32 end_origin_cluster_index;
+			uint32 end_target_cluster_index;
+			uint32 end_origin_member_index;
+			int parts;
+		};
+
+		// set up the path exploration; returns true if the paths of the last exploration could be repaired instead
+		bool prepare_explore();
+
+		void skip_explored_clusters(uint32 &origin_cluster, uint32 &target_cluster, uint32 &origin_member) const;
+		static void explore_paths_part(void *slice, int nr);
+
+		// repair the paths of the last exploration if connections have only been added or become faster;
+		// returns false if a full exploration is needed
+		bool update_paths();
+
+		// point the working matrices into the shared buffers, which are enlarged if needed
+		void allocate_matrix();
+		void release_matrix();
+
+		// convert the working matrices into compact rows and release them
+		void compact_paths();
+
+		void delete_retained_paths();
+
+		void enumerate_all_paths(const halthandle_t *const halt_list, const uint16 halt_count);
 
 	public:
 
@@ -365,6 +458,14 @@ private:
 		bool get_path_between(const halthandle_t origin_halt, const halthandle_t target_halt,
 							  uint16 &aggregate_time, halthandle_t &next_transfer);
 
+		// bytes used by the finished and retained path data
+		uint32 get_memory_usage() const;
+
+		// bytes of the buffers for the working matrices
+		static uint32 get_matrix_memory_usage() { return matrix_buffer_size * ( sizeof(path_element_t) + sizeof(transport_element_t) ); }
+
+		uint16 get_halt_count() const { return finished_halt_count; }
+
 		const char *get_category_name() { return ( catg_name ? catg_name : "" ); }
 		const char *get_current_phase_name() { return phase_name[current_phase]; }
 
@@ -417,6 +518,18 @@ private:
 		static uint64 get_limit_explore_paths() { return limit_explore_paths; }
 		static uint32 get_limit_reroute_goods() { return limit_reroute_goods; }
 
+		static uint32 get_full_explore_count() { return full_explore_count; }
+		static uint32 get_incremental_explore_count() { return incremental_explore_count; }
+		static uint64 get_explore_iterations_done() { return explore_iterations_done; }
+		static uint64 get_explore_iterations_saved() { return explore_iterations_saved; }
+		static void reset_explore_statistics()
+		{
+			full_explore_count = 0;
+			incremental_explore_count = 0;
+			explore_iterations_done = 0;
+			explore_iterations_saved = 0;
+		}
+
 	};
 
 	static karte_t *world;
@@ -441,6 +554,12 @@ public:
 		return goods_compartment[category].get_path_between(origin_halt, target_halt, aggregate_time, next_transfer);
 	}
 
+	static uint32 get_catg_memory_usage(const uint8 category) { return goods_compartment[category].get_memory_usage(); }
+	static uint32 get_memory_usage();
+
+	// appends the bytes used per category and by the working matrices
+	static void print_memory_usage(cbuffer_t &buf);
+
 	static karte_t *get_world() { return world; }
 	static bool are_local_limits_changed() { return compartment_t::are_local_limits_changed(); }
 	static void reset_local_limits_state() { compartment_t::reset_local_limits_state(); }
@@ -452,6 +571,10 @@ public:
 	static uint32 get_limit_fill_matrix() { return compartment_t::get_limit_fill_matrix(); }
 	static uint64 get_limit_explore_paths() { return compartment_t::get_limit_explore_paths(); }
 	static uint32 get_limit_reroute_goods() { return compartment_t::get_limit_reroute_goods(); }
+	static uint32 get_full_explore_count() { return compartment_t::get_full_explore_count(); }
+	static uint32 get_incremental_explore_count() { return compartment_t::get_incremental_explore_count(); }
+	static uint64 get_explore_iterations_done() { return compartment_t::get_explore_iterations_done(); }
+	static uint64 get_explore_iterations_saved() { return compartment_t::get_explore_iterations_saved(); }
 	static bool is_processing() { return processing; }
 	static const char *get_current_category_name() { return goods_compartment[current_compartment].get_category_name(); }
 	static const char *get_current_phase_name() { return goods_compartment[current_compartment].get_current_phase_name(); }
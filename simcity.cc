@@ -1370,10 +1370,10 @@ const stadt_t::factory_entry_t* stadt_t::factory_set_t::get_entry(const fabrik_t
 }
 
 
-stadt_t::factory_entry_t* stadt_t::factory_set_t::get_random_entry()
+stadt_t::factory_entry_t* stadt_t::factory_set_t::get_random_entry(simrand_stream_t &random)
 {
 	if(  total_remaining>0  ) {
-		sint32 weight = simrand(total_remaining, "stadt_t::factory_set_t::get_random_entry()");
+		sint32 weight = random.rand(total_remaining);
 		FOR(vector_tpl<factory_entry_t>, & entry, entries) {
 			if(  entry.remaining>0  ) {
 				if(  weight<entry.remaining  ) {
@@ -1556,6 +1556,8 @@ stadt_t::~stadt_t()
 	// close info win
 	destroy_win((ptrdiff_t)this);
 
+	clear_ptr_vector(planned_steps);
+
 	check_city_tiles(true);
 
 	welt->remove_queued_city(this);
@@ -1649,6 +1651,7 @@ stadt_t::stadt_t(spieler_t* sp, koord pos, sint32 citizens) :
 	step_count = 0;
 	pax_destinations_new_change = 0;
 	next_step = 0;
+	passenger_steps_due = 0;
 	step_interval = 1;
 	next_growth_step = 0;
 	has_low_density = false;
@@ -1771,6 +1774,7 @@ stadt_t::stadt_t(karte_t* wl, loadsave_t* file) :
 
 	step_count = 0;
 	next_step = 0;
+	passenger_steps_due = 0;
 	step_interval = 1;
 	next_growth_step = 0;
 	has_low_density = false;
@@ -2444,11 +2448,14 @@ void stadt_t::step(long delta_t)
 	}
 
 	// create passenger rate proportional to town size
+	// (the passengers are generated by plan_passagiere() and step_passagiere())
 	while(step_interval < next_step) {
-		step_passagiere();
-		step_count++;
+		passenger_steps_due++;
 		next_step -= step_interval;
 	}
+	if(  passenger_steps_due > 0  ) {
+		passenger_random.set_seed( simrand(0xFFFFFFFFu, "void stadt_t::step() (passenger random seed)") );
+	}
 
 	// update history (might be changed do to construction/destroying of houses)
 	city_history_month[0][HIST_CITICENS] = get_einwohner();	// total number
@@ -3056,10 +3063,11 @@ void stadt_t::add_road_connexion(uint16 journey_time_per_tile, const gebaeude_t*
 }
 
 
-/* this creates passengers and mail for everything is is therefore one of the CPU hogs of the machine
- * think trice, before applying optimisation here ...
+/* Passenger generation, part one: this plans the trips due in this step. It only reads
+ * the world and draws from the city's own random stream, so it can run in parallel for
+ * all cities; step_passagiere() then books the trips in a fixed order.
  */
-void stadt_t::step_passagiere()
+void stadt_t::plan_passagiere()
 {
 	settings_t const& s = welt->get_settings();
 
@@ -3082,41 +3090,281 @@ void stadt_t::step_passagiere()
 	const uint8 passenger_packet_size = s.get_passenger_routing_packet_size();
 	const uint8 passenger_routing_local_chance = s.get_passenger_routing_local_chance();
 	const uint8 passenger_routing_midrange_chance = s.get_passenger_routing_midrange_chance();
+
+	// Add 1 because the simuconf.tab setting is for maximum *alternative* destinations, whereas we need maximum *actual* desintations 
+	const uint8 max_destinations = (s.get_max_alternative_destinations() < 16 ? s.get_max_alternative_destinations() : 15) + 1;
+
+	// generated passengers are only booked by step_passagiere(), so count the ones planned here
+	sint64 generated[2] = { city_history_month[0][HIST_PAS_GENERATED], city_history_month[0][HIST_MAIL_GENERATED] };
+
+	for(  ;  passenger_steps_due > 0;  passenger_steps_due--  )
+	{
+		// Determine whether to generate a mail or passenger packet.
+		// See here for a discussion of ratios: http://forum.simutrans.com/index.php?topic=10920.0
+		// It is probably necessary to refine this further to take account of historical variation,
+		// and allow this to be customised by pakset.
+		const ware_besch_t * wtyp;
+		if(  passenger_random.rand(400) < 396  ) {
+			wtyp = warenbauer_t::passagiere;
+		} else {
+			wtyp = warenbauer_t::post;
+		}
+
+		factory_set_t &target_factories = (wtyp==warenbauer_t::passagiere ? target_factories_pax : target_factories_mail);
+		sint64 &generated_total = generated[wtyp==warenbauer_t::passagiere ? 0 : 1];
+
+		// restart at first buiulding?
+		if (step_count >= buildings.get_count()) 
+		{
+			step_count = 0;
+		}
+
+		if (buildings.empty())
+		{
+			passenger_steps_due = 0;
+			return;
+		}
+		gebaeude_t* gb = buildings[step_count];
+		step_count++;
+
+		planned_step_t *const planned = new planned_step_t();
+		planned->gb = gb;
+		planned->wtyp = wtyp;
+		planned->num_pax =
+			(wtyp == warenbauer_t::passagiere) ?
+				(gb->get_tile()->get_besch()->get_level()) :
+				(gb->get_tile()->get_besch()->get_post_level());
+		const int num_pax = planned->num_pax;
+		generated_total += num_pax;
+
+		// suitable start search (public transport)
+		const koord origin_pos = gb->get_pos().get_2d();
+		const planquadrat_t *const plan = welt->lookup(origin_pos);
+		const nearby_halt_t *const halt_list = plan->get_haltlist();
+
+		vector_tpl<nearby_halt_t> &start_halts = planned->start_halts;
+		start_halts.resize(plan->get_haltlist_count());
+		for (int h = plan->get_haltlist_count() - 1; h >= 0; h--) 
+		{
+			nearby_halt_t halt = halt_list[h];
+			if (halt.halt->is_enabled(wtyp) && !halt.halt->is_overcrowded(wtyp->get_catg_index())) 
+			{
+				start_halts.append(halt);
+			}
+		}
+
+		// Check whether this batch of passengers has access to a private car each.
+		// Check run in batches to save computational effort.
+		const sint16 private_car_percent = wtyp == warenbauer_t::passagiere ? get_private_car_ownership(welt->get_timeline_year_month()) : 0; 
+		// Only passengers have private cars
+		planned->has_private_car = private_car_percent > 0 ? passenger_random.rand(100) <= (uint16)private_car_percent : false;
+
+		// Find passenger destination
+		for(int pax_routed = 0, pax_left_to_do = 0; pax_routed < num_pax; pax_routed += pax_left_to_do) 
+		{	
+			/* number of passengers that want to travel
+			* Hajo: for efficiency we try to route not every
+			* single pax, but packets. If possible, we do 7 passengers at a time
+			* the last packet might have less then 7 pax
+			* Number now not fixed at 7, but set in simuconf.tab (@author: jamespetts)
+			*/
+
+			pax_left_to_do = min(passenger_packet_size, num_pax - pax_routed);
+
+			planned_trip_t *const trip = new planned_trip_t();
+			trip->pax = pax_left_to_do;
+
+			trip->destination_count = passenger_random.rand(max_destinations) + 1;
+			const uint8 destination_count = trip->destination_count;
+
+			// Split passengers: between local, midrange and long-distance
+			// according to the percentages set in simuconf.tab.
+			// Note: a random town will be found if there are no towns within range.
+			const uint8 passenger_routing_choice = passenger_random.rand(100);
+			const journey_distance_type range = 
+				passenger_routing_choice <= passenger_routing_local_chance ? 
+				local :
+			passenger_routing_choice <= (passenger_routing_local_chance + passenger_routing_midrange_chance) ? 
+				midrange : longdistance;
+			trip->range = range;
+			trip->tolerance = 
+				wtyp == warenbauer_t::post ? 
+				65535 : 
+				range == local ? 
+					passenger_random.rand_normal(range_local_tolerance) + min_local_tolerance : 
+				range == midrange ? 
+					passenger_random.rand_normal(range_midrange_tolerance) + min_midrange_tolerance : 
+				/*longdistance*/
+				passenger_random.rand_normal(range_longdistance_tolerance) + min_longdistance_tolerance;
+
+			destination *const destinations = trip->destinations;
+			for(int destinations_assigned = 0; destinations_assigned <= destination_count; destinations_assigned ++)
+			{				
+				if(range == local)
+				{
+					//Local - a designated proportion will automatically go to destinations within the town.
+					if(passenger_routing_choice <= adjusted_passenger_routing_local_chance)
+					{
+						// Will always be a destination in the current town.
+						destinations[destinations_assigned] = find_destination(target_factories, generated_total, &trip->will_return, passenger_random, 0, local_passengers_max_distance, origin_pos);	
+					}
+					else
+					{
+						destinations[destinations_assigned] = find_destination(target_factories, generated_total, &trip->will_return, passenger_random, local_passengers_min_distance, local_passengers_max_distance, origin_pos);
+					}
+				}
+				else if(range == midrange)
+				{
+					//Medium
+					destinations[destinations_assigned] = find_destination(target_factories, generated_total, &trip->will_return, passenger_random, midrange_passengers_min_distance, midrange_passengers_max_distance, origin_pos);
+				}
+				else
+				//else if(range == longdistance)
+				{
+					//Long distance
+					destinations[destinations_assigned] = find_destination(target_factories, generated_total, &trip->will_return, passenger_random, longdistance_passengers_min_distance, longdistance_passengers_max_distance, origin_pos); 
+				}
+			}
+
+			/**
+			 * Quasi tolerance is necessary because mail can be delivered by hand. If it is delivered
+			 * by hand, the deliverer has a tolerance, but if it is sent through the postal system,
+			 * the mail packet itself does not have a tolerance.
+			 *
+			 * In addition, walking tolerance is divided by two for non-local journeys because
+			 * passengers prefer not to walk for long distances, as it is tiring especially with luggage.
+			 * (This isn't quite right and the game logic for it should be fixed.)
+			 */
+			trip->quasi_tolerance = trip->tolerance;
+			if(wtyp == warenbauer_t::post) {
+				trip->quasi_tolerance = passenger_random.rand_normal(range_local_tolerance) + min_local_tolerance;
+			}
+			else if (range != local) {
+				// Passengers.  People will walk long distances with mail, it's not heavy.
+				trip->quasi_tolerance /= 2;
+			}
+
+			// Search the public transport routes to all destinations; step_passagiere() decides which are used
+			for(uint8 current_destination = 0; current_destination < destination_count; current_destination ++)
+			{
+				const uint32 straight_line_distance = shortest_distance(origin_pos, destinations[current_destination].location);
+				const uint32 walking_time = welt->walking_time_tenths_from_distance(straight_line_distance);
+				if(!planned->has_private_car && walking_time > trip->quasi_tolerance && start_halts.empty())
+				{
+					// step_passagiere() will not consider this destination
+					continue;
+				}
+
+				// Dario: Check if there's a stop near destination
+				const planquadrat_t* dest_plan = welt->lookup(destinations[current_destination].location);
+				const nearby_halt_t* dest_list = dest_plan->get_haltlist();
+
+				// Note that, although factories are only *connected* now if they are within the smaller factory radius
+				// (default: 1), they can take passengers within the wider square of the passenger radius. This is intended,
+				// and is as a result of using the below method for all destination types.
+
+				minivec_tpl<halthandle_t> &destination_list = trip->destination_list[current_destination];
+				for (int h = dest_plan->get_haltlist_count() - 1; h >= 0; h--) 
+				{
+					halthandle_t halt = dest_list[h].halt;
+					if (halt->is_enabled(wtyp)) 
+					{
+						destination_list.append(halt);
+					}
+				}
+
+				if(start_halts.get_count() == 1 && destination_list.get_count() == 1 && start_halts[0].halt == destination_list.get_element(0))
+				{
+					// There is no public transport route, as the only stop
+					// for the origin is also the only stop for the desintation.
+					continue;
+				}
+
+				// Check whether public transport can be used.
+				// Journey start information needs to be added later.
+				ware_t &pax = trip->pax_ware[current_destination];
+				pax = ware_t(wtyp);
+				pax.set_zielpos(destinations[current_destination].location);
+				pax.menge = pax_left_to_do;
+				pax.to_factory = (destinations[current_destination].factory_entry ? 1 : 0);
+				//"Menge" = volume (Google)
+
+				// Search for a route using public transport. 
+
+				uint16 best_journey_time = 65535;
+				uint8 best_start_halt = 0;
+				uint32 current_journey_time;
+
+				ITERATE(start_halts, i)
+				{
+					halthandle_t current_halt = start_halts[i].halt;
+				
+					current_journey_time = current_halt->find_route(&destination_list, pax, best_journey_time, destinations[current_destination].location);
+					
+					// Add walking time from the origin to the origin stop. 
+					// Note that the walking time to the destination stop is already added by find_route.
+					current_journey_time += welt->walking_time_tenths_from_distance(start_halts[i].distance);
+					if(current_journey_time > 65535)
+					{
+						current_journey_time = 65535;
+					}
+					// TODO: Add facility to check whether station/stop has car parking facilities, and add the possibility of a (faster) private car journey.
+					// Use the private car journey time per tile from the passengers' origin to the city in which the stop is located.
+
+					if(current_journey_time < best_journey_time)
+					{
+						best_journey_time = current_journey_time;
+						best_start_halt = i;
+					}
+					if(pax.get_ziel().is_bound())
+					{
+						trip->public_transport_found[current_destination] = true;
+					}
+				}
+
+				trip->best_journey_time[current_destination] = best_journey_time;
+				trip->best_start_halt[current_destination] = best_start_halt;
+			}
+
+			planned->trips.append(trip);
+		}
+
+		planned_steps.append(planned);
+	}
+}
+
+
+/* this creates passengers and mail for everything is is therefore one of the CPU hogs of the machine
+ * think trice, before applying optimisation here ...
+ *
+ * Passenger generation, part two: this books the trips planned by plan_passagiere().
+ */
+void stadt_t::step_passagiere()
+{
+	FOR(vector_tpl<planned_step_t*>, const planned, planned_steps) {
+		step_passagiere(*planned);
+	}
+	clear_ptr_vector(planned_steps);
+}
+
+
+void stadt_t::step_passagiere(planned_step_t &planned)
+{
+	settings_t const& s = welt->get_settings();
+
 	const uint8 always_prefer_car_percent = s.get_always_prefer_car_percent();
 
 	//	DBG_MESSAGE("stadt_t::step_passagiere()", "%s step_passagiere called (%d,%d - %d,%d)\n", name, li, ob, re, un);
 	//	long t0 = get_current_time_millis();
 
-	// Determine whether to generate a mail or passenger packet.
-	// See here for a discussion of ratios: http://forum.simutrans.com/index.php?topic=10920.0
-	// It is probably necessary to refine this further to take account of historical variation,
-	// and allow this to be customised by pakset.
-	const ware_besch_t * wtyp;
-	if(  simrand(400, "void stadt_t::step_passagiere() (mail or passengers?)") < 396  ) {
-		wtyp = warenbauer_t::passagiere;
-	} else {
-		wtyp = warenbauer_t::post;
-	}
+	const ware_besch_t *const wtyp = planned.wtyp;
 
 	const city_cost history_type = (wtyp == warenbauer_t::passagiere) ? HIST_PAS_TRANSPORTED : HIST_MAIL_TRANSPORTED;
 	factory_set_t &target_factories = (wtyp==warenbauer_t::passagiere ? target_factories_pax : target_factories_mail);
 
-	// restart at first buiulding?
-	if (step_count >= buildings.get_count()) 
-	{
-		step_count = 0;
-	}
+	gebaeude_t* gb = planned.gb;
 
-	if (buildings.empty())
-	{
-		return;
-	}
-	gebaeude_t* gb = buildings[step_count];
-
-	const int num_pax =
-		(wtyp == warenbauer_t::passagiere) ?
-			(gb->get_tile()->get_besch()->get_level()) :
-			(gb->get_tile()->get_besch()->get_post_level());
+	const int num_pax = planned.num_pax;
 
 	// Hajo: track number of generated passengers.
 	city_history_year[0][history_type+1] += num_pax;
@@ -3128,23 +3376,11 @@ void stadt_t::step_passagiere()
 	const planquadrat_t *const plan = welt->lookup(origin_pos);
 	const nearby_halt_t *const halt_list = plan->get_haltlist();
 
-	vector_tpl<nearby_halt_t> start_halts(plan->get_haltlist_count());
-	for (int h = plan->get_haltlist_count() - 1; h >= 0; h--) 
-	{
-		nearby_halt_t halt = halt_list[h];
-		if (halt.halt->is_enabled(wtyp) && !halt.halt->is_overcrowded(wtyp->get_catg_index())) 
-		{
-			start_halts.append(halt);
-		}
-	}
+	const vector_tpl<nearby_halt_t> &start_halts = planned.start_halts;
 
 	INT_CHECK( "simcity 2794" );
 
-	// Check whether this batch of passengers has access to a private car each.
-	// Check run in batches to save computational effort.
-	const sint16 private_car_percent = wtyp == warenbauer_t::passagiere ? get_private_car_ownership(welt->get_timeline_year_month()) : 0; 
-	// Only passengers have private cars
-	const bool has_private_car = private_car_percent > 0 ? simrand(100, "void stadt_t::step_passagiere() (has private car?)") <= (uint16)private_car_percent : false;
+	const bool has_private_car = planned.has_private_car;
 	
 	// Record the most useful set of information about why passengers cannot reach their chosen destination:
 	// Too slow > overcrowded > no route. Tiebreaker: higher destination preference.
@@ -3152,74 +3388,20 @@ void stadt_t::step_passagiere()
 	uint8 best_bad_start_halt;
 	bool too_slow_already_set;
 
-	// Add 1 because the simuconf.tab setting is for maximum *alternative* destinations, whereas we need maximum *actual* desintations 
-	const uint8 max_destinations = (s.get_max_alternative_destinations() < 16 ? s.get_max_alternative_destinations() : 15) + 1;
+	// an empty destination list, for destinations whose list was not needed
+	minivec_tpl<halthandle_t> no_destination_halts;
 
-	minivec_tpl<halthandle_t> destination_list[16];
-
-	// Find passenger destination
-	for(int pax_routed = 0, pax_left_to_do = 0; pax_routed < num_pax; pax_routed += pax_left_to_do) 
-	{	
-		/* number of passengers that want to travel
-		* Hajo: for efficiency we try to route not every
-		* single pax, but packets. If possible, we do 7 passengers at a time
-		* the last packet might have less then 7 pax
-		* Number now not fixed at 7, but set in simuconf.tab (@author: jamespetts)
-		*/
-
-		pax_left_to_do = min(passenger_packet_size, num_pax - pax_routed);
-
-		// search target for the passenger
-		pax_return_type will_return;
-
-		const uint8 destination_count = simrand(max_destinations, "void stadt_t::step_passagiere() (number of destinations?)") + 1;
-
-		// Split passengers: between local, midrange and long-distance
-		// according to the percentages set in simuconf.tab.
-		// Note: a random town will be found if there are no towns within range.
-		const uint8 passenger_routing_choice = simrand(100, "void stadt_t::step_passagiere() (passenger routing choice?)");
-		const journey_distance_type range = 
-			passenger_routing_choice <= passenger_routing_local_chance ? 
-			local :
-		passenger_routing_choice <= (passenger_routing_local_chance + passenger_routing_midrange_chance) ? 
-			midrange : longdistance;
-		const uint16 tolerance = 
-			wtyp == warenbauer_t::post ? 
-			65535 : 
-			range == local ? 
-				simrand_normal(range_local_tolerance, "void stadt_t::step_passagiere() (local tolerance?)") + min_local_tolerance : 
-			range == midrange ? 
-				simrand_normal(range_midrange_tolerance, "void stadt_t::step_passagiere() (midrange tolerance?)") + min_midrange_tolerance : 
-			/*longdistance*/
-			simrand_normal(range_longdistance_tolerance, "void stadt_t::step_passagiere() (longdistance tolerance?)") + min_longdistance_tolerance;
-		destination destinations[16];
-		for(int destinations_assigned = 0; destinations_assigned <= destination_count; destinations_assigned ++)
-		{				
-			if(range == local)
-			{
-				//Local - a designated proportion will automatically go to destinations within the town.
-				if(passenger_routing_choice <= adjusted_passenger_routing_local_chance)
-				{
-					// Will always be a destination in the current town.
-					destinations[destinations_assigned] = find_destination(target_factories, city_history_month[0][history_type+1], &will_return, 0, local_passengers_max_distance, origin_pos);	
-				}
-				else
-				{
-					destinations[destinations_assigned] = find_destination(target_factories, city_history_month[0][history_type+1], &will_return, local_passengers_min_distance, local_passengers_max_distance, origin_pos);
-				}
-			}
-			else if(range == midrange)
-			{
-				//Medium
-				destinations[destinations_assigned] = find_destination(target_factories, city_history_month[0][history_type+1], &will_return, midrange_passengers_min_distance, midrange_passengers_max_distance, origin_pos);
-			}
-			else
-			//else if(range == longdistance)
-			{
-				//Long distance
-				destinations[destinations_assigned] = find_destination(target_factories, city_history_month[0][history_type+1], &will_return, longdistance_passengers_min_distance, longdistance_passengers_max_distance, origin_pos); 
-			}
-		}
+	// The passengers were split into packets by plan_passagiere()
+	FOR(vector_tpl<planned_trip_t*>, const trip, planned.trips)
+	{
+		const int pax_left_to_do = trip->pax;
+		const pax_return_type will_return = trip->will_return;
+
+		const uint8 destination_count = trip->destination_count;
+		const journey_distance_type range = trip->range;
+		const uint16 tolerance = trip->tolerance;
+		destination *const destinations = trip->destinations;
+		minivec_tpl<halthandle_t> *const destination_list = trip->destination_list;
 
 		if(wtyp != warenbauer_t::post)
 		{
@@ -3250,14 +3432,7 @@ void stadt_t::step_passagiere()
 		 * passengers prefer not to walk for long distances, as it is tiring especially with luggage.
 		 * (This isn't quite right and the game logic for it should be fixed.)
 		 */
-		uint16 quasi_tolerance = tolerance;
-		if(wtyp == warenbauer_t::post) {
-			quasi_tolerance = simrand_normal(range_local_tolerance, "void stadt_t::step_passagiere() (local tolerance?)") + min_local_tolerance;
-		}
-		else if (range != local) {
-			// Passengers.  People will walk long distances with mail, it's not heavy.
-			quasi_tolerance /= 2;
-		}
+		const uint16 quasi_tolerance = trip->quasi_tolerance;
 
 		uint16 car_minutes = 65535;
 
@@ -3266,6 +3441,7 @@ void stadt_t::step_passagiere()
 		too_slow_already_set = false;
 		ware_t pax(wtyp);
 		halthandle_t start_halt;
+		bool visited[17] = { false };
 
 		while(route_status != public_transport && route_status != private_car && route_status != on_foot && current_destination < destination_count)
 		{
@@ -3288,25 +3464,8 @@ void stadt_t::step_passagiere()
 				continue;
 			}
 			
-			// Dario: Check if there's a stop near destination
-			const planquadrat_t* dest_plan = welt->lookup(destinations[current_destination].location);
-			const nearby_halt_t* dest_list = dest_plan->get_haltlist();
-			
-			// Knightly : we can avoid duplicated efforts by building destination halt list here at the same time
-
-			// Note that, although factories are only *connected* now if they are within the smaller factory radius
-			// (default: 1), they can take passengers within the wider square of the passenger radius. This is intended,
-			// and is as a result of using the below method for all destination types.
-
-							
-			for (int h = dest_plan->get_haltlist_count() - 1; h >= 0; h--) 
-			{
-				halthandle_t halt = dest_list[h].halt;
-				if (halt->is_enabled(wtyp)) 
-				{
-					destination_list[current_destination].append(halt);
-				}
-			}
+			// The destination halt list was built by plan_passagiere()
+			visited[current_destination] = true;
 
 			uint16 best_journey_time = 65535;
 
@@ -3319,44 +3478,13 @@ void stadt_t::step_passagiere()
 			}
 			else
 			{
-				// Check whether public transport can be used.
-				// Journey start information needs to be added later.
-				pax.reset();
-				pax.set_zielpos(destinations[current_destination].location);
-				pax.menge = pax_left_to_do;
-				pax.to_factory = (destinations[current_destination].factory_entry ? 1 : 0);
-				//"Menge" = volume (Google)
-
-				// Search for a route using public transport. 
-
-				uint8 best_start_halt = 0;
-				uint32 current_journey_time;
-
-				ITERATE(start_halts, i)
+				// The public transport search was done by plan_passagiere()
+				pax = trip->pax_ware[current_destination];
+				best_journey_time = trip->best_journey_time[current_destination];
+				const uint8 best_start_halt = trip->best_start_halt[current_destination];
+				if(trip->public_transport_found[current_destination])
 				{
-					halthandle_t current_halt = start_halts[i].halt;
-				
-					current_journey_time = current_halt->find_route(&destination_list[current_destination], pax, best_journey_time, destinations[current_destination].location);
-					
-					// Add walking time from the origin to the origin stop. 
-					// Note that the walking time to the destination stop is already added by find_route.
-					current_journey_time += welt->walking_time_tenths_from_distance(start_halts[i].distance);
-					if(current_journey_time > 65535)
-					{
-						current_journey_time = 65535;
-					}
-					// TODO: Add facility to check whether station/stop has car parking facilities, and add the possibility of a (faster) private car journey.
-					// Use the private car journey time per tile from the passengers' origin to the city in which the stop is located.
-
-					if(current_journey_time < best_journey_time)
-					{
-						best_journey_time = current_journey_time;
-						best_start_halt = i;
-					}
-					if(pax.get_ziel().is_bound())
-					{
-						route_status = public_transport;
-					}
+					route_status = public_transport;
 				}
 
 				if(best_journey_time == 0)
@@ -3648,7 +3776,8 @@ void stadt_t::step_passagiere()
 					{
 						// Only mark passengers as being unable to get to their destination due to crowded stops if the stops
 						// could actually have got the passengers to their destination if they were not crowded.
-						if(halt->is_enabled(wtyp) && halt->find_route(&destination_list[destinations_checked], test_passengers) < 65535)
+						minivec_tpl<halthandle_t> *const checked_list = visited[destinations_checked] ? &destination_list[destinations_checked] : &no_destination_halts;
+						if(halt->is_enabled(wtyp) && halt->find_route(checked_list, test_passengers) < 65535)
 						{
 							halt->add_pax_unhappy(num_pax);
 							// Only show as being overcrowded if there are, in fact, potentially suitable but overcrowded stops.
@@ -3896,7 +4025,7 @@ void stadt_t::set_private_car_trip(int passengers, stadt_t* destination_town)
  * returns a random and uniformly distributed point within city borders
  * @author Hj. Malthaner
  */
-koord stadt_t::get_zufallspunkt(uint32 min_distance, uint32 max_distance, koord origin) const
+koord stadt_t::get_zufallspunkt(uint32 min_distance, uint32 max_distance, koord origin, simrand_stream_t *random) const
 {
 	if(!buildings.empty()) 
 	{
@@ -3908,14 +4037,18 @@ koord stadt_t::get_zufallspunkt(uint32 min_distance, uint32 max_distance, koord
 		uint32 nearest_miss_difference = 2147483647; // uint32 max.
 		for(uint32 i = 0; i < 24; i++)
 		{
-			gebaeude_t* const gb = pick_any_weighted(buildings);
+			gebaeude_t* const gb = random ? pick_any_weighted(buildings, *random) : pick_any_weighted(buildings);
 
 			koord k = gb->get_pos().get_2d();
 			if(!welt->is_within_limits(k)) 
 			{
 				// this building should not be in this list, since it has been already deleted!
+				// (when called with a random stream, other threads may read the list, so leave it be)
 				dbg->error("stadt_t::get_zufallspunkt()", "illegal building in city list of %s: %p removing!", this->get_name(), gb);
-				const_cast<stadt_t*>(this)->buildings.remove(gb);
+				if(random == NULL)
+				{
+					const_cast<stadt_t*>(this)->buildings.remove(gb);
+				}
 				k = koord(0, 0);
 			}
 			const uint32 distance = shortest_distance(k, origin);
@@ -4002,9 +4135,9 @@ void stadt_t::recalc_target_attractions()
 /* this function generates a random target for passenger/mail
  * changing this strongly affects selection of targets and thus game strategy
  */
-stadt_t::destination stadt_t::find_destination(factory_set_t &target_factories, const sint64 generated, pax_return_type* will_return, uint32 min_distance, uint32 max_distance, koord origin)
+stadt_t::destination stadt_t::find_destination(factory_set_t &target_factories, const sint64 generated, pax_return_type* will_return, simrand_stream_t &random, uint32 min_distance, uint32 max_distance, koord origin)
 {
-	const int rand = simrand(100, "stadt_t::destination stadt_t::find_destination (init)");
+	const int rand = random.rand(100);
 	destination current_destination;
 	current_destination.object.town = NULL;
 	current_destination.type = 1;
@@ -4017,10 +4150,10 @@ stadt_t::destination stadt_t::find_destination(factory_set_t &target_factories,
 	// destinations to which they will travel if they cannot get to the factories.
 	if(rand < welt->get_settings().get_factory_worker_percentage() && target_factories.total_remaining > 0 && (sint64)target_factories.generation_ratio > ((sint64)(target_factories.total_generated*100) << RATIO_BITS) / (generated + 1))
 	{
-		factory_entry_t* entry = target_factories.get_random_entry();
+		factory_entry_t* entry = target_factories.get_random_entry(random);
 		while(entry->factory == NULL)
 		{
-			entry = target_factories.get_random_entry();
+			entry = target_factories.get_random_entry(random);
 		} 
 		*will_return = factory_return;	// worker will return
 		current_destination.type = FACTORY_PAX;
@@ -4029,10 +4162,10 @@ stadt_t::destination stadt_t::find_destination(factory_set_t &target_factories,
 		{
 			while(counter ++ < 32 && (shortest_distance(origin, entry->factory->get_pos().get_2d()) > max_distance || shortest_distance(origin, entry->factory->get_pos().get_2d()) < min_distance))
 			{
-				entry = target_factories.get_random_entry();
+				entry = target_factories.get_random_entry(random);
 				while(entry->factory == NULL)
 				{
-					entry = target_factories.get_random_entry();
+					entry = target_factories.get_random_entry(random);
 				} 
 			}
 			current_destination.location = entry->factory->get_pos().get_2d();
@@ -4046,14 +4179,14 @@ stadt_t::destination stadt_t::find_destination(factory_set_t &target_factories,
 	else if(rand <welt->get_settings().get_tourist_percentage() + welt->get_settings().get_factory_worker_percentage() && welt->get_ausflugsziele().get_sum_weight() > 0 ) 
 	{ 		
 		*will_return = tourist_return;	// tourists will return
-		const gebaeude_t* gb = pick_any_weighted(target_attractions);
+		const gebaeude_t* gb = pick_any_weighted(target_attractions, random);
 		current_destination.type = TOURIST_PAX;
 		uint8 counter = 0;
 		do
 		{
 			while(counter ++ < 32 && (shortest_distance(origin, gb->get_pos().get_2d()) > max_distance || shortest_distance(origin, gb->get_pos().get_2d()) < min_distance))
 			{
-				gb = pick_any_weighted(target_attractions);
+				gb = pick_any_weighted(target_attractions, random);
 			}
 			current_destination.location = gb->get_pos().get_2d();
 		} while(current_destination.location == origin); // The destination must not be the same as the origin, so keep retrying until it is not.
@@ -4083,7 +4216,7 @@ stadt_t::destination stadt_t::find_destination(factory_set_t &target_factories,
 			const uint32 weight = welt->get_town_list_weight();
 			const uint32 number_of_towns = welt->get_staedte().get_count();
 			uint32 town_step = weight / number_of_towns - 100;
-			uint32 random = simrand(weight, "stadt_t::destination stadt_t::finde_passagier_ziel (town)");
+			uint32 town_random = random.rand(weight);
 			uint32 distance = 0;
 			const uint16 max_x = max((origin.x - ur.x), (origin.x - lo.x));
 			const uint16 max_y = max((origin.y - ur.y), (origin.y - lo.y));
@@ -4092,7 +4225,7 @@ stadt_t::destination stadt_t::find_destination(factory_set_t &target_factories,
 			
 			for(uint8 i = 0; i < max_count; i ++)
 			{
-				zielstadt = welt->get_town_at(random);
+				zielstadt = welt->get_town_at(town_random);
 				// Add max_internal_distnace here, as the destination building might be *closer* than the town hall.
 				
 				if(zielstadt == this && min_distance > 0)
@@ -4128,10 +4261,10 @@ stadt_t::destination stadt_t::find_destination(factory_set_t &target_factories,
 					}					
 				}
 
-				random += town_step;
-				if(random > weight)
+				town_random += town_step;
+				if(town_random > weight)
 				{
-					random = 0;
+					town_random = 0;
 				}
 
 				/*if(i == 16 || i == 32 || i == 64)
@@ -4165,7 +4298,7 @@ stadt_t::destination stadt_t::find_destination(factory_set_t &target_factories,
 			//*will_return = (this != zielstadt) ? city_return : no_return;
 			// Sometimes having people not returning creates anomalies such as larger cities generating fewer passenger trips overall.
 			*will_return = city_return;
-			current_destination.location = zielstadt->get_zufallspunkt(min_distance, max_distance, origin); //"random dot"
+			current_destination.location = zielstadt->get_zufallspunkt(min_distance, max_distance, origin, &random); //"random dot"
 			current_destination.object.town = zielstadt;
 		} while(current_destination.location == origin); // The destination must not be the same as the origin, so keep retrying until it is not.
 		return current_destination;
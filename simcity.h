@@ -9,6 +9,8 @@
 #define simcity_h
 
 #include "simdings.h"
+#include "simware.h"
+#include "simtools.h"
 #include "dings/gebaeude.h"
 
 #include "tpl/vector_tpl.h"
@@ -19,6 +21,7 @@
 
 #include "vehicle/simverkehr.h"
 #include "tpl/sparse_tpl.h"
+#include "tpl/minivec_tpl.h"
 #include "utils/plainstring.h"
 
 #include <string>
@@ -195,6 +198,17 @@ private:
 	 */
 	uint32 next_step;
 
+	/**
+	 * passenger generation steps which are due, but not yet planned
+	 * by plan_passagiere()
+	 */
+	uint16 passenger_steps_due;
+
+	/**
+	 * random numbers for plan_passagiere(), seeded in step()
+	 */
+	simrand_stream_t passenger_random;
+
 	/**
 	 * in this fixed interval, construction will happen
 	 */
@@ -366,7 +380,7 @@ public:
 
 		const vector_tpl<factory_entry_t>& get_entries() const { return entries; }
 		const factory_entry_t* get_entry(const fabrik_t *const factory) const;
-		factory_entry_t* get_random_entry();
+		factory_entry_t* get_random_entry(simrand_stream_t &random);
 		void update_factory(fabrik_t *const factory, const sint32 demand);
 		void remove_factory(fabrik_t *const factory);
 		void recalc_generation_ratio(const sint32 default_percent, const sint64 *city_stats, const int stats_count, const int stat_type);
@@ -403,12 +417,6 @@ private:
 
 	enum pax_return_type { no_return, factory_return, tourist_return, city_return };
 
-	/**
-	 * verteilt die Passagiere auf die Haltestellen
-	 * @author Hj. Malthaner
-	 */
-	void step_passagiere();
-
 	/**
 	 * ein Passagierziel in die Zielkarte eintragen
 	 * @author Hj. Malthaner
@@ -575,7 +583,7 @@ public:
 	 * Stadtgrenzen zurck
 	 * @author Hj. Malthaner
 	 */
-	koord get_zufallspunkt(uint32 min_distance = 0, uint32 max_distance = 16384, koord origin = koord::invalid) const;
+	koord get_zufallspunkt(uint32 min_distance = 0, uint32 max_distance = 16384, koord origin = koord::invalid, simrand_stream_t *random = NULL) const;
 
 	/**
 	 * gibt das pax-statistik-array fr letzten monat zurck
@@ -673,7 +681,70 @@ public:
 
 	void check_all_private_car_routes();
 
+	/**
+	 * Plans the passenger and mail trips due in this step: picks the buildings,
+	 * destinations and public transport routes. This only reads the world, so
+	 * it may run in parallel for all cities.
+	 */
+	void plan_passagiere();
+
+	/**
+	 * verteilt die Passagiere auf die Haltestellen
+	 * (books the trips planned by plan_passagiere(); must be called in city order)
+	 * @author Hj. Malthaner
+	 */
+	void step_passagiere();
+
 private:
+	/**
+	 * One packet of passengers/mail as planned by plan_passagiere(),
+	 * with the public transport search for each of its destinations.
+	 */
+	struct planned_trip_t
+	{
+		int pax;
+		uint8 destination_count;
+		journey_distance_type range;
+		uint16 tolerance;
+		uint16 quasi_tolerance;
+		pax_return_type will_return;
+		// one more than the maximum number of destinations, as find_destination is called for destination_count + 1
+		destination destinations[17];
+		minivec_tpl<halthandle_t> destination_list[17];
+		ware_t pax_ware[17];
+		uint16 best_journey_time[17];
+		uint8 best_start_halt[17];
+		bool public_transport_found[17];
+
+		planned_trip_t() : pax(0), destination_count(0), range(local), tolerance(0), quasi_tolerance(0), will_return(no_return)
+		{
+			for(  int i = 0;  i < 17;  i++  ) {
+				best_journey_time[i] = 65535;
+				best_start_halt[i] = 0;
+				public_transport_found[i] = false;
+			}
+		}
+	};
+
+	/**
+	 * One building step of passenger generation, as planned by plan_passagiere()
+	 */
+	struct planned_step_t
+	{
+		gebaeude_t *gb;
+		const ware_besch_t *wtyp;
+		int num_pax;
+		bool has_private_car;
+		vector_tpl<nearby_halt_t> start_halts;
+		vector_tpl<planned_trip_t *> trips;
+
+		~planned_step_t() { clear_ptr_vector(trips); }
+	};
+
+	vector_tpl<planned_step_t *> planned_steps;
+
+	void step_passagiere(planned_step_t &planned);
+
 	/**
 	 * A weighted list of distances
 	 * @author Knightly 
@@ -738,6 +809,7 @@ public:
 	destination find_destination(factory_set_t &target_factories, 
 		const sint64 generated, 
 		pax_return_type* will_return, 
+		simrand_stream_t &random,
 		uint32 min_distance = 0, 
 		uint32 max_distance = 16384,
 		koord origin = koord::invalid);
@@ -200,6 +200,8 @@ void convoi_t::init(karte_t *wl, spieler_t *sp)
 
 	line_update_pending = linehandle_t();
 
+	prepared_route_search = NULL;
+
 	home_depot = koord3d::invalid;
 	last_stop_pos = koord3d::invalid;
 	last_stop_id = 0;
@@ -798,6 +800,44 @@ bool convoi_t::calc_route(koord3d start, koord3d ziel, sint32 max_speed)
 	return fahr[0]->calc_route(start, ziel, max_speed, &route);
 }
 
+
+bool convoi_t::prepare_route_search(route_search_t &search)
+{
+	if(  wait_lock != 0  ||  anz_vehikel == 0  ||  fpl == NULL  ||  fpl->empty()  ||  line_update_pending.is_bound()  ) {
+		return false;
+	}
+	// only the states which will call drive_to() in step(); NO_ROUTE convoys may go to the depot instead
+	if(  state != ROUTING_1  &&  (state != NO_ROUTE  ||  no_route_retry_count + 1 >= 3)  ) {
+		return false;
+	}
+	// aircraft route around their runways in aircraft_t::calc_route()
+	if(  fahr[0]->get_waytype() == air_wt  ) {
+		return false;
+	}
+	search.start = fahr[0]->get_pos();
+	search.ziel = fpl->get_current_eintrag().pos;
+	if(  search.start == search.ziel  ) {
+		// will advance the schedule or stop midhalt first
+		return false;
+	}
+	search.max_speed = speed_to_kmh(get_min_top_speed());
+	search.cnv = self;
+	return true;
+}
+
+
+bool convoi_t::take_prepared_route(koord3d start, koord3d ziel, sint32 max_speed, route_t *target, route_t::route_result_t &result)
+{
+	route_search_t *search = prepared_route_search;
+	if(  search == NULL  ||  search->start != start  ||  search->ziel != ziel  ||  search->max_speed != max_speed  ) {
+		return false;
+	}
+	prepared_route_search = NULL;
+	*target = search->route;
+	result = search->result;
+	return true;
+}
+
 void convoi_t::update_route(uint32 index, const route_t &replacement)
 {
 	// replace route with replacement starting at index.
@@ -1106,14 +1146,22 @@ bool convoi_t::sync_step(long delta_t)
 				// While sp_soll is a signed integer fahre_basis() accepts an unsigned integer. 
 				// Thus running backwards is impossible.  Instead sp_soll < 0 is converted to very large 
 				// distances and results in "teleporting" the convoy to the end of its pre-caclulated route.
-				uint32 sp_hat = fahr[0]->fahre_basis(sp_soll < 0 ? 0 : sp_soll);
-				// stop when depot reached ...
-				if(state==INITIAL) {
-					break;
+				const uint32 sp_ist = sp_soll < 0 ? 0 : sp_soll;
+				uint32 sp_hat;
+				if(  vehikel_t::fahre_basis_auf_feld( &fahr[0], anz_vehikel, sp_ist )  ) {
+					// most of the time, nobody changes the tile: no hop_check() or hop() needed
+					sp_hat = sp_ist & YARDS_VEHICLE_STEP_MASK;
 				}
-				// now move the rest (so all vehikel are moving synchroniously)
-				for(unsigned i=1; i<anz_vehikel; i++) {
-					fahr[i]->fahre_basis(sp_hat); //"move basis"
+				else {
+					sp_hat = fahr[0]->fahre_basis(sp_ist);
+					// stop when depot reached ...
+					if(state==INITIAL) {
+						break;
+					}
+					// now move the rest (so all vehikel are moving synchroniously)
+					for(unsigned i=1; i<anz_vehikel; i++) {
+						fahr[i]->fahre_basis(sp_hat); //"move basis"
+					}
 				}
 				// maybe we have been stopped be something => avoid wide jumps
 				sp_soll = (sp_soll-sp_hat) & 0x0FFF;
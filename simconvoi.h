@@ -745,6 +745,43 @@ private:
 	route_infos_t route_infos;
 
 public:
+	/**
+	 * A route search this convoi will do in its next step().
+	 * It can be done in advance on a route search thread.
+	 * @see karte_t::calc_convoi_routes()
+	 */
+	struct route_search_t
+	{
+		convoihandle_t cnv;
+		koord3d start;
+		koord3d ziel;
+		sint32 max_speed;
+		route_t route;
+		route_t::route_result_t result;
+	};
+
+private:
+	/**
+	 * Route searched in advance for this step, NULL if none.
+	 * Belongs to karte_t and is only valid during the convoi steps.
+	 */
+	route_search_t *prepared_route_search;
+
+public:
+	/**
+	 * Fills in the route search of the next step(), if there will be a plain one.
+	 * @return false if no search can be done in advance
+	 */
+	bool prepare_route_search(route_search_t &search);
+
+	void set_prepared_route_search(route_search_t *search) { prepared_route_search = search; }
+
+	/**
+	 * Copies the route searched in advance to route, if it was searched
+	 * for the same start, target and speed. It is used at most once.
+	 */
+	bool take_prepared_route(koord3d start, koord3d ziel, sint32 max_speed, route_t *route, route_t::route_result_t &result);
+
 	ding_t::typ get_depot_type() const;
 
 	/**
@@ -685,6 +685,7 @@ fabrik_t::fabrik_t(karte_t* wl, loadsave_t* file)
 	total_input = total_transit = total_output = 0;
 	status = nothing;
 	currently_producing = false;
+	distribution_pending = false;
 	transformer_connected = NULL;
 
 	if(  besch == NULL  ) {
@@ -737,6 +738,7 @@ fabrik_t::fabrik_t(koord3d pos_, spieler_t* spieler, const fabrik_besch_t* fabes
 	menge_remainder = 0;
 	activity_count = 0;
 	currently_producing = false;
+	distribution_pending = false;
 	transformer_connected = NULL;
 	power = 0;
 	power_demand = 0;
@@ -1184,40 +1186,11 @@ void fabrik_t::set_name(const char *new_name)
 }
 
 
-void fabrik_t::rdwr(loadsave_t *file)
+void fabrik_t::rdwr_goods(loadsave_t *file)
 {
-	xml_tag_t f( file, "fabrik_t" );
 	sint32 i;
-	sint32 spieler_n;
-	sint32 eingang_count;
-	sint32 ausgang_count;
-	sint32 anz_lieferziele;
-
-	if(  file->is_saving()  ) {
-		eingang_count = eingang.get_count();
-		ausgang_count = ausgang.get_count();
-		anz_lieferziele = lieferziele.get_count();
-		const char *s = besch->get_name();
-		file->rdwr_str(s);
-	}
-	else {
-		char s[256];
-		file->rdwr_str(s, lengthof(s));
-DBG_DEBUG("fabrik_t::rdwr()","loading factory '%s'",s);
-		besch = fabrikbauer_t::get_fabesch(s);
-		if(  besch==NULL  ) {
-			//  maybe it was only renamed?
-			besch = fabrikbauer_t::get_fabesch(translator::compatibility_name(s));
-		}
-		if(  besch==NULL  ) {
-			dbg->warning( "fabrik_t::rdwr()", "Pak-file for factory '%s' missing!", s );
-			// we continue loading even if besch==NULL
-			welt->add_missing_paks( s, karte_t::MISSING_FACTORY );
-		}
-	}
-	pos_origin.rdwr(file);
-	// pos will be assigned after call to hausbauer_t::baue
-	file->rdwr_byte(rotate);
+	sint32 eingang_count = eingang.get_count();
+	sint32 ausgang_count = ausgang.get_count();
 
 	// now rebuilt information for received goods
 	file->rdwr_long(eingang_count);
@@ -1292,6 +1265,40 @@ DBG_DEBUG("fabrik_t::rdwr()","loading factory '%s'",s);
 			}
 		}
 	}
+}
+
+
+void fabrik_t::rdwr(loadsave_t *file)
+{
+	xml_tag_t f( file, "fabrik_t" );
+	sint32 spieler_n;
+	sint32 anz_lieferziele;
+
+	if(  file->is_saving()  ) {
+		anz_lieferziele = lieferziele.get_count();
+		const char *s = besch->get_name();
+		file->rdwr_str(s);
+	}
+	else {
+		char s[256];
+		file->rdwr_str(s, lengthof(s));
+DBG_DEBUG("fabrik_t::rdwr()","loading factory '%s'",s);
+		besch = fabrikbauer_t::get_fabesch(s);
+		if(  besch==NULL  ) {
+			//  maybe it was only renamed?
+			besch = fabrikbauer_t::get_fabesch(translator::compatibility_name(s));
+		}
+		if(  besch==NULL  ) {
+			dbg->warning( "fabrik_t::rdwr()", "Pak-file for factory '%s' missing!", s );
+			// we continue loading even if besch==NULL
+			welt->add_missing_paks( s, karte_t::MISSING_FACTORY );
+		}
+	}
+	pos_origin.rdwr(file);
+	// pos will be assigned after call to hausbauer_t::baue
+	file->rdwr_byte(rotate);
+
+	rdwr_goods(file);
 
 	// restore other information
 	spieler_n = welt->sp2num(besitzer_p);
@@ -1596,7 +1603,8 @@ sint8 fabrik_t::is_needed(const ware_besch_t *typ) const
 		if(  i.get_typ() == typ  ) {
 			// not needed (false) if overflowing or too much already sent
 			const bool transit_ok = welt->get_settings().get_factory_maximum_intransit_percentage() == 0 ? true : (i.transit * 100) < ((i.max >> fabrik_t::precision_bits) * welt->get_settings().get_factory_maximum_intransit_percentage());
-			return (i.menge < i.max)  &&  transit_ok;
+			const sint32 menge = distribution_pending ? i.menge_before_step : i.menge;
+			return (menge < i.max)  &&  transit_ok;
 		}
 	}
 	return -1;  // not needed here
@@ -1611,12 +1619,18 @@ bool fabrik_t::is_active_lieferziel( koord k ) const
 
 
 
-void fabrik_t::step(long delta_t)
+void fabrik_t::step_production(long delta_t)
 {
 	if(  delta_t==0  ) {
 		return;
 	}
 
+	// the suppliers distributing before our step() still see the old stock
+	for(  uint32 index = 0;  index < eingang.get_count();  index++  ) {
+		eingang[index].menge_before_step = eingang[index].menge;
+	}
+	distribution_pending = true;
+
 	// produce nothing/consumes nothing ...
 	if(  eingang.empty()  &&  ausgang.empty()  ) {
 		// power station? => produce power
@@ -1777,6 +1791,19 @@ void fabrik_t::step(long delta_t)
 	if(  !besch->is_electricity_producer()  ) {
 		power = 0;
 	}
+}
+
+
+/**
+ * Distributes the production of step_production() and does everything else
+ * touching other objects, thus must be called in fab_list order.
+ */
+void fabrik_t::step(long delta_t)
+{
+	if(  delta_t==0  ) {
+		return;
+	}
+	distribution_pending = false;
 
 	delta_sum += delta_t;
 	if(  delta_sum > PRODUCTION_DELTA_T  ) {
@@ -1936,7 +1963,7 @@ void fabrik_t::verteile_waren(const uint32 produkt)
 					// else deliver to non-overflown factory
 					if(  !welt->get_settings().get_just_in_time()  ) {
 						// without production stop when target overflowing, distribute to least overflow target
-						const sint32 fab_left = ziel_fab->get_eingang()[w].max - ziel_fab->get_eingang()[w].menge;
+						const sint32 fab_left = ziel_fab->get_eingang()[w].max - ziel_fab->get_eingang_menge_seen(w);
 						dist_list.insert_ordered( distribute_ware_t(nearby_halt, fab_left, ziel_fab->get_eingang()[w].max, (sint32)nearby_halt.halt->get_ware_fuer_zielpos(ausgang[produkt].get_typ(),ware.get_zielpos()), ware ), distribute_ware_t::compare);
 					}
 					else if(  needed > 0  ) {
@@ -93,7 +93,7 @@ private:
 	/// clears statistics, transit, and weighted_sum_storage
 	void init_stats();
 public:
-	ware_production_t() : type(NULL), menge(0), max(0), transit(0), index_offset(0)
+	ware_production_t() : type(NULL), menge(0), max(0), transit(0), menge_before_step(0), index_offset(0)
 	{
 		init_stats();
 	}
@@ -126,6 +126,9 @@ public:
 	sint32 max;
 	sint32 transit;
 
+	// menge before the consumption of the current step, see fabrik_t::get_eingang_menge_seen()
+	sint32 menge_before_step;
+
 	uint32 index_offset; // used for haltlist and lieferziele searches in verteile_waren to produce round robin results
 };
 
@@ -282,6 +285,9 @@ private:
 	// true, if the factory did produce enough in the last step to require power
 	bool currently_producing;
 
+	// true between step_production() and step()
+	bool distribution_pending;
+
 	// power that can be currently drawn from this station (or the amount delivered)
 	uint32 power;
 
@@ -573,6 +579,20 @@ public:
 
 	sint32 liefere_an(const ware_besch_t *, sint32 menge);
 
+	/**
+	 * Production and consumption of this step. Only changes this factory,
+	 * so it may run in parallel for all factories; step() must follow.
+	 */
+	void step_production(long delta_t);
+
+	/**
+	 * Stock of an input as seen by the distribution of the suppliers.
+	 * Between step_production() and step() this is the stock before the
+	 * consumption of this step. So each supplier sees the same stock as when
+	 * every factory did its production right before its distribution.
+	 */
+	sint32 get_eingang_menge_seen(uint32 index) const { return distribution_pending ? eingang[index].menge_before_step : eingang[index].menge; }
+
 	void step(long delta_t);                  // fabrik muss auch arbeiten ("factory must also work")
 
 	void neuer_monat();
@@ -602,6 +622,12 @@ public:
 
 	void rdwr(loadsave_t *file);
 
+	/**
+	 * Saves or loads only the stock of the input and output goods, as in rdwr().
+	 * Used to resync a factory in network games.
+	 */
+	void rdwr_goods(loadsave_t *file);
+
 	/*
 	 * Fills the vector with the koords of the tiles.
 	 */
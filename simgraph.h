@@ -17,6 +17,7 @@
 extern int large_font_ascent;
 extern int large_font_total_height;
 
+#include "simtypes.h"
 #include "simcolor.h"
 #include "unicode.h"
 
@@ -98,6 +99,36 @@ void register_image(struct bild_t*);
 // delete all images above a certain number ...
 void display_free_all_images_above( unsigned above );
 
+// limit for the zoomed and recoded copies of the images in bytes (0 = unlimited)
+void display_set_image_cache_limit( size_t bytes );
+void display_get_image_cache_stats( uint64 &hits, uint64 &misses, size_t &bytes );
+
+/*
+ * After a change of the zoom or the colours (and at startup) the images to
+ * be drawn are collected first: while collecting, the image routines only
+ * note the needed copies and nothing is drawn. display_prepare_images()
+ * then makes these copies with several threads, up to the cache limit.
+ * progress is called with the number of images done so far.
+ */
+bool display_images_need_prepare();
+void display_collect_images( bool on );
+void display_prepare_images( void (*progress)(unsigned done, unsigned total) );
+
+/*
+ * A copy of the ground drawn in the area x, y, w, h of the world view, so it
+ * must only be drawn again where it changed. begin() returns false if there
+ * is no cache; a different state or a zoom or colour change invalidates it all,
+ * a different origin (the position of the world on the screen) moves it.
+ * next_invalid() returns the invalid rectangles, which must then be drawn and
+ * stored, before restore() copies the ground back for the next frame.
+ */
+bool display_ground_cache_begin( KOORD_VAL x, KOORD_VAL y, KOORD_VAL w, KOORD_VAL h, int origin_x, int origin_y, unsigned state );
+void display_ground_cache_invalidate( KOORD_VAL x1, KOORD_VAL y1, KOORD_VAL x2, KOORD_VAL y2 );
+void display_ground_cache_invalidate_img( unsigned bild, KOORD_VAL x, KOORD_VAL y );
+bool display_ground_cache_next_invalid( KOORD_VAL &x, KOORD_VAL &y, KOORD_VAL &w, KOORD_VAL &h );
+void display_ground_cache_store( KOORD_VAL x, KOORD_VAL y, KOORD_VAL w, KOORD_VAL h );
+void display_ground_cache_restore( KOORD_VAL x, KOORD_VAL y, KOORD_VAL w, KOORD_VAL h );
+
 // unzoomed offsets
 void display_set_base_image_offset( unsigned bild, KOORD_VAL xoff, KOORD_VAL yoff );
 void display_get_base_image_offset( unsigned bild, KOORD_VAL *xoff, KOORD_VAL *yoff, KOORD_VAL *xw, KOORD_VAL *yw );
@@ -283,6 +314,13 @@ void draw_bezier(KOORD_VAL Ax, KOORD_VAL Ay, KOORD_VAL Bx, KOORD_VAL By, KOORD_V
 void display_set_clip_wh(KOORD_VAL x, KOORD_VAL y, KOORD_VAL w, KOORD_VAL h);
 clip_dimension display_get_clip_wh();
 
+/**
+ * Selects the clipping, dirty tiles and colour maps used by the calling thread.
+ * Thread 0 is the main thread; the others are for drawing strips of the world in parallel.
+ * @param strip true while drawing a strip of the world
+ */
+void display_select_thread(int nr, bool strip);
+
 void display_snapshot( int x, int y, int w, int h );
 
 #if COLOUR_DEPTH != 0
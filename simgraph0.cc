@@ -140,6 +140,10 @@ void display_set_clip_wh(KOORD_VAL, KOORD_VAL, KOORD_VAL, KOORD_VAL)
 {
 }
 
+void display_select_thread(int, bool)
+{
+}
+
 void display_scroll_band(const KOORD_VAL, const KOORD_VAL, const KOORD_VAL)
 {
 }
@@ -311,6 +315,56 @@ void display_free_all_images_above( unsigned)
 {
 }
 
+void display_set_image_cache_limit( size_t )
+{
+}
+
+void display_get_image_cache_stats( uint64 &hits, uint64 &misses, size_t &bytes )
+{
+	hits = 0;
+	misses = 0;
+	bytes = 0;
+}
+
+bool display_images_need_prepare()
+{
+	return false;
+}
+
+void display_collect_images( bool )
+{
+}
+
+void display_prepare_images( void (*)(unsigned, unsigned) )
+{
+}
+
+bool display_ground_cache_begin( KOORD_VAL, KOORD_VAL, KOORD_VAL, KOORD_VAL, int, int, unsigned )
+{
+	return false;
+}
+
+void display_ground_cache_invalidate( KOORD_VAL, KOORD_VAL, KOORD_VAL, KOORD_VAL )
+{
+}
+
+void display_ground_cache_invalidate_img( unsigned, KOORD_VAL, KOORD_VAL )
+{
+}
+
+bool display_ground_cache_next_invalid( KOORD_VAL &, KOORD_VAL &, KOORD_VAL &, KOORD_VAL & )
+{
+	return false;
+}
+
+void display_ground_cache_store( KOORD_VAL, KOORD_VAL, KOORD_VAL, KOORD_VAL )
+{
+}
+
+void display_ground_cache_restore( KOORD_VAL, KOORD_VAL, KOORD_VAL, KOORD_VAL )
+{
+}
+
 void simgraph_exit()
 {
 	dr_os_close();
@@ -18,6 +18,8 @@
 #include "simdebug.h"
 #include "besch/bild_besch.h"
 #include "unicode.h"
+#include "simgraph16_kernels.h"
+#include "utils/simthread.h"
 #include "simticker.h"
 
 
@@ -51,6 +53,18 @@
 
 // currently just redrawing/rezooming
 static pthread_mutex_t rezoom_recode_img_mutex;
+// image_cache_bytes and the images taken by display_prepare_images()
+static pthread_mutex_t image_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+#define MAX_DISPLAY_THREADS MULTI_THREAD
+#else
+#define THREAD_LOCAL
+#define MAX_DISPLAY_THREADS 1
 #endif
 
 #include "simgraph.h"
@@ -58,11 +72,6 @@ static pthread_mutex_t rezoom_recode_img_mutex;
 // undefine for debugging the update routines
 //#define DEBUG_FLUSH_BUFFER
 
-/*
- * Hajo: RGB 1555
- */
-typedef uint16 PIXVAL;
-
 
 #ifdef USE_SOFTPOINTER
 static int softpointer = -1;
@@ -79,12 +88,7 @@ int old_my = -1;
 #endif
 
 
-/*
- * Hajo: Current clipping rectangle
- */
-static clip_dimension clip_rect;
-
-// and the variables for polygon clipping
+// the variables for polygon clipping
 
 /*
  * struct to hold the information about visible area
@@ -98,10 +102,6 @@ struct xrange {
 };
 
 #define MAX_POLY_CLIPS 6
-static xrange      xranges[MAX_POLY_CLIPS];
-static uint8       clip_ribi[MAX_POLY_CLIPS];
-static int number_of_clips =0;
-static uint8 active_ribi = 15; // set all to active
 
 
 /* Flag, if we have Unicode font => do unicode (UTF8) support! *
@@ -127,21 +127,21 @@ int large_font_total_height = 11;
  * 0x0000 - 0x7FFF: RGB colors
  * 0x8000 - 0x800F: Player colors
  * 0x8010 -       : Day&Night special colors
+ * One more entry, since the AVX2 routines read behind the used index.
  */
-static PIXVAL rgbmap_day_night[RGBMAPSIZE];
+static PIXVAL rgbmap_day_night[RGBMAPSIZE+1];
 
 
 /*
  * Hajo: same as rgbmap_day_night, but always daytime colors
  */
-static PIXVAL rgbmap_all_day[RGBMAPSIZE];
-
+static PIXVAL rgbmap_all_day[RGBMAPSIZE+1];
 
-/**
- * Hajo:used by pixel copy functions, is one of rgbmap_day_night
- * rgbmap_all_day
+/*
+ * These two maps are used by the main thread; the other drawing threads
+ * have copies (see copy_rgbmaps_to_threads()). The current map of the
+ * pixel copy functions is in display_thread_t.
  */
-static PIXVAL *rgbmap_current = 0;
 
 
 /*
@@ -182,6 +182,8 @@ struct imd {
 
 	uint8 recode_flags; // divers flags for recoding
 	uint8 player_flags; // 128 = free/needs recode, otherwise coded to this color in player_data
+	uint8 collect_flags; // the copies found needed by display_collect_images()
+	uint8 collect_player; // and the player for COLLECT_PLAYER
 
 	PIXVAL* data; // current data, zoomed and adapted to output format RGB 555 or RGB 565
 
@@ -190,6 +192,8 @@ struct imd {
 	PIXVAL* base_data; // original image data
 
 	PIXVAL* player_data; // current data coded for player1 (since many building belong to him)
+
+	uint32 last_used; // frame in which the image was drawn last (for freeing unused copies)
 };
 
 // flags for recoding
@@ -201,6 +205,11 @@ struct imd {
 
 #define NEED_PLAYER_RECODE (128)
 
+// flags for collecting the images to prepare
+#define COLLECT_ZOOM (1)
+#define COLLECT_NORMAL (2)
+#define COLLECT_PLAYER (4)
+
 
 static KOORD_VAL disp_width  = 640;
 static KOORD_VAL disp_actual_width  = 640;
@@ -224,6 +233,32 @@ static image_id anz_images = 0;
 static image_id alloc_images = 0;
 
 
+/*
+ * The zoomed and recoded copies (data, zoom_data and player_data) are made
+ * when an image is drawn first and then kept. With a limit, the copies of the
+ * images unused for the longest time are freed again at the end of a frame.
+ * Hits count the drawings from existing copies, misses the recodings.
+ */
+static size_t image_cache_limit = 0;	// in bytes, 0 = unlimited
+static size_t image_cache_bytes = 0;
+static size_t image_cache_floor = 0;	// left after the last freeing, see display_flush_buffer()
+static uint32 image_cache_frame = 0;
+static uint64 image_cache_hits = 0;
+static uint64 image_cache_misses = 0;
+
+/*
+ * After a change of the zoom or the colours all copies are outdated. Then
+ * the images to be drawn are collected first and their copies are made by
+ * several threads in display_prepare_images(), instead of one by one while
+ * drawing. Also needed at startup, when there are no copies yet.
+ */
+static bool images_need_prepare = true;
+static bool collecting_images = false;
+
+// the cached ground of the world view is outdated too (see display_ground_cache_begin())
+static bool ground_cache_outdated = true;
+
+
 /*
  * Output framebuffer
  */
@@ -638,41 +673,6 @@ static bool clip_lr(KOORD_VAL *x, KOORD_VAL *w, const KOORD_VAL left, const KOOR
 }
 
 
-/**
- * Ermittelt Clipping Rechteck
- * @author Hj. Malthaner
- */
-clip_dimension display_get_clip_wh()
-{
-	return clip_rect;
-}
-
-
-/**
- * Setzt Clipping Rechteck
- * @author Hj. Malthaner
- *
- * here, a pixel at coordinate xp is displayed if
- *  clip. x <= xp < clip.xx
- * the right-most pixel of an image located at xp with width w is displayed if
- *  clip.x < xp+w <= clip.xx
- * analogously for the y coordinate
- */
-void display_set_clip_wh(KOORD_VAL x, KOORD_VAL y, KOORD_VAL w, KOORD_VAL h)
-{
-	clip_wh(&x, &w, 0, disp_width);
-	clip_wh(&y, &h, 0, disp_height);
-
-	clip_rect.x = x;
-	clip_rect.y = y;
-	clip_rect.w = w;
-	clip_rect.h = h;
-
-	clip_rect.xx = x + w; // watch out, clips to KOORD_VAL max
-	clip_rect.yy = y + h; // watch out, clips to KOORD_VAL max
-}
-
-
 class clip_line_t {
 private:
 	// line from (x0,y0) to (x1 y1)
@@ -810,7 +810,94 @@ public:
 };
 
 
-static clip_line_t poly_clips[MAX_POLY_CLIPS];
+/*
+ * The state of a thread drawing on the screen. The world is drawn in
+ * vertical strips by several threads, each with its own clipping, dirty
+ * tiles and player colours. Thread 0 is the main thread.
+ */
+struct display_thread_t {
+	// Hajo: Current clipping rectangle
+	clip_dimension clip_rect;
+
+	xrange       xranges[MAX_POLY_CLIPS];
+	uint8        clip_ribi[MAX_POLY_CLIPS];
+	clip_line_t  poly_clips[MAX_POLY_CLIPS];
+	int number_of_clips;
+	uint8 active_ribi;
+
+	// marked dirty tiles, the ones of the other threads are merged by display_flush_buffer()
+	uint32 *tile_dirty;
+	// drawing a strip of the world: dirty images are marked also outside the clip rect
+	bool strip;
+
+	// the colour maps with the last used player colours, see activate_player_color()
+	PIXVAL *rgbmap_day_night;
+	PIXVAL *rgbmap_all_day;
+	PIXVAL *rgbmap_current;
+	uint8 player_day;
+	uint8 player_night;
+
+	// the images drawn in this frame (marked in image_used) and the drawings from
+	// existing copies; display_flush_buffer() sets last_used and adds the hits
+	uint8 image_used[65536/8];
+	image_id used_images[65536];
+	uint32 used_count;
+	uint64 image_hits;
+};
+
+static display_thread_t display_threads[MAX_DISPLAY_THREADS];
+
+// the state of the calling thread
+static THREAD_LOCAL display_thread_t *disp_thread = display_threads;
+
+
+// notes the image as drawn in this frame by the calling thread
+static inline void mark_image_used(const image_id n)
+{
+	display_thread_t *const t = disp_thread;
+	const uint8 bit = 1 << (n & 7);
+	if(  (t->image_used[n >> 3] & bit) == 0  ) {
+		t->image_used[n >> 3] |= bit;
+		t->used_images[t->used_count++] = n;
+	}
+}
+
+
+/**
+ * Ermittelt Clipping Rechteck
+ * @author Hj. Malthaner
+ */
+clip_dimension display_get_clip_wh()
+{
+	return disp_thread->clip_rect;
+}
+
+
+/**
+ * Setzt Clipping Rechteck
+ * @author Hj. Malthaner
+ *
+ * here, a pixel at coordinate xp is displayed if
+ *  clip. x <= xp < clip.xx
+ * the right-most pixel of an image located at xp with width w is displayed if
+ *  clip.x < xp+w <= clip.xx
+ * analogously for the y coordinate
+ */
+void display_set_clip_wh(KOORD_VAL x, KOORD_VAL y, KOORD_VAL w, KOORD_VAL h)
+{
+	clip_wh(&x, &w, 0, disp_width);
+	clip_wh(&y, &h, 0, disp_height);
+
+	disp_thread->clip_rect.x = x;
+	disp_thread->clip_rect.y = y;
+	disp_thread->clip_rect.w = w;
+	disp_thread->clip_rect.h = h;
+
+	disp_thread->clip_rect.xx = x + w; // watch out, clips to KOORD_VAL max
+	disp_thread->clip_rect.yy = y + h; // watch out, clips to KOORD_VAL max
+}
+
+
 
 
 /*
@@ -820,10 +907,10 @@ static clip_line_t poly_clips[MAX_POLY_CLIPS];
  */
 void add_poly_clip(int x0,int y0, int x1, int y1, int ribi)
 {
-	if (number_of_clips < MAX_POLY_CLIPS) {
-		poly_clips[number_of_clips].clip_from_to(x0,y0,x1,y1,ribi&16);
-		clip_ribi[number_of_clips] = ribi&15;
-		number_of_clips++;
+	if (disp_thread->number_of_clips < MAX_POLY_CLIPS) {
+		disp_thread->poly_clips[disp_thread->number_of_clips].clip_from_to(x0,y0,x1,y1,ribi&16);
+		disp_thread->clip_ribi[disp_thread->number_of_clips] = ribi&15;
+		disp_thread->number_of_clips++;
 	}
 }
 
@@ -833,8 +920,8 @@ void add_poly_clip(int x0,int y0, int x1, int y1, int ribi)
  */
 void clear_all_poly_clip()
 {
-	number_of_clips = 0;
-	active_ribi = 15; // set all to active
+	disp_thread->number_of_clips = 0;
+	disp_thread->active_ribi = 15; // set all to active
 }
 
 
@@ -844,7 +931,7 @@ void clear_all_poly_clip()
  */
 void activate_ribi_clip(int ribi)
 {
-	active_ribi = ribi;
+	disp_thread->active_ribi = ribi;
 }
 
 
@@ -853,9 +940,9 @@ void activate_ribi_clip(int ribi)
  */
 static inline void init_ranges(int y)
 {
-	for (uint8 i=0; i<number_of_clips; i++) {
-		if (clip_ribi[i] & active_ribi) {
-			poly_clips[i].get_x_range(y,xranges[i], active_ribi & 16);
+	for (uint8 i=0; i<disp_thread->number_of_clips; i++) {
+		if (disp_thread->clip_ribi[i] & disp_thread->active_ribi) {
+			disp_thread->poly_clips[i].get_x_range(y,disp_thread->xranges[i], disp_thread->active_ribi & 16);
 		}
 	}
 }
@@ -868,11 +955,11 @@ static inline void init_ranges(int y)
  */
 inline void get_xrange_and_step_y(int &xmin, int &xmax)
 {
-	xmin = clip_rect.x;
-	xmax = clip_rect.xx;
-	for (uint8 i=0; i<number_of_clips; i++) {
-		if (clip_ribi[i] & active_ribi) {
-			poly_clips[i].inc_y(xranges[i], xmin, xmax);
+	xmin = disp_thread->clip_rect.x;
+	xmax = disp_thread->clip_rect.xx;
+	for (uint8 i=0; i<disp_thread->number_of_clips; i++) {
+		if (disp_thread->clip_ribi[i] & disp_thread->active_ribi) {
+			disp_thread->poly_clips[i].inc_y(disp_thread->xranges[i], xmin, xmax);
 		}
 	}
 }
@@ -891,7 +978,7 @@ static inline void mark_tile_dirty(const int x, const int y)
 #if 0
 	assert(bit / 8 < tile_buffer_length);
 #endif
-	((uint8*)tile_dirty)[bit >> 3] |= 1 << (bit & 7);
+	((uint8*)disp_thread->tile_dirty)[bit >> 3] |= 1 << (bit & 7);
 }
 
 
@@ -918,11 +1005,12 @@ static void mark_rect_dirty_nc(KOORD_VAL x1, KOORD_VAL y1, KOORD_VAL x2, KOORD_V
 	assert(y2 < tile_lines);
 #endif
 
+	uint8 *const dirty = (uint8 *)disp_thread->tile_dirty;
 	for(  ;  y1 <= y2;  y1++  ) {
 		int bit = y1 * tile_buffer_per_line + x1;
 		const int end = bit + x2 - x1;
 		do {
-			((uint8*)tile_dirty)[bit >> 3] |= 1 << (bit & 7);
+			dirty[bit >> 3] |= 1 << (bit & 7);
 		} while(  ++bit <= end  );
 	}
 }
@@ -955,19 +1043,24 @@ void mark_rect_dirty_wc(KOORD_VAL x1, KOORD_VAL y1, KOORD_VAL x2, KOORD_VAL y2)
 
 void mark_rect_dirty_clip(KOORD_VAL x1, KOORD_VAL y1, KOORD_VAL x2, KOORD_VAL y2)
 {
+	if(  disp_thread->strip  ) {
+		// the thread of the neighbouring strip may find the image no longer dirty
+		mark_rect_dirty_wc( x1, y1, x2, y2 );
+		return;
+	}
 	// inside clip_rect?
-	if(  x2 >= clip_rect.x  &&  y2 >= clip_rect.y  &&  x1 < clip_rect.xx  &&  y1 < clip_rect.yy  ) {
-		if(  x1 < clip_rect.x  ) {
-			x1 = clip_rect.x;
+	if(  x2 >= disp_thread->clip_rect.x  &&  y2 >= disp_thread->clip_rect.y  &&  x1 < disp_thread->clip_rect.xx  &&  y1 < disp_thread->clip_rect.yy  ) {
+		if(  x1 < disp_thread->clip_rect.x  ) {
+			x1 = disp_thread->clip_rect.x;
 		}
-		if(  y1 < clip_rect.y  ) {
-			y1 = clip_rect.y;
+		if(  y1 < disp_thread->clip_rect.y  ) {
+			y1 = disp_thread->clip_rect.y;
 		}
-		if(  x2 > clip_rect.xx  ) {
-			x2 = clip_rect.xx ;
+		if(  x2 > disp_thread->clip_rect.xx  ) {
+			x2 = disp_thread->clip_rect.xx ;
 		}
-		if(  y2 > clip_rect.yy  ) {
-			y2 = clip_rect.yy;
+		if(  y2 > disp_thread->clip_rect.yy  ) {
+			y2 = disp_thread->clip_rect.yy;
 		}
 		mark_rect_dirty_nc( x1, y1, x2, y2 );
 	}
@@ -984,6 +1077,27 @@ void mark_screen_dirty()
 }
 
 
+// (re)allocates the dirty tiles of the other drawing threads
+static void init_thread_tile_dirty()
+{
+	display_threads[0].tile_dirty = tile_dirty;
+	for(  int t = 1;  t < MAX_DISPLAY_THREADS;  t++  ) {
+		guarded_free( display_threads[t].tile_dirty );
+		display_threads[t].tile_dirty = MALLOCN( uint32, tile_buffer_length );
+		MEMZERON( display_threads[t].tile_dirty, tile_buffer_length );
+	}
+}
+
+
+void display_select_thread(int nr, bool strip)
+{
+	if(  nr >= 0  &&  nr < MAX_DISPLAY_THREADS  ) {
+		disp_thread = display_threads + nr;
+		disp_thread->strip = strip;
+	}
+}
+
+
 /**
  * the area of this image need update
  * @author Hj. Malthaner
@@ -1008,6 +1122,19 @@ void display_mark_img_dirty(unsigned bild, KOORD_VAL xp, KOORD_VAL yp)
  * They are derived from a base image, which may need zooming too
  */
 
+// the copies are also counted by the threads of display_prepare_images()
+static void add_image_cache_bytes(sint64 bytes)
+{
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &image_cache_mutex );
+#endif
+	image_cache_bytes += bytes;
+#if MULTI_THREAD>1
+	pthread_mutex_unlock( &image_cache_mutex );
+#endif
+}
+
+
 /**
  * Rezooms all images
  * @author Hj. Malthaner
@@ -1023,6 +1150,8 @@ static void rezoom(void)
 		images[n].recode_flags |= FLAG_NORMAL_RECODE;
 		images[n].player_flags = NEED_PLAYER_RECODE;	// color will be set next time
 	}
+	images_need_prepare = true;
+	ground_cache_outdated = true;
 }
 
 
@@ -1056,33 +1185,51 @@ int zoom_factor_down()
 }
 
 
-static uint8 player_night=0xFF;
-static uint8 player_day=0xFF;
+/*
+ * The maps of the main thread have changed: the other drawing threads
+ * get copies, together with the player colours in them.
+ * Must not be called while they are drawing.
+ */
+static void copy_rgbmaps_to_threads()
+{
+	for(  int t = 1;  t < MAX_DISPLAY_THREADS;  t++  ) {
+		display_thread_t *const dt = display_threads + t;
+		if(  dt->rgbmap_day_night  ) {
+			memcpy( dt->rgbmap_day_night, rgbmap_day_night, sizeof(rgbmap_day_night) );
+			memcpy( dt->rgbmap_all_day, rgbmap_all_day, sizeof(rgbmap_all_day) );
+			dt->player_day = display_threads[0].player_day;
+			dt->player_night = display_threads[0].player_night;
+		}
+	}
+}
+
+
 static void activate_player_color(sint8 player_nr, bool daynight)
 {
+	display_thread_t *const t = disp_thread;
 	// cahces the last settings
 	if(!daynight) {
-		if(player_day!=player_nr) {
+		if(t->player_day!=player_nr) {
 			int i;
-			player_day = player_nr;
+			t->player_day = player_nr;
 			for(i=0;  i<8;  i++  ) {
-				rgbmap_all_day[0x8000+i] = specialcolormap_all_day[player_offsets[player_day][0]+i];
-				rgbmap_all_day[0x8008+i] = specialcolormap_all_day[player_offsets[player_day][1]+i];
+				t->rgbmap_all_day[0x8000+i] = specialcolormap_all_day[player_offsets[t->player_day][0]+i];
+				t->rgbmap_all_day[0x8008+i] = specialcolormap_all_day[player_offsets[t->player_day][1]+i];
 			}
 		}
-		rgbmap_current = rgbmap_all_day;
+		t->rgbmap_current = t->rgbmap_all_day;
 	}
 	else {
 		// changing colortable
-		if(player_night!=player_nr) {
+		if(t->player_night!=player_nr) {
 			int i;
-			player_night = player_nr;
+			t->player_night = player_nr;
 			for(i=0;  i<8;  i++  ) {
-				rgbmap_day_night[0x8000+i] = specialcolormap_day_night[player_offsets[player_night][0]+i];
-				rgbmap_day_night[0x8008+i] = specialcolormap_day_night[player_offsets[player_night][1]+i];
+				t->rgbmap_day_night[0x8000+i] = specialcolormap_day_night[player_offsets[t->player_night][0]+i];
+				t->rgbmap_day_night[0x8008+i] = specialcolormap_day_night[player_offsets[t->player_night][1]+i];
 			}
 		}
-		rgbmap_current = rgbmap_day_night;
+		t->rgbmap_current = t->rgbmap_day_night;
 	}
 }
 
@@ -1100,6 +1247,8 @@ static void recode(void)
 		images[n].recode_flags |= FLAG_NORMAL_RECODE;
 		images[n].player_flags = NEED_PLAYER_RECODE;
 	}
+	images_need_prepare = true;
+	ground_cache_outdated = true;
 }
 
 
@@ -1109,6 +1258,7 @@ static void recode(void)
  */
 static void recode_img_src_target(KOORD_VAL h, PIXVAL *src, PIXVAL *target)
 {
+	const PIXVAL *const rgbmap = disp_thread->rgbmap_day_night;
 	if (h > 0) {
 		do {
 			uint16 runlen = *target++ = *src++;
@@ -1120,7 +1270,7 @@ static void recode_img_src_target(KOORD_VAL h, PIXVAL *src, PIXVAL *target)
 				runlen = *target++ = *src++;
 				while (runlen--) {
 					// now just convert the color pixels
-					*target++ = rgbmap_day_night[*src++];
+					*target++ = rgbmap[*src++];
 				}
 			} while ((runlen = *target++ = *src++));
 		} while (--h);
@@ -1132,20 +1282,33 @@ static void recode_img_src_target(KOORD_VAL h, PIXVAL *src, PIXVAL *target)
  * Handles the conversion of an image to the output color
  * @author prissi
  */
-static void recode_normal_img(const unsigned int n)
+static void recode_normal_img_aux(const unsigned int n)
 {
-#if MULTI_THREAD>1
-	pthread_mutex_lock( &rezoom_recode_img_mutex );
-#endif
 	PIXVAL *src = images[n].zoom_data != NULL ? images[n].zoom_data : images[n].base_data;
 
 	if (images[n].data == NULL) {
 		images[n].data = MALLOCN(PIXVAL, images[n].len);
+		add_image_cache_bytes( images[n].len * sizeof(PIXVAL) );
 	}
 	// now do normal recode
 	activate_player_color( 0, true );
 	recode_img_src_target(images[n].h, src, images[n].data);
 	images[n].recode_flags &= ~FLAG_NORMAL_RECODE;
+}
+
+
+static void recode_normal_img(const unsigned int n)
+{
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &rezoom_recode_img_mutex );
+	if(  (images[n].recode_flags & FLAG_NORMAL_RECODE) == 0  ) {
+		// another thread did already the recoding
+		pthread_mutex_unlock( &rezoom_recode_img_mutex );
+		return;
+	}
+#endif
+	image_cache_misses++;
+	recode_normal_img_aux(n);
 #if MULTI_THREAD>1
 	pthread_mutex_unlock( &rezoom_recode_img_mutex );
 #endif
@@ -1160,6 +1323,7 @@ static void recode_normal_img(const unsigned int n)
  */
 static void recode_img_src_target_color(KOORD_VAL h, PIXVAL *src, PIXVAL *target)
 {
+	const PIXVAL *const rgbmap = disp_thread->rgbmap_day_night;
 	if (h > 0) {
 		do {
 			uint16 runlen = *target++ = *src++;
@@ -1171,7 +1335,7 @@ static void recode_img_src_target_color(KOORD_VAL h, PIXVAL *src, PIXVAL *target
 				runlen = *target++ = *src++;
 				// now just convert the color pixels
 				while (runlen--) {
-					*target++ = rgbmap_day_night[*src++];
+					*target++ = rgbmap[*src++];
 				}
 				// next clea run or zero = end
 			} while ((runlen = *target++ = *src++));
@@ -1184,24 +1348,44 @@ static void recode_img_src_target_color(KOORD_VAL h, PIXVAL *src, PIXVAL *target
  * Handles the conversion of an image to the output color
  * @author prissi
  */
-static void recode_color_img(const unsigned int n, const unsigned char player_nr)
+static void recode_color_img_aux(const unsigned int n, const unsigned char player_nr)
 {
-	// Hajo: may this image be zoomed
-#if MULTI_THREAD>1
-	pthread_mutex_lock( &rezoom_recode_img_mutex );
-#endif
 	PIXVAL *src = images[n].zoom_data != NULL ? images[n].zoom_data : images[n].base_data;
 
-	images[n].player_flags = player_nr;
 	if(  images[n].player_data == NULL  ) {
 		images[n].player_data = MALLOCN(PIXVAL, images[n].len);
+		add_image_cache_bytes( images[n].len * sizeof(PIXVAL) );
 	}
 	// contains now the player color ...
 	activate_player_color( player_nr, true );
 	recode_img_src_target_color(images[n].h, src, images[n].player_data );
+	// only now player_data is ready for other threads
+	images[n].player_flags = player_nr;
+}
+
+
+/**
+ * Recodes the image for player_nr, unless it is cached already
+ * @return true if player_data is the image for player_nr
+ */
+static bool recode_color_img(const unsigned int n, const unsigned char player_nr)
+{
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &rezoom_recode_img_mutex );
+#endif
+	// test again, another thread may have cached this image meanwhile, maybe for another player
+	const uint8 cached_nr = images[n].player_flags & (~NEED_PLAYER_RECODE);
+	if(  cached_nr == 0  ) {
+		image_cache_misses++;
+		recode_color_img_aux(n, player_nr);
+	}
+	else if(  cached_nr == player_nr  ) {
+		disp_thread->image_hits++;
+	}
 #if MULTI_THREAD>1
 	pthread_mutex_unlock( &rezoom_recode_img_mutex );
 #endif
+	return cached_nr == 0  ||  cached_nr == player_nr;
 }
 
 #endif
@@ -1261,24 +1445,49 @@ PIXVAL inline zoomin_pixel(uint8 *p, uint8* pab, uint8 *prl, uint8* pdia)
 }
 
 
+// frees the zoomed and recoded copies of an image (the caller holds the mutex)
+static void free_image_copies(const image_id n)
+{
+	const sint64 size = images[n].len * sizeof(PIXVAL);
+	if (images[n].zoom_data != NULL) {
+		guarded_free(images[n].zoom_data);
+		images[n].zoom_data = NULL;
+		add_image_cache_bytes( -size );
+	}
+	if (images[n].data != NULL) {
+		guarded_free(images[n].data);
+		images[n].data = NULL;
+		add_image_cache_bytes( -size );
+	}
+	if (images[n].player_data != NULL) {
+		guarded_free(images[n].player_data);
+		images[n].player_data = NULL;
+		add_image_cache_bytes( -size );
+	}
+}
+
+
+// the buffers for unpacking and resampling an image
+struct rezoom_buffer_t {
+	uint8 *baseimage;
+	PIXVAL *baseimage2;
+	uint32 size;
+};
+
+// used while drawing (with the mutex)
+static rezoom_buffer_t rezoom_buffer = { NULL, NULL, 0 };
+
+
 /**
  * Convert base image data to actual image size
  * Uses averages of all sampled points to get the "real" value
  * Blurs a bit
  * @author prissi
  */
-static void rezoom_img(const image_id n)
+static void rezoom_img_aux(const image_id n, rezoom_buffer_t &buffer)
 {
 	// Hajo: may this image be zoomed
 	if (n < anz_images && images[n].base_h > 0) {
-#if MULTI_THREAD>1
-		pthread_mutex_lock( &rezoom_recode_img_mutex );
-		if(  (images[n].recode_flags & FLAG_REZOOM) == 0  ) {
-			// other routine did already the rezooming ...
-			pthread_mutex_unlock( &rezoom_recode_img_mutex );
-			return;
-		}
-#endif
 		// we may need night conversion afterwards
 		images[n].recode_flags &= ~FLAG_REZOOM;
 		images[n].recode_flags |= FLAG_NORMAL_RECODE;
@@ -1286,18 +1495,7 @@ static void rezoom_img(const image_id n)
 
 		//  we recalculate the len (since it may be larger than before)
 		// thus we have to free the old caches
-		if (images[n].zoom_data != NULL) {
-			guarded_free(images[n].zoom_data);
-			images[n].zoom_data = NULL;
-		}
-		if (images[n].data != NULL) {
-			guarded_free(images[n].data);
-			images[n].data = NULL;
-		}
-		if (images[n].player_data != NULL) {
-			guarded_free(images[n].player_data);
-			images[n].player_data = NULL;
-		}
+		free_image_copies(n);
 
 		// just restore original size?
 		if (tile_raster_width == base_tile_raster_width  ||  (images[n].recode_flags&FLAG_ZOOMABLE)==0) {
@@ -1322,9 +1520,6 @@ static void rezoom_img(const image_id n)
 				}
 				images[n].len = (uint32)(size_t)(sp-images[n].base_data);
 			}
-#if MULTI_THREAD>1
-			pthread_mutex_unlock( &rezoom_recode_img_mutex );
-#endif
 			return;
 		}
 
@@ -1337,9 +1532,9 @@ static void rezoom_img(const image_id n)
 
 		if (images[n].h > 0  &&  images[n].w > 0) {
 			// just recalculate the image in the new size
-			static uint8 *baseimage = NULL;
-			static uint32 size = 0;
-			static PIXVAL *baseimage2 = NULL;
+			uint8 *&baseimage = buffer.baseimage;
+			uint32 &size = buffer.size;
+			PIXVAL *&baseimage2 = buffer.baseimage2;
 			PIXVAL *src = images[n].base_data;
 			PIXVAL *dest = NULL;
 			// embed the baseimage in an image with margin ~ remainder
@@ -1717,6 +1912,7 @@ static void rezoom_img(const image_id n)
 				images[n].len = (uint32)(zoom_len/sizeof(PIXVAL));
 				images[n].zoom_data = MALLOCN(PIXVAL, images[n].len);
 				assert( images[n].zoom_data  );
+				add_image_cache_bytes( zoom_len );
 				memcpy( images[n].zoom_data, baseimage, zoom_len );
 			}
 		}
@@ -1727,6 +1923,22 @@ static void rezoom_img(const image_id n)
 //			}
 			images[n].h = 0;
 		}
+	}
+}
+
+
+static void rezoom_img(const image_id n)
+{
+	if(  n < anz_images  ) {
+#if MULTI_THREAD>1
+		pthread_mutex_lock( &rezoom_recode_img_mutex );
+		if(  (images[n].recode_flags & FLAG_REZOOM) == 0  ) {
+			// other routine did already the rezooming ...
+			pthread_mutex_unlock( &rezoom_recode_img_mutex );
+			return;
+		}
+#endif
+		rezoom_img_aux( n, rezoom_buffer );
 #if MULTI_THREAD>1
 		pthread_mutex_unlock( &rezoom_recode_img_mutex );
 #endif
@@ -1751,6 +1963,9 @@ static void calc_base_pal_from_night_shift(const int night)
 	const int day = 4 - night2;
 	unsigned int i;
 
+	// the cached ground has the old colours
+	ground_cache_outdated = true;
+
 	// constant multiplier 0,66 - dark night  255 will drop to 49, 55 to 10
 	//                     0,7  - dark, but all is visible     61        13
 	//                     0,73                                72        15
@@ -1797,7 +2012,7 @@ static void calc_base_pal_from_night_shift(const int night)
 		rgbmap_day_night[0x8000+i] = specialcolormap_day_night[player_offsets[0][0]+i];
 		rgbmap_day_night[0x8008+i] = specialcolormap_day_night[player_offsets[0][1]+i];
 	}
-	player_night = 0;
+	display_threads[0].player_night = 0;
 
 	// Lights
 	for (i = 0; i < LIGHT_COUNT; i++) {
@@ -1816,6 +2031,7 @@ static void calc_base_pal_from_night_shift(const int night)
 		rgbmap_day_night[0x8010 + i] =
 			get_system_color(R > 0 ? R : 0, G > 0 ? G : 0, B > 0 ? B : 0);
 	}
+	copy_rgbmaps_to_threads();
 
 	// convert to RGB xxx
 	recode();
@@ -1851,7 +2067,7 @@ void display_set_player_color_scheme(const int player, const COLOR_VAL col1, con
 		// set new player colors
 		player_offsets[player][0] = col1;
 		player_offsets[player][1] = col2;
-		if(player==player_day  ||  player==player_night) {
+		if(player==display_threads[0].player_day  ||  player==display_threads[0].player_night) {
 			// and recalculate map (and save it)
 			calc_base_pal_from_night_shift(0);
 			memcpy(rgbmap_all_day, rgbmap_day_night, RGBMAPSIZE * sizeof(PIXVAL));
@@ -1859,8 +2075,9 @@ void display_set_player_color_scheme(const int player, const COLOR_VAL col1, con
 				calc_base_pal_from_night_shift(night_shift);
 			}
 			// calc_base_pal_from_night_shift resets player_night to 0
-			player_day = player_night;
+			display_threads[0].player_day = display_threads[0].player_night;
 		}
+		copy_rgbmaps_to_threads();
 		recode();
 		mark_screen_dirty();
 	}
@@ -1916,6 +2133,9 @@ void register_image(struct bild_t* bild)
 	image->zoom_data = NULL;
 	image->data = NULL;
 	image->player_data = NULL;	// chaches data for one AI
+	image->last_used = 0;
+	image->collect_flags = 0;
+	image->collect_player = 0;
 
 	// since we do not recode them, we can work with the original data
 	image->base_data = bild->data;
@@ -1945,71 +2165,474 @@ void register_image(struct bild_t* bild)
 }
 
 
-// delete all images above a certain number ...
-// (mostly needed when changing climate zones)
-void display_free_all_images_above( unsigned above )
+// delete all images above a certain number ...
+// (mostly needed when changing climate zones)
+void display_free_all_images_above( unsigned above )
+{
+	while( above<anz_images) {
+		anz_images--;
+		free_image_copies( anz_images );
+	}
+}
+
+
+static int compare_last_used(const void *a, const void *b)
+{
+	const uint32 la = images[*(const image_id *)a].last_used;
+	const uint32 lb = images[*(const image_id *)b].last_used;
+	if(  la != lb  ) {
+		return la < lb ? -1 : 1;
+	}
+	return (int)*(const image_id *)a - (int)*(const image_id *)b;
+}
+
+
+/*
+ * Frees the copies of the images unused for the longest time until the
+ * cache is down to three quarters of the limit. The images drawn in the
+ * current frame are kept, even if they alone exceed the limit; then the
+ * cache must grow by a quarter of the limit before the next try.
+ */
+static void free_unused_image_copies()
+{
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &rezoom_recode_img_mutex );
+#endif
+	image_id *candidates = MALLOCN( image_id, anz_images );
+	uint32 count = 0;
+	for(  image_id n = 0;  n < anz_images;  n++  ) {
+		if(  images[n].last_used != image_cache_frame  &&  (images[n].data  ||  images[n].zoom_data  ||  images[n].player_data)  ) {
+			candidates[count++] = n;
+		}
+	}
+	qsort( candidates, count, sizeof(image_id), compare_last_used );
+
+	const size_t target = image_cache_limit - image_cache_limit / 4;
+	for(  uint32 i = 0;  i < count  &&  image_cache_bytes > target;  i++  ) {
+		const image_id n = candidates[i];
+		free_image_copies(n);
+		// remade on the next drawing
+		if(  (images[n].recode_flags & FLAG_ZOOMABLE)  &&  images[n].base_h > 0  ) {
+			images[n].recode_flags |= FLAG_REZOOM;
+		}
+		images[n].recode_flags |= FLAG_NORMAL_RECODE;
+		images[n].player_flags = NEED_PLAYER_RECODE;
+	}
+	image_cache_floor = image_cache_bytes;
+	guarded_free( candidates );
+#if MULTI_THREAD>1
+	pthread_mutex_unlock( &rezoom_recode_img_mutex );
+#endif
+}
+
+
+void display_set_image_cache_limit(size_t bytes)
+{
+	image_cache_limit = bytes;
+	image_cache_floor = 0;
+}
+
+
+void display_get_image_cache_stats(uint64 &hits, uint64 &misses, size_t &bytes)
+{
+	hits = image_cache_hits;
+	misses = image_cache_misses;
+	bytes = image_cache_bytes;
+}
+
+
+bool display_images_need_prepare()
+{
+	return images_need_prepare;
+}
+
+
+void display_collect_images(bool on)
+{
+	static clip_dimension saved_clip;
+	if(  on  ) {
+		// nothing else is drawn meanwhile
+		saved_clip = display_get_clip_wh();
+		display_set_clip_wh( 0, 0, 0, 0 );
+	}
+	else {
+		display_set_clip_wh( saved_clip.x, saved_clip.y, saved_clip.w, saved_clip.h );
+	}
+	collecting_images = on;
+}
+
+
+/*
+ * The collected images, which are prepared by several threads
+ */
+struct prepare_list_t {
+	image_id *images;
+	uint32 count;
+	uint32 next;	// the first image not taken by a thread
+	void (*progress)(unsigned done, unsigned total);
+};
+
+
+static bool prepare_next_image(prepare_list_t &list, rezoom_buffer_t &buffer)
+{
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &image_cache_mutex );
+#endif
+	// above the limit the remaining ones are made when drawn
+	const bool take = list.next < list.count  &&  (image_cache_limit == 0  ||  image_cache_bytes < image_cache_limit);
+	const image_id n = take ? list.images[list.next++] : 0;
+#if MULTI_THREAD>1
+	pthread_mutex_unlock( &image_cache_mutex );
+#endif
+	if(  !take  ) {
+		return false;
+	}
+
+	// each image is taken by only one thread, so no locking is needed
+	imd &image = images[n];
+	if(  image.recode_flags & FLAG_REZOOM  ) {
+		rezoom_img_aux( n, buffer );
+	}
+	if(  (image.collect_flags & COLLECT_NORMAL)  &&  (image.recode_flags & FLAG_NORMAL_RECODE)  ) {
+		recode_normal_img_aux(n);
+	}
+	if(  (image.collect_flags & COLLECT_PLAYER)  &&  (image.player_flags & (~NEED_PLAYER_RECODE)) == 0  ) {
+		recode_color_img_aux( n, image.collect_player );
+	}
+	return true;
+}
+
+
+static void prepare_images_part(void *args, int nr)
+{
+	prepare_list_t &list = *(prepare_list_t *)args;
+	if(  nr == 0  ) {
+		// the calling thread also updates the progress
+		const uint32 step = max( list.count / 64, 1u );
+		uint32 shown = 0;
+		while(  prepare_next_image( list, rezoom_buffer )  ) {
+			if(  list.progress  &&  list.next > shown + step  ) {
+				shown = list.next;
+				list.progress( shown, list.count );
+			}
+		}
+		return;
+	}
+#if MULTI_THREAD>1
+	// own colour maps, but the clipping and the strip flag of this drawing thread stay untouched
+	display_thread_t *const saved_thread = disp_thread;
+	disp_thread = display_threads + nr;
+#endif
+	rezoom_buffer_t buffer = { NULL, NULL, 0 };
+	while(  prepare_next_image( list, buffer )  ) {
+	}
+	free( buffer.baseimage );
+	free( buffer.baseimage2 );
+#if MULTI_THREAD>1
+	disp_thread = saved_thread;
+#endif
+}
+
+
+void display_prepare_images(void (*progress)(unsigned done, unsigned total))
+{
+	images_need_prepare = false;
+
+	prepare_list_t list;
+	list.images = MALLOCN( image_id, anz_images );
+	list.count = 0;
+	list.next = 0;
+	list.progress = progress;
+#if MULTI_THREAD>1
+	pthread_mutex_lock( &rezoom_recode_img_mutex );
+#endif
+	for(  image_id n = 0;  n < anz_images;  n++  ) {
+		imd &image = images[n];
+		if(  image.collect_flags  ) {
+			if(  (image.recode_flags & FLAG_REZOOM)
+				||  ((image.collect_flags & COLLECT_NORMAL)  &&  (image.recode_flags & FLAG_NORMAL_RECODE))
+				||  ((image.collect_flags & COLLECT_PLAYER)  &&  (image.player_flags & (~NEED_PLAYER_RECODE)) == 0)  ) {
+				list.images[list.count++] = n;
+			}
+			else {
+				image.collect_flags = 0;
+			}
+		}
+		else if(  image.recode_flags & FLAG_REZOOM  ) {
+			// copies of the old size are of no use anymore
+			free_image_copies(n);
+		}
+	}
+#if MULTI_THREAD>1
+	pthread_mutex_unlock( &rezoom_recode_img_mutex );
+#endif
+
+	if(  list.count > 0  ) {
+		if(  progress  ) {
+			progress( 0, list.count );
+		}
+#if MULTI_THREAD>1
+		run_parallel( prepare_images_part, &list, MAX_DISPLAY_THREADS );
+#else
+		prepare_images_part( &list, 0 );
+#endif
+		image_cache_misses += list.next;
+		for(  uint32 i = 0;  i < list.count;  i++  ) {
+			images[list.images[i]].collect_flags = 0;
+		}
+		if(  progress  ) {
+			progress( list.count, list.count );
+		}
+	}
+	guarded_free( list.images );
+}
+
+
+// prissi: query offsets
+void display_get_image_offset(unsigned bild, KOORD_VAL *xoff, KOORD_VAL *yoff, KOORD_VAL *xw, KOORD_VAL *yw)
+{
+	if (bild < anz_images) {
+		*xoff = images[bild].x;
+		*yoff = images[bild].y;
+		*xw   = images[bild].w;
+		*yw   = images[bild].h;
+	}
+}
+
+
+// prissi: query unzoomed offsets
+void display_get_base_image_offset(unsigned bild, KOORD_VAL *xoff, KOORD_VAL *yoff, KOORD_VAL *xw, KOORD_VAL *yw)
+{
+	if (bild < anz_images) {
+		*xoff = images[bild].base_x;
+		*yoff = images[bild].base_y;
+		*xw   = images[bild].base_w;
+		*yw   = images[bild].base_h;
+	}
+}
+
+
+// prissi: changes the offset of an image
+// we need it this complex, because the actual x-offset is coded into the image
+void display_set_base_image_offset(unsigned bild, KOORD_VAL xoff, KOORD_VAL yoff)
+{
+	if(bild >= anz_images) {
+		fprintf(stderr, "Warning: display_set_base_image_offset(): illegal image=%d\n", bild);
+		return;
+	}
+
+	// only move images once
+	if(  images[bild].recode_flags & FLAG_POSITION_CHANGED  ) {
+		fprintf(stderr, "Warning: display_set_base_image_offset(): image=%d was already moved!\n", bild);
+		return;
+	}
+	images[bild].recode_flags |= FLAG_POSITION_CHANGED;
+
+	assert(images[bild].base_h > 0);
+	assert(images[bild].base_w > 0);
+
+	// avoid overflow
+	images[bild].base_x += xoff;
+	images[bild].base_y += yoff;
+}
+
+
+// ------------------ cache of the ground of the world view ------------------------------
+
+/*
+ * The ground drawn in the world view, so it is only drawn again where it
+ * changed. The area is divided in chunks of the size of the dirty tiles,
+ * which stay valid until they are invalidated. When the view scrolls, the
+ * content and the valid chunks are moved along.
+ */
+static PIXVAL *ground_cache = NULL;
+static uint8 *ground_cache_valid = NULL;
+static uint8 *ground_cache_moved = NULL;
+static KOORD_VAL ground_cache_x, ground_cache_y, ground_cache_w, ground_cache_h;
+static KOORD_VAL ground_cache_chunks_w, ground_cache_chunks_h;
+static sint32 ground_cache_origin_x, ground_cache_origin_y;
+static uint32 ground_cache_state;
+
+
+// moves the content by dx, dy pixels; chunks are only valid, if all pixels come from valid ones
+static void move_ground_cache(sint32 dx, sint32 dy)
+{
+	const KOORD_VAL w = ground_cache_w, h = ground_cache_h;
+	const uint32 chunks = ground_cache_chunks_w * ground_cache_chunks_h;
+	if(  abs(dx) >= w  ||  abs(dy) >= h  ) {
+		memset( ground_cache_valid, 0, chunks );
+		return;
+	}
+
+	// rows are moved in the order which does not overwrite the ones still needed
+	const KOORD_VAL len = w - abs(dx);
+	for(  KOORD_VAL i = 0;  i < h - abs(dy);  i++  ) {
+		const KOORD_VAL y = dy > 0 ? h - 1 - i : i;
+		memmove( ground_cache + y * w + max(dx, 0), ground_cache + (y - dy) * w + max(-dx, 0), len * sizeof(PIXVAL) );
+	}
+
+	memcpy( ground_cache_moved, ground_cache_valid, chunks );
+	for(  KOORD_VAL cy = 0;  cy < ground_cache_chunks_h;  cy++  ) {
+		const sint32 y1 = (cy << DIRTY_TILE_SHIFT) - dy;
+		const sint32 y2 = min( (cy + 1) << DIRTY_TILE_SHIFT, (sint32)h ) - 1 - dy;
+		for(  KOORD_VAL cx = 0;  cx < ground_cache_chunks_w;  cx++  ) {
+			const sint32 x1 = (cx << DIRTY_TILE_SHIFT) - dx;
+			const sint32 x2 = min( (cx + 1) << DIRTY_TILE_SHIFT, (sint32)w ) - 1 - dx;
+			bool valid = x1 >= 0  &&  y1 >= 0  &&  x2 < w  &&  y2 < h;
+			for(  sint32 oy = y1 >> DIRTY_TILE_SHIFT;  valid  &&  oy <= (y2 >> DIRTY_TILE_SHIFT);  oy++  ) {
+				for(  sint32 ox = x1 >> DIRTY_TILE_SHIFT;  valid  &&  ox <= (x2 >> DIRTY_TILE_SHIFT);  ox++  ) {
+					valid = ground_cache_moved[oy * ground_cache_chunks_w + ox] != 0;
+				}
+			}
+			ground_cache_valid[cy * ground_cache_chunks_w + cx] = valid;
+		}
+	}
+}
+
+
+bool display_ground_cache_begin(KOORD_VAL x, KOORD_VAL y, KOORD_VAL w, KOORD_VAL h, int origin_x, int origin_y, unsigned state)
+{
+	if(  w <= 0  ||  h <= 0  ) {
+		return false;
+	}
+
+	if(  ground_cache == NULL  ||  x != ground_cache_x  ||  y != ground_cache_y  ||  w != ground_cache_w  ||  h != ground_cache_h  ) {
+		guarded_free( ground_cache );
+		guarded_free( ground_cache_valid );
+		guarded_free( ground_cache_moved );
+		ground_cache_x = x;
+		ground_cache_y = y;
+		ground_cache_w = w;
+		ground_cache_h = h;
+		ground_cache_chunks_w = (w + DIRTY_TILE_SIZE - 1) >> DIRTY_TILE_SHIFT;
+		ground_cache_chunks_h = (h + DIRTY_TILE_SIZE - 1) >> DIRTY_TILE_SHIFT;
+		ground_cache = MALLOCN( PIXVAL, w * h );
+		ground_cache_valid = MALLOCN( uint8, ground_cache_chunks_w * ground_cache_chunks_h );
+		ground_cache_moved = MALLOCN( uint8, ground_cache_chunks_w * ground_cache_chunks_h );
+		ground_cache_outdated = true;
+	}
+
+	if(  ground_cache_outdated  ||  state != ground_cache_state  ) {
+		memset( ground_cache_valid, 0, ground_cache_chunks_w * ground_cache_chunks_h );
+	}
+	else if(  origin_x != ground_cache_origin_x  ||  origin_y != ground_cache_origin_y  ) {
+		move_ground_cache( origin_x - ground_cache_origin_x, origin_y - ground_cache_origin_y );
+	}
+	ground_cache_origin_x = origin_x;
+	ground_cache_origin_y = origin_y;
+	ground_cache_state = state;
+	ground_cache_outdated = false;
+	return true;
+}
+
+
+void display_ground_cache_invalidate(KOORD_VAL x1, KOORD_VAL y1, KOORD_VAL x2, KOORD_VAL y2)
+{
+	if(  ground_cache == NULL  ) {
+		return;
+	}
+	// to chunks
+	x1 = max( x1 - ground_cache_x, 0 ) >> DIRTY_TILE_SHIFT;
+	y1 = max( y1 - ground_cache_y, 0 ) >> DIRTY_TILE_SHIFT;
+	x2 = min( (x2 - ground_cache_x) >> DIRTY_TILE_SHIFT, ground_cache_chunks_w - 1 );
+	y2 = min( (y2 - ground_cache_y) >> DIRTY_TILE_SHIFT, ground_cache_chunks_h - 1 );
+	for(  KOORD_VAL cy = y1;  cy <= y2;  cy++  ) {
+		for(  KOORD_VAL cx = x1;  cx <= x2;  cx++  ) {
+			ground_cache_valid[cy * ground_cache_chunks_w + cx] = 0;
+		}
+	}
+}
+
+
+void display_ground_cache_invalidate_img(unsigned bild, KOORD_VAL xp, KOORD_VAL yp)
 {
-	while( above<anz_images) {
-		anz_images--;
-		if(images[anz_images].zoom_data!=NULL) {
-			guarded_free( images[anz_images].zoom_data );
-		}
-		if(images[anz_images].player_data!=NULL) {
-			guarded_free( images[anz_images].player_data );
-		}
-		if(images[anz_images].data!=NULL) {
-			guarded_free( images[anz_images].data );
-		}
+	if(  bild < anz_images  ) {
+		display_ground_cache_invalidate(
+			xp + images[bild].x,
+			yp + images[bild].y,
+			xp + images[bild].x + images[bild].w - 1,
+			yp + images[bild].y + images[bild].h - 1
+		);
 	}
 }
 
 
-// prissi: query offsets
-void display_get_image_offset(unsigned bild, KOORD_VAL *xoff, KOORD_VAL *yoff, KOORD_VAL *xw, KOORD_VAL *yw)
+bool display_ground_cache_next_invalid(KOORD_VAL &x, KOORD_VAL &y, KOORD_VAL &w, KOORD_VAL &h)
 {
-	if (bild < anz_images) {
-		*xoff = images[bild].x;
-		*yoff = images[bild].y;
-		*xw   = images[bild].w;
-		*yw   = images[bild].h;
+	if(  ground_cache == NULL  ) {
+		return false;
+	}
+	const uint32 chunks = ground_cache_chunks_w * ground_cache_chunks_h;
+	uint32 first = 0;
+	while(  first < chunks  &&  ground_cache_valid[first]  ) {
+		first++;
+	}
+	if(  first == chunks  ) {
+		return false;
+	}
+
+	// the run of invalid chunks in this row, and the rows below as long as the same run is invalid
+	const KOORD_VAL cx1 = first % ground_cache_chunks_w, cy1 = first / ground_cache_chunks_w;
+	KOORD_VAL cx2 = cx1 + 1, cy2 = cy1 + 1;
+	while(  cx2 < ground_cache_chunks_w  &&  !ground_cache_valid[cy1 * ground_cache_chunks_w + cx2]  ) {
+		cx2++;
+	}
+	for(  bool invalid = true;  invalid  &&  cy2 < ground_cache_chunks_h;  ) {
+		for(  KOORD_VAL cx = cx1;  invalid  &&  cx < cx2;  cx++  ) {
+			invalid = !ground_cache_valid[cy2 * ground_cache_chunks_w + cx];
+		}
+		if(  invalid  ) {
+			cy2++;
+		}
 	}
+	// valid as soon as drawn and stored
+	for(  KOORD_VAL cy = cy1;  cy < cy2;  cy++  ) {
+		memset( ground_cache_valid + cy * ground_cache_chunks_w + cx1, 1, cx2 - cx1 );
+	}
+
+	x = ground_cache_x + (cx1 << DIRTY_TILE_SHIFT);
+	y = ground_cache_y + (cy1 << DIRTY_TILE_SHIFT);
+	w = min( cx2 << DIRTY_TILE_SHIFT, (sint32)ground_cache_w ) - (cx1 << DIRTY_TILE_SHIFT);
+	h = min( cy2 << DIRTY_TILE_SHIFT, (sint32)ground_cache_h ) - (cy1 << DIRTY_TILE_SHIFT);
+	return true;
 }
 
 
-// prissi: query unzoomed offsets
-void display_get_base_image_offset(unsigned bild, KOORD_VAL *xoff, KOORD_VAL *yoff, KOORD_VAL *xw, KOORD_VAL *yw)
+// limits the rectangle to the cache, returns false if nothing is left
+static bool clip_to_ground_cache(KOORD_VAL &x, KOORD_VAL &y, KOORD_VAL &w, KOORD_VAL &h)
 {
-	if (bild < anz_images) {
-		*xoff = images[bild].base_x;
-		*yoff = images[bild].base_y;
-		*xw   = images[bild].base_w;
-		*yw   = images[bild].base_h;
+	if(  ground_cache == NULL  ||  textur == NULL  ) {
+		return false;
 	}
+	const KOORD_VAL xx = min( x + w, ground_cache_x + ground_cache_w );
+	const KOORD_VAL yy = min( y + h, ground_cache_y + ground_cache_h );
+	x = max( x, ground_cache_x );
+	y = max( y, ground_cache_y );
+	w = xx - x;
+	h = yy - y;
+	return w > 0  &&  h > 0;
 }
 
 
-// prissi: changes the offset of an image
-// we need it this complex, because the actual x-offset is coded into the image
-void display_set_base_image_offset(unsigned bild, KOORD_VAL xoff, KOORD_VAL yoff)
+void display_ground_cache_store(KOORD_VAL x, KOORD_VAL y, KOORD_VAL w, KOORD_VAL h)
 {
-	if(bild >= anz_images) {
-		fprintf(stderr, "Warning: display_set_base_image_offset(): illegal image=%d\n", bild);
-		return;
-	}
-
-	// only move images once
-	if(  images[bild].recode_flags & FLAG_POSITION_CHANGED  ) {
-		fprintf(stderr, "Warning: display_set_base_image_offset(): image=%d was already moved!\n", bild);
-		return;
+	if(  clip_to_ground_cache( x, y, w, h )  ) {
+		for(  KOORD_VAL yy = y;  yy < y + h;  yy++  ) {
+			memcpy( ground_cache + (yy - ground_cache_y) * ground_cache_w + (x - ground_cache_x), textur + yy * disp_width + x, w * sizeof(PIXVAL) );
+		}
+		// it was drawn again
+		mark_rect_dirty_wc( x, y, x + w - 1, y + h - 1 );
 	}
-	images[bild].recode_flags |= FLAG_POSITION_CHANGED;
+}
 
-	assert(images[bild].base_h > 0);
-	assert(images[bild].base_w > 0);
 
-	// avoid overflow
-	images[bild].base_x += xoff;
-	images[bild].base_y += yoff;
+void display_ground_cache_restore(KOORD_VAL x, KOORD_VAL y, KOORD_VAL w, KOORD_VAL h)
+{
+	if(  clip_to_ground_cache( x, y, w, h )  ) {
+		for(  KOORD_VAL yy = y;  yy < y + h;  yy++  ) {
+			memcpy( textur + yy * disp_width + x, ground_cache + (yy - ground_cache_y) * ground_cache_w + (x - ground_cache_x), w * sizeof(PIXVAL) );
+		}
+	}
 }
 
 
@@ -2029,15 +2652,17 @@ static inline void pixcopy(PIXVAL *dest, const PIXVAL *src, const PIXVAL * const
 }
 
 
+// the pixel routines for this CPU and colour format, set by simgraph_init()
+static pixel_kernels_t kernels;
+
+
 /**
  * Kopiert Pixel, ersetzt Spielerfarben
  * @author Hj. Malthaner
  */
 static inline void colorpixcopy(PIXVAL *dest, const PIXVAL *src, const PIXVAL * const end)
 {
-	while (src < end) {
-		*dest++ = rgbmap_current[*src++];
-	}
+	kernels.colorcopy(dest, src, disp_thread->rgbmap_current, end - src);
 }
 
 
@@ -2135,9 +2760,9 @@ static void display_img_wc(KOORD_VAL h, const KOORD_VAL xp, const KOORD_VAL yp,
 				runlen = *sp++;
 
 				// Hajo: something to display?
-				if (xpos + runlen > clip_rect.x && xpos < clip_rect.xx) {
-					const int left = (xpos >= clip_rect.x ? 0 : clip_rect.x - xpos);
-					const int len  = (clip_rect.xx - xpos >= runlen ? runlen : clip_rect.xx - xpos);
+				if (xpos + runlen > disp_thread->clip_rect.x && xpos < disp_thread->clip_rect.xx) {
+					const int left = (xpos >= disp_thread->clip_rect.x ? 0 : disp_thread->clip_rect.x - xpos);
+					const int len  = (disp_thread->clip_rect.xx - xpos >= runlen ? runlen : disp_thread->clip_rect.xx - xpos);
 
 					pixcopy(tp + xpos + left, sp + left, sp + len);
 				}
@@ -2259,6 +2884,11 @@ static void display_img_nc(KOORD_VAL h, const KOORD_VAL xp, const KOORD_VAL yp,
 void display_img_aux(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8 use_player, const int /*daynight*/, const int dirty)
 {
 	if (n < anz_images) {
+		if(  collecting_images  ) {
+			mark_image_used(n);
+			images[n].collect_flags |= COLLECT_NORMAL;
+			return;
+		}
 		// need to go to nightmode and or rezoomed?
 		PIXVAL *sp;
 		KOORD_VAL h, reduce_h, skip_lines;
@@ -2271,6 +2901,7 @@ void display_img_aux(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8 u
 			}
 		}
 		else {
+			mark_image_used(n);
 			if (images[n].recode_flags&FLAG_REZOOM) {
 				rezoom_img(n);
 				recode_normal_img(n);
@@ -2278,6 +2909,9 @@ void display_img_aux(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8 u
 			else if (images[n].recode_flags&FLAG_NORMAL_RECODE) {
 				recode_normal_img(n);
 			}
+			else {
+				disp_thread->image_hits++;
+			}
 			sp = images[n].data;
 			if (sp == NULL) {
 				printf("Img %i failed!\n", n);
@@ -2293,7 +2927,7 @@ void display_img_aux(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8 u
 		// this should be much faster in most cases
 
 		// must the height be reduced?
-		reduce_h = yp + h - clip_rect.yy;
+		reduce_h = yp + h - disp_thread->clip_rect.yy;
 		if (reduce_h > 0) {
 			h -= reduce_h;
 		}
@@ -2303,7 +2937,7 @@ void display_img_aux(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8 u
 		}
 
 		// vertically lines to skip (only bottom is visible
-		skip_lines = clip_rect.y - (int)yp;
+		skip_lines = disp_thread->clip_rect.y - (int)yp;
 		if (skip_lines > 0) {
 			if (skip_lines >= h) {
 				// not visible at all
@@ -2330,7 +2964,7 @@ void display_img_aux(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8 u
 			xp += images[n].x;
 
 			// clipping at poly lines?
-			if (number_of_clips>0) {
+			if (disp_thread->number_of_clips>0) {
 					display_img_pc<plain>(h, xp, yp, sp);
 					// since height may be reduced, start marking here
 					if (dirty) {
@@ -2339,14 +2973,14 @@ void display_img_aux(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8 u
 			}
 			else {
 				// use horizontal clipping or skip it?
-				if (xp >= clip_rect.x  &&  xp + w <= clip_rect.xx) {
+				if (xp >= disp_thread->clip_rect.x  &&  xp + w <= disp_thread->clip_rect.xx) {
 					// marking change?
 					if (dirty) {
 						mark_rect_dirty_nc(xp, yp, xp + w - 1, yp + h - 1);
 					}
 					display_img_nc(h, xp, yp, sp);
 				}
-				else if (xp < clip_rect.xx  &&  xp + w > clip_rect.x) {
+				else if (xp < disp_thread->clip_rect.xx  &&  xp + w > disp_thread->clip_rect.x) {
 					display_img_wc(h, xp, yp, sp);
 					// since height may be reduced, start marking here
 					if (dirty) {
@@ -2384,9 +3018,9 @@ static void display_color_img_wc(const PIXVAL *sp, KOORD_VAL x, KOORD_VAL y, KOO
 			runlen = *sp++;
 
 			// Hajo: something to display?
-			if (xpos + runlen > clip_rect.x && xpos < clip_rect.xx) {
-				const int left = (xpos >= clip_rect.x ? 0 : clip_rect.x - xpos);
-				const int len  = (clip_rect.xx-xpos > runlen ? runlen : clip_rect.xx - xpos);
+			if (xpos + runlen > disp_thread->clip_rect.x && xpos < disp_thread->clip_rect.xx) {
+				const int left = (xpos >= disp_thread->clip_rect.x ? 0 : disp_thread->clip_rect.x - xpos);
+				const int len  = (disp_thread->clip_rect.xx-xpos > runlen ? runlen : disp_thread->clip_rect.xx - xpos);
 
 				colorpixcopy(tp + xpos + left, sp + left, sp + len);
 			}
@@ -2407,6 +3041,23 @@ static void display_color_img_wc(const PIXVAL *sp, KOORD_VAL x, KOORD_VAL y, KOO
 void display_color_img(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8 player_nr, const int daynight, const int dirty)
 {
 	if (n < anz_images) {
+		mark_image_used(n);
+
+		if(  collecting_images  ) {
+			// the same copy as used below
+			if(  !daynight  &&  night_shift!=0  ) {
+				images[n].collect_flags |= COLLECT_ZOOM;
+			}
+			else if(  player_nr==0  ||  (images[n].recode_flags & FLAG_PLAYERCOLOR)==0  ) {
+				images[n].collect_flags |= COLLECT_NORMAL;
+			}
+			else if(  (images[n].collect_flags & COLLECT_PLAYER) == 0  ) {
+				// only one player is cached
+				images[n].collect_flags |= COLLECT_PLAYER;
+				images[n].collect_player = player_nr;
+			}
+			return;
+		}
 
 		// first: size check
 		if (images[n].recode_flags&FLAG_REZOOM) {
@@ -2423,13 +3074,9 @@ void display_color_img(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8
 			}
 
 			// first test, if we can/need to build a cached version
-			if(  (images[n].player_flags&(~NEED_PLAYER_RECODE)) == 0  ) {
-				// we can still recoler if needed
-				recode_color_img(n, player_nr);
-			}
-			// ok, there is a cached version
-			if(  (images[n].player_flags&(~NEED_PLAYER_RECODE)) == player_nr  ) {
-				// ok, now we could use the same faster code as for the normal images
+			const uint8 cached_nr = images[n].player_flags&(~NEED_PLAYER_RECODE);
+			if(  (cached_nr == 0  ||  cached_nr == player_nr)  &&  recode_color_img(n, player_nr)  ) {
+				// ok, there is a cached version, so we could use the same faster code as for the normal images
 				display_img_aux(n, xp, yp, true, true, dirty);
 				return;
 			}
@@ -2442,7 +3089,7 @@ void display_color_img(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8
 			const KOORD_VAL w = images[n].w;
 			      KOORD_VAL h = images[n].h;
 
-			if (h <= 0 || x >= clip_rect.xx || y >= clip_rect.yy || x + w <= clip_rect.x || y + h <= clip_rect.y) {
+			if (h <= 0 || x >= disp_thread->clip_rect.xx || y >= disp_thread->clip_rect.yy || x + w <= disp_thread->clip_rect.x || y + h <= disp_thread->clip_rect.y) {
 				// not visible => we are done
 				// happens quite often ...
 				return;
@@ -2464,7 +3111,7 @@ void display_color_img(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8
 			const PIXVAL *sp = (tile_raster_width != base_tile_raster_width  &&  images[n].zoom_data != NULL) ? images[n].zoom_data : images[n].base_data;
 
 			// clip top/bottom
-			KOORD_VAL yoff = clip_wh(&y, &h, clip_rect.y, clip_rect.yy);
+			KOORD_VAL yoff = clip_wh(&y, &h, disp_thread->clip_rect.y, disp_thread->clip_rect.yy);
 			if (h > 0) { // clipping may have reduced it
 
 				// oben clippen
@@ -2479,7 +3126,7 @@ void display_color_img(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8
 				}
 
 				// clipping at poly lines?
-				if (number_of_clips>0) {
+				if (disp_thread->number_of_clips>0) {
 					display_img_pc<colored>(h, x, y, sp);
 				}
 				else {
@@ -2509,7 +3156,7 @@ void display_base_img(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8
 		const KOORD_VAL w = images[n].base_w;
 		      KOORD_VAL h = images[n].base_h;
 
-		if (h <= 0 || x >= clip_rect.xx || y >= clip_rect.yy || x + w <= clip_rect.x || y + h <= clip_rect.y) {
+		if (h <= 0 || x >= disp_thread->clip_rect.xx || y >= disp_thread->clip_rect.yy || x + w <= disp_thread->clip_rect.x || y + h <= disp_thread->clip_rect.y) {
 			// not visible => we are done
 			// happens quite often ...
 			return;
@@ -2532,7 +3179,7 @@ void display_base_img(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8
 		const PIXVAL *sp = images[n].base_data;
 
 		// clip top/bottom
-		KOORD_VAL yoff = clip_wh(&y, &h, clip_rect.y, clip_rect.yy);
+		KOORD_VAL yoff = clip_wh(&y, &h, disp_thread->clip_rect.y, disp_thread->clip_rect.yy);
 		if (h > 0) { // clipping may have reduced it
 
 			// oben clippen
@@ -2546,7 +3193,7 @@ void display_base_img(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8
 				sp++;
 			}
 			// clipping at poly lines?
-			if (number_of_clips>0) {
+			if (disp_thread->number_of_clips>0) {
 				display_img_pc<colored>(h, x, y, sp);
 			}
 			else {
@@ -2559,212 +3206,9 @@ void display_base_img(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const sint8
 
 
 /* from here code for transparent images */
-typedef void (*blend_proc)(PIXVAL *dest, const PIXVAL *src, const PIXVAL colour, const PIXVAL len);
-
-// different masks needed for RGB 555 and RGB 565
-#define ONE_OUT_16 (0x7bef)
-#define TWO_OUT_16 (0x39E7)
-#define ONE_OUT_15 (0x3DEF)
-#define TWO_OUT_15 (0x1CE7)
-
-
-static void pix_blend75_15(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (3*(((*src)>>2) & TWO_OUT_15)) + (((*dest)>>2) & TWO_OUT_15);
-		dest++;
-		src++;
-	}
-}
-
-
-static void pix_blend75_16(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (3*(((*src)>>2) & TWO_OUT_16)) + (((*dest)>>2) & TWO_OUT_16);
-		dest++;
-		src++;
-	}
-}
-
-
-static void pix_blend50_15(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (((*src)>>1) & ONE_OUT_15) + (((*dest)>>1) & ONE_OUT_15);
-		dest++;
-		src++;
-	}
-}
-
-
-static void pix_blend50_16(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (((*src)>>1) & ONE_OUT_16) + (((*dest)>>1) & ONE_OUT_16);
-		dest++;
-		src++;
-	}
-}
-
-
-static void pix_blend25_15(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (((*src)>>2) & TWO_OUT_15) + (3*(((*dest)>>2) & TWO_OUT_15));
-		dest++;
-		src++;
-	}
-}
-
-
-static void pix_blend25_16(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (((*src)>>2) & TWO_OUT_16) + (3*(((*dest)>>2) & TWO_OUT_16));
-		dest++;
-		src++;
-	}
-}
-
-
-// Knightly : the following 6 functions are for display_base_img_blend()
-static void pix_blend_recode75_15(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (3*(((rgbmap_current[*src])>>2) & TWO_OUT_15)) + (((*dest)>>2) & TWO_OUT_15);
-		dest++;
-		src++;
-	}
-}
-
-
-static void pix_blend_recode75_16(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (3*(((rgbmap_current[*src])>>2) & TWO_OUT_16)) + (((*dest)>>2) & TWO_OUT_16);
-		dest++;
-		src++;
-	}
-}
-
-
-static void pix_blend_recode50_15(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (((rgbmap_current[*src])>>1) & ONE_OUT_15) + (((*dest)>>1) & ONE_OUT_15);
-		dest++;
-		src++;
-	}
-}
-
-
-static void pix_blend_recode50_16(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (((rgbmap_current[*src])>>1) & ONE_OUT_16) + (((*dest)>>1) & ONE_OUT_16);
-		dest++;
-		src++;
-	}
-}
-
-
-static void pix_blend_recode25_15(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (((rgbmap_current[*src])>>2) & TWO_OUT_15) + (3*(((*dest)>>2) & TWO_OUT_15));
-		dest++;
-		src++;
-	}
-}
-
-
-static void pix_blend_recode25_16(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (((rgbmap_current[*src])>>2) & TWO_OUT_16) + (3*(((*dest)>>2) & TWO_OUT_16));
-		dest++;
-		src++;
-	}
-}
-
-
-static void pix_outline75_15(PIXVAL *dest, const PIXVAL *, const PIXVAL colour, const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (3*((colour>>2) & TWO_OUT_15)) + (((*dest)>>2) & TWO_OUT_15);
-		dest++;
-	}
-}
-
-
-static void pix_outline75_16(PIXVAL *dest, const PIXVAL *, const PIXVAL colour, const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = (3*((colour>>2) & TWO_OUT_16)) + (((*dest)>>2) & TWO_OUT_16);
-		dest++;
-	}
-}
-
-
-static void pix_outline50_15(PIXVAL *dest, const PIXVAL *, const PIXVAL colour, const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = ((colour>>1) & ONE_OUT_15) + (((*dest)>>1) & ONE_OUT_15);
-		dest++;
-	}
-}
-
-
-static void pix_outline50_16(PIXVAL *dest, const PIXVAL *, const PIXVAL colour, const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = ((colour>>1) & ONE_OUT_16) + (((*dest)>>1) & ONE_OUT_16);
-		dest++;
-	}
-}
-
 
-static void pix_outline25_15(PIXVAL *dest, const PIXVAL *, const PIXVAL colour, const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = ((colour>>2) & TWO_OUT_15) + (3*(((*dest)>>2) & TWO_OUT_15));
-		dest++;
-	}
-}
-
-
-static void pix_outline25_16(PIXVAL *dest, const PIXVAL *, const PIXVAL colour, const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = ((colour>>2) & TWO_OUT_16) + (3*(((*dest)>>2) & TWO_OUT_16));
-		dest++;
-	}
-}
-
-
-// will kept the actual values
-static blend_proc blend[3];
-static blend_proc blend_recode[3];
-static blend_proc outline[3];
+// true for RGB 555, else RGB 565
+static bool rgb555 = false;
 
 
 /**
@@ -2772,7 +3216,7 @@ static blend_proc outline[3];
  */
 void display_blend_wh(KOORD_VAL xp, KOORD_VAL yp, KOORD_VAL w, KOORD_VAL h, int color, int percent_blend )
 {
-	if(  clip_lr(&xp, &w, clip_rect.x, clip_rect.xx)  &&  clip_lr(&yp, &h, clip_rect.y, clip_rect.yy)  ) {
+	if(  clip_lr(&xp, &w, disp_thread->clip_rect.x, disp_thread->clip_rect.xx)  &&  clip_lr(&yp, &h, disp_thread->clip_rect.y, disp_thread->clip_rect.yy)  ) {
 
 		const PIXVAL colval = specialcolormap_all_day[color & 0xFF];
 		const PIXVAL alpha = (percent_blend*64)/100;
@@ -2786,10 +3230,10 @@ void display_blend_wh(KOORD_VAL xp, KOORD_VAL yp, KOORD_VAL w, KOORD_VAL h, int
 			case 48:
 			{
 				// fast blending with 1/4 | 1/2 | 3/4 percentage
-				blend_proc blend = outline[ (alpha>>4) - 1 ];
+				blend_proc blend = kernels.outline[ (alpha>>4) - 1 ];
 
 				for(  KOORD_VAL y=0;  y<h;  y++  ) {
-					blend( textur + xp + (yp+y) * disp_width, NULL, colval, w );
+					blend( textur + xp + (yp+y) * disp_width, NULL, NULL, colval, w );
 				}
 			}
 			break;
@@ -2801,7 +3245,7 @@ void display_blend_wh(KOORD_VAL xp, KOORD_VAL yp, KOORD_VAL w, KOORD_VAL h, int
 
 			default:
 				// any percentage blending: SLOW!
-				if(  blend[0] == pix_blend25_15  ) {
+				if(  rgb555  ) {
 					// 555 BITMAPS
 					const PIXVAL r_src = (colval >> 10) & 0x1F;
 					const PIXVAL g_src = (colval >> 5) & 0x1F;
@@ -2864,10 +3308,10 @@ static void display_img_blend_wc(KOORD_VAL h, const KOORD_VAL xp, const KOORD_VA
 				runlen = *sp++;
 
 				// Hajo: something to display?
-				if (xpos + runlen > clip_rect.x && xpos < clip_rect.xx) {
-					const int left = (xpos >= clip_rect.x ? 0 : clip_rect.x - xpos);
-					const int len  = (clip_rect.xx - xpos >= runlen ? runlen : clip_rect.xx - xpos);
-					p(tp + xpos + left, sp + left, colour, len - left);
+				if (xpos + runlen > disp_thread->clip_rect.x && xpos < disp_thread->clip_rect.xx) {
+					const int left = (xpos >= disp_thread->clip_rect.x ? 0 : disp_thread->clip_rect.x - xpos);
+					const int len  = (disp_thread->clip_rect.xx - xpos >= runlen ? runlen : disp_thread->clip_rect.xx - xpos);
+					p(tp + xpos + left, sp + left, disp_thread->rgbmap_current, colour, len - left);
 				}
 
 				sp += runlen;
@@ -2883,171 +3327,6 @@ static void display_img_blend_wc(KOORD_VAL h, const KOORD_VAL xp, const KOORD_VA
 /* from here code for transparent images */
 
 
-typedef void (*alpha_proc)(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const unsigned alpha_flags, const PIXVAL colour, const PIXVAL len);
-static alpha_proc alpha;
-static alpha_proc alpha_recode;
-
-
-static void pix_alpha_15(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const unsigned alpha_flags, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-
-	const uint16 rmask = alpha_flags & ALPHA_RED ? 0x001f : 0;
-	const uint16 gmask = alpha_flags & ALPHA_GREEN ? 0x03e0 : 0;
-	const uint16 bmask = alpha_flags & ALPHA_BLUE ? 0x7b00 : 0;
-
-	while(  dest < end  ) {
-		// read mask components - always 15bpp
-		uint16 alpha_value = ((*alphamap) & rmask) + (((*alphamap) & gmask) >> 5) + (((*alphamap) & bmask) >> 10);
-
-		if(  alpha_value > 30  ) {
-			// opaque, just copy source
-			*dest = *src;
-		}
-		else if(  alpha_value > 0  ) {
-			alpha_value = alpha_value > 15 ? alpha_value + 1 : alpha_value;
-
-			//read screen components - 15bpp
-			const uint16 rbs = (*dest) & 0x7b1f;
-			const uint16 gs =  (*dest) & 0x03e0;
-
-			// read image components - 15bpp
-			const uint16 rbi = (*src) & 0x7b1f;
-			const uint16 gi =  (*src) & 0x03e0;
-
-			// calculate and write destination components - 16bpp
-			const uint16 rbd = ((rbi * alpha_value) + (rbs * (32 - alpha_value))) >> 5;
-			const uint16 gd  = ((gi  * alpha_value) + (gs  * (32 - alpha_value))) >> 5;
-			*dest = (rbd & 0x7b1f) | (gd & 0x03e0);
-		}
-
-		dest++;
-		src++;
-		alphamap++;
-	}
-}
-
-
-static void pix_alpha_16(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const unsigned alpha_flags, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-
-	const uint16 rmask = alpha_flags & ALPHA_RED ? 0x001f : 0;
-	const uint16 gmask = alpha_flags & ALPHA_GREEN ? 0x03e0 : 0;
-	const uint16 bmask = alpha_flags & ALPHA_BLUE ? 0x7b00 : 0;
-
-	while(  dest < end  ) {
-		// read mask components - always 15bpp
-		uint16 alpha_value = ((*alphamap) & rmask) + (((*alphamap) & gmask) >> 5) + (((*alphamap) & bmask) >> 10);
-
-		if(  alpha_value > 30  ) {
-			// opaque, just copy source
-			*dest = *src;
-		}
-		else if(  alpha_value > 0  ) {
-			alpha_value = alpha_value > 15 ? alpha_value + 1 : alpha_value;
-
-			//read screen components - 16bpp
-			const uint16 rbs = (*dest) & 0xf81f;
-			const uint16 gs =  (*dest) & 0x07e0;
-
-			// read image components 16bpp
-			const uint16 rbi = (*src) & 0xf81f;
-			const uint16 gi =  (*src) & 0x07e0;
-
-			// calculate and write destination components - 16bpp
-			const uint16 rbd = ((rbi * alpha_value) + (rbs * (32 - alpha_value))) >> 5;
-			const uint16 gd  = ((gi  * alpha_value) + (gs  * (32 - alpha_value))) >> 5;
-			*dest = (rbd & 0xf81f) | (gd & 0x07e0);
-		}
-
-		dest++;
-		src++;
-		alphamap++;
-	}
-}
-
-
-static void pix_alpha_recode_15(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const unsigned alpha_flags, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-
-	const uint16 rmask = alpha_flags & ALPHA_RED ? 0x001f : 0;
-	const uint16 gmask = alpha_flags & ALPHA_GREEN ? 0x03e0 : 0;
-	const uint16 bmask = alpha_flags & ALPHA_BLUE ? 0x7b00 : 0;
-
-	while(  dest < end  ) {
-		// read mask components - always 15bpp
-		uint16 alpha_value = ((*alphamap) & rmask) + (((*alphamap) & gmask) >> 5) + (((*alphamap) & bmask) >> 10);
-
-		if(  alpha_value > 30  ) {
-			// opaque, just copy source
-			*dest = rgbmap_current[*src];
-		}
-		else if(  alpha_value > 0  ) {
-			alpha_value = alpha_value > 15 ? alpha_value + 1 : alpha_value;
-
-			//read screen components - 15bpp
-			const uint16 rbs = (*dest) & 0x7b1f;
-			const uint16 gs =  (*dest) & 0x03e0;
-
-			// read image components - 15bpp
-			const uint16 rbi = (rgbmap_current[*src]) & 0x7b1f;
-			const uint16 gi =  (rgbmap_current[*src]) & 0x03e0;
-
-			// calculate and write destination components - 16bpp
-			const uint16 rbd = ((rbi * alpha_value) + (rbs * (32 - alpha_value))) >> 5;
-			const uint16 gd  = ((gi  * alpha_value) + (gs  * (32 - alpha_value))) >> 5;
-			*dest = (rbd & 0x7b1f) | (gd & 0x03e0);
-		}
-
-		dest++;
-		src++;
-		alphamap++;
-	}
-}
-
-
-static void pix_alpha_recode_16(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const unsigned alpha_flags, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-
-	const uint16 rmask = alpha_flags & ALPHA_RED ? 0x001f : 0;
-	const uint16 gmask = alpha_flags & ALPHA_GREEN ? 0x03e0 : 0;
-	const uint16 bmask = alpha_flags & ALPHA_BLUE ? 0x7b00 : 0;
-
-	while(  dest < end  ) {
-		// read mask components - always 15bpp
-		uint16 alpha_value = ((*alphamap) & rmask) + (((*alphamap) & gmask) >> 5) + (((*alphamap) & bmask) >> 10);
-
-		if(  alpha_value > 30  ) {
-			// opaque, just copy source
-			*dest = rgbmap_current[*src];
-		}
-		else if(  alpha_value > 0  ) {
-			alpha_value = alpha_value> 15 ? alpha_value + 1 : alpha_value;
-
-			//read screen components - 16bpp
-			const uint16 rbs = (*dest) & 0xf81f;
-			const uint16 gs =  (*dest) & 0x07e0;
-
-			// read image components 16bpp
-			const uint16 rbi = (rgbmap_current[*src]) & 0xf81f;
-			const uint16 gi =  (rgbmap_current[*src]) & 0x07e0;
-
-			// calculate and write destination components - 16bpp
-			const uint16 rbd = ((rbi * alpha_value) + (rbs * (32 - alpha_value))) >> 5;
-			const uint16 gd  = ((gi  * alpha_value) + (gs  * (32 - alpha_value))) >> 5;
-			*dest = (rbd & 0xf81f) | (gd & 0x07e0);
-		}
-
-		dest++;
-		src++;
-		alphamap++;
-	}
-}
-
-
 static void display_img_alpha_wc(KOORD_VAL h, const KOORD_VAL xp, const KOORD_VAL yp, const PIXVAL *sp, const PIXVAL *alphamap, const uint8 alpha_flags, int colour, alpha_proc p )
 {
 	if(  h > 0  ) {
@@ -3069,10 +3348,10 @@ static void display_img_alpha_wc(KOORD_VAL h, const KOORD_VAL xp, const KOORD_VA
 				alphamap++;
 
 				// Hajo: something to display?
-				if(  xpos + runlen > clip_rect.x  &&  xpos < clip_rect.xx  ) {
-					const int left = (xpos >= clip_rect.x ? 0 : clip_rect.x - xpos);
-					const int len  = (clip_rect.xx - xpos >= runlen ? runlen : clip_rect.xx - xpos);
-					p( tp + xpos + left, sp + left, alphamap + left, alpha_flags, colour, len - left );
+				if(  xpos + runlen > disp_thread->clip_rect.x  &&  xpos < disp_thread->clip_rect.xx  ) {
+					const int left = (xpos >= disp_thread->clip_rect.x ? 0 : disp_thread->clip_rect.x - xpos);
+					const int len  = (disp_thread->clip_rect.xx - xpos >= runlen ? runlen : disp_thread->clip_rect.xx - xpos);
+					p( tp + xpos + left, sp + left, alphamap + left, disp_thread->rgbmap_current, alpha_flags, colour, len - left );
 				}
 
 				sp += runlen;
@@ -3098,11 +3377,18 @@ void display_rezoomed_img_blend(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, co
 		PIXVAL *sp;
 		KOORD_VAL h, reduce_h, skip_lines;
 
+		mark_image_used(n);
+		if(  collecting_images  ) {
+			images[n].collect_flags |= COLLECT_NORMAL;
+			return;
+		}
 		if (images[n].recode_flags&FLAG_REZOOM) {
 			rezoom_img(n);
 			recode_normal_img(n);
 		} else if (images[n].recode_flags&FLAG_NORMAL_RECODE) {
 			recode_normal_img(n);
+		} else {
+			disp_thread->image_hits++;
 		}
 		sp = images[n].data;
 
@@ -3116,7 +3402,7 @@ void display_rezoomed_img_blend(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, co
 		// this should be much faster in most cases
 
 		// must the height be reduced?
-		reduce_h = yp + h - clip_rect.yy;
+		reduce_h = yp + h - disp_thread->clip_rect.yy;
 		if (reduce_h > 0) {
 			h -= reduce_h;
 		}
@@ -3124,7 +3410,7 @@ void display_rezoomed_img_blend(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, co
 		if (h <= 0) return;
 
 		// vertically lines to skip (only bottom is visible
-		skip_lines = clip_rect.y - (int)yp;
+		skip_lines = disp_thread->clip_rect.y - (int)yp;
 		if (skip_lines > 0) {
 			if (skip_lines >= h) {
 				// not visible at all
@@ -3151,16 +3437,16 @@ void display_rezoomed_img_blend(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, co
 			// get the real color
 			const PIXVAL color = specialcolormap_all_day[color_index & 0xFF];
 			// we use function pointer for the blend runs for the moment ...
-			blend_proc pix_blend = (color_index&OUTLINE_FLAG) ? outline[ (color_index&TRANSPARENT_FLAGS)/TRANSPARENT25_FLAG - 1 ] : blend[ (color_index&TRANSPARENT_FLAGS)/TRANSPARENT25_FLAG - 1 ];
+			blend_proc pix_blend = (color_index&OUTLINE_FLAG) ? kernels.outline[ (color_index&TRANSPARENT_FLAGS)/TRANSPARENT25_FLAG - 1 ] : kernels.blend[ (color_index&TRANSPARENT_FLAGS)/TRANSPARENT25_FLAG - 1 ];
 
 			// use horzontal clipping or skip it?
-			if (xp >= clip_rect.x && xp + w  <= clip_rect.xx) {
+			if (xp >= disp_thread->clip_rect.x && xp + w  <= disp_thread->clip_rect.xx) {
 				// marking change?
 				if (dirty) {
 					mark_rect_dirty_nc(xp, yp, xp + w - 1, yp + h - 1);
 				}
 				display_img_blend_wc( h, xp, yp, sp, color, pix_blend );
-			} else if (xp < clip_rect.xx && xp + w > clip_rect.x) {
+			} else if (xp < disp_thread->clip_rect.xx && xp + w > disp_thread->clip_rect.x) {
 				display_img_blend_wc( h, xp, yp, sp, color, pix_blend );
 				// since height may be reduced, start marking here
 				if (dirty) {
@@ -3180,6 +3466,13 @@ void display_rezoomed_img_alpha(const unsigned n, const unsigned alpha_n, const
 		PIXVAL *alphamap;
 		KOORD_VAL h, reduce_h, skip_lines;
 
+		mark_image_used(n);
+		mark_image_used(alpha_n);
+		if(  collecting_images  ) {
+			images[n].collect_flags |= COLLECT_NORMAL;
+			images[alpha_n].collect_flags |= COLLECT_ZOOM;
+			return;
+		}
 		if(  images[n].recode_flags & FLAG_REZOOM  ) {
 			rezoom_img(n);
 			recode_normal_img(n);
@@ -3187,6 +3480,9 @@ void display_rezoomed_img_alpha(const unsigned n, const unsigned alpha_n, const
 		else if(  images[n].recode_flags & FLAG_NORMAL_RECODE  ) {
 			recode_normal_img(n);
 		}
+		else {
+			disp_thread->image_hits++;
+		}
 		if(  images[alpha_n].recode_flags & FLAG_REZOOM  ) {
 			rezoom_img(alpha_n);
 		}
@@ -3203,7 +3499,7 @@ void display_rezoomed_img_alpha(const unsigned n, const unsigned alpha_n, const
 		// this should be much faster in most cases
 
 		// must the height be reduced?
-		reduce_h = yp + h - clip_rect.yy;
+		reduce_h = yp + h - disp_thread->clip_rect.yy;
 		if(  reduce_h > 0  ) {
 			h -= reduce_h;
 		}
@@ -3213,7 +3509,7 @@ void display_rezoomed_img_alpha(const unsigned n, const unsigned alpha_n, const
 		}
 
 		// vertically lines to skip (only bottom is visible
-		skip_lines = clip_rect.y - (int)yp;
+		skip_lines = disp_thread->clip_rect.y - (int)yp;
 		if(  skip_lines > 0  ) {
 			if(  skip_lines >= h  ) {
 				// not visible at all
@@ -3244,15 +3540,15 @@ void display_rezoomed_img_alpha(const unsigned n, const unsigned alpha_n, const
 			const PIXVAL color = specialcolormap_all_day[color_index & 0xFF];
 
 			// use horizontal clipping or skip it?
-			if(  xp >= clip_rect.x  &&  xp + w  <= clip_rect.xx  ) {
+			if(  xp >= disp_thread->clip_rect.x  &&  xp + w  <= disp_thread->clip_rect.xx  ) {
 				// marking change?
 				if(  dirty  ) {
 					mark_rect_dirty_nc( xp, yp, xp + w - 1, yp + h - 1 );
 				}
-				display_img_alpha_wc( h, xp, yp, sp, alphamap, alpha_flags, color, alpha );
+				display_img_alpha_wc( h, xp, yp, sp, alphamap, alpha_flags, color, kernels.alpha );
 			}
-			else if(  xp < clip_rect.xx  &&  xp + w > clip_rect.x  ) {
-				display_img_alpha_wc( h, xp, yp, sp, alphamap, alpha_flags, color, alpha );
+			else if(  xp < disp_thread->clip_rect.xx  &&  xp + w > disp_thread->clip_rect.x  ) {
+				display_img_alpha_wc( h, xp, yp, sp, alphamap, alpha_flags, color, kernels.alpha );
 				// since height may be reduced, start marking here
 				if(  dirty  ) {
 					mark_rect_dirty_wc( xp, yp, xp + w - 1, yp + h - 1 );
@@ -3278,7 +3574,7 @@ void display_base_img_blend(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const
 		KOORD_VAL w = images[n].base_w;
 		KOORD_VAL h = images[n].base_h;
 
-		if (h == 0 || x >= clip_rect.xx || y >= clip_rect.yy || x + w <= clip_rect.x || y + h <= clip_rect.y) {
+		if (h == 0 || x >= disp_thread->clip_rect.xx || y >= disp_thread->clip_rect.yy || x + w <= disp_thread->clip_rect.x || y + h <= disp_thread->clip_rect.y) {
 			// not visible => we are done
 			// happens quite often ...
 			return;
@@ -3287,13 +3583,13 @@ void display_base_img_blend(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const
 		PIXVAL *sp = images[n].base_data;
 
 		// must the height be reduced?
-		KOORD_VAL reduce_h = y + h - clip_rect.yy;
+		KOORD_VAL reduce_h = y + h - disp_thread->clip_rect.yy;
 		if (reduce_h > 0) {
 			h -= reduce_h;
 		}
 
 		// vertical lines to skip (only bottom is visible)
-		KOORD_VAL skip_lines = clip_rect.y - (int)y;
+		KOORD_VAL skip_lines = disp_thread->clip_rect.y - (int)y;
 		if (skip_lines > 0) {
 			h -= skip_lines;
 			y += skip_lines;
@@ -3312,7 +3608,7 @@ void display_base_img_blend(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const
 		// new block for new variables
 		{
 			const PIXVAL color = specialcolormap_all_day[color_index & 0xFF];
-			blend_proc pix_blend = (color_index&OUTLINE_FLAG) ? outline[ (color_index&TRANSPARENT_FLAGS)/TRANSPARENT25_FLAG - 1 ] : blend_recode[ (color_index&TRANSPARENT_FLAGS)/TRANSPARENT25_FLAG - 1 ];
+			blend_proc pix_blend = (color_index&OUTLINE_FLAG) ? kernels.outline[ (color_index&TRANSPARENT_FLAGS)/TRANSPARENT25_FLAG - 1 ] : kernels.blend_recode[ (color_index&TRANSPARENT_FLAGS)/TRANSPARENT25_FLAG - 1 ];
 
 			// recode is needed only for blending
 			if(  !(color_index&OUTLINE_FLAG)  ) {
@@ -3327,7 +3623,7 @@ void display_base_img_blend(const unsigned n, KOORD_VAL xp, KOORD_VAL yp, const
 			}
 
 			// use horizontal clipping or skip it?
-			if(  x>=clip_rect.x  &&  x+w<=clip_rect.xx  ) {
+			if(  x>=disp_thread->clip_rect.x  &&  x+w<=disp_thread->clip_rect.xx  ) {
 				if (dirty) {
 					mark_rect_dirty_nc(x, y, x + w - 1, y + h - 1);
 				}
@@ -3357,7 +3653,7 @@ void display_base_img_alpha(const unsigned n, const unsigned alpha_n, const unsi
 		KOORD_VAL w = images[n].base_w;
 		KOORD_VAL h = images[n].base_h;
 
-		if(  h == 0  ||  x >= clip_rect.xx  ||  y >= clip_rect.yy  ||  x + w <= clip_rect.x  ||  y + h <= clip_rect.y  ) {
+		if(  h == 0  ||  x >= disp_thread->clip_rect.xx  ||  y >= disp_thread->clip_rect.yy  ||  x + w <= disp_thread->clip_rect.x  ||  y + h <= disp_thread->clip_rect.y  ) {
 			// not visible => we are done
 			// happens quite often ...
 			return;
@@ -3367,13 +3663,13 @@ void display_base_img_alpha(const unsigned n, const unsigned alpha_n, const unsi
 		PIXVAL *alphamap = images[alpha_n].base_data;
 
 		// must the height be reduced?
-		KOORD_VAL reduce_h = y + h - clip_rect.yy;
+		KOORD_VAL reduce_h = y + h - disp_thread->clip_rect.yy;
 		if(  reduce_h > 0  ) {
 			h -= reduce_h;
 		}
 
 		// vertical lines to skip (only bottom is visible)
-		KOORD_VAL skip_lines = clip_rect.y - (int)y;
+		KOORD_VAL skip_lines = disp_thread->clip_rect.y - (int)y;
 		if(  skip_lines > 0  ) {
 			h -= skip_lines;
 			y += skip_lines;
@@ -3412,17 +3708,17 @@ void display_base_img_alpha(const unsigned n, const unsigned alpha_n, const unsi
 			}
 
 			// use horizontal clipping or skip it?
-			if(  x >= clip_rect.x  &&  x + w <= clip_rect.xx  ) {
+			if(  x >= disp_thread->clip_rect.x  &&  x + w <= disp_thread->clip_rect.xx  ) {
 				if( dirty ) {
 					mark_rect_dirty_nc( x, y, x + w - 1, y + h - 1 );
 				}
-				display_img_alpha_wc( h, x, y, sp, alphamap, alpha_flags, color, alpha_recode );
+				display_img_alpha_wc( h, x, y, sp, alphamap, alpha_flags, color, kernels.alpha_recode );
 			}
 			else {
 				if(  dirty  ) {
 					mark_rect_dirty_wc( x, y, x + w - 1, y + h - 1 );
 				}
-				display_img_alpha_wc( h, x, y, sp, alphamap, alpha_flags, color, alpha_recode );
+				display_img_alpha_wc( h, x, y, sp, alphamap, alpha_flags, color, kernels.alpha_recode );
 			}
 		}
 	} // number ok
@@ -3462,7 +3758,7 @@ static void display_pixel(KOORD_VAL x, KOORD_VAL y, PIXVAL color, bool mark_dirt
 static void display_pixel(KOORD_VAL x, KOORD_VAL y, PIXVAL color)
 #endif
 {
-	if (x >= clip_rect.x && x < clip_rect.xx && y >= clip_rect.y && y < clip_rect.yy) {
+	if (x >= disp_thread->clip_rect.x && x < disp_thread->clip_rect.xx && y >= disp_thread->clip_rect.y && y < disp_thread->clip_rect.yy) {
 		PIXVAL* const p = textur + x + y * disp_width;
 
 		*p = color;
@@ -3546,7 +3842,7 @@ void display_fillbox_wh(KOORD_VAL xp, KOORD_VAL yp, KOORD_VAL w, KOORD_VAL h, PL
 
 void display_fillbox_wh_clip(KOORD_VAL xp, KOORD_VAL yp, KOORD_VAL w, KOORD_VAL h, PLAYER_COLOR_VAL color, bool dirty)
 {
-	display_fb_internal(xp, yp, w, h, color, dirty, clip_rect.x, clip_rect.xx, clip_rect.y, clip_rect.yy);
+	display_fb_internal(xp, yp, w, h, color, dirty, disp_thread->clip_rect.x, disp_thread->clip_rect.xx, disp_thread->clip_rect.y, disp_thread->clip_rect.yy);
 }
 
 
@@ -3578,7 +3874,7 @@ void display_vline_wh(const KOORD_VAL xp, KOORD_VAL yp, KOORD_VAL h, const PLAYE
 
 void display_vline_wh_clip(const KOORD_VAL xp, KOORD_VAL yp, KOORD_VAL h, const PLAYER_COLOR_VAL color, bool dirty)
 {
-	display_vl_internal(xp, yp, h, color, dirty, clip_rect.x, clip_rect.xx, clip_rect.y, clip_rect.yy);
+	display_vl_internal(xp, yp, h, color, dirty, disp_thread->clip_rect.x, disp_thread->clip_rect.xx, disp_thread->clip_rect.y, disp_thread->clip_rect.yy);
 }
 
 
@@ -3588,8 +3884,8 @@ void display_vline_wh_clip(const KOORD_VAL xp, KOORD_VAL yp, KOORD_VAL h, const
 void display_array_wh(KOORD_VAL xp, KOORD_VAL yp, KOORD_VAL w, KOORD_VAL h, const COLOR_VAL *arr)
 {
 	const int arr_w = w;
-	const KOORD_VAL xoff = clip_wh(&xp, &w, clip_rect.x, clip_rect.xx);
-	const KOORD_VAL yoff = clip_wh(&yp, &h, clip_rect.y, clip_rect.yy);
+	const KOORD_VAL xoff = clip_wh(&xp, &w, disp_thread->clip_rect.x, disp_thread->clip_rect.xx);
+	const KOORD_VAL yoff = clip_wh(&yp, &h, disp_thread->clip_rect.y, disp_thread->clip_rect.yy);
 
 	if (w > 0 && h > 0) {
 		PIXVAL *p = textur + xp + yp * disp_width;
@@ -3597,8 +3893,8 @@ void display_array_wh(KOORD_VAL xp, KOORD_VAL yp, KOORD_VAL w, KOORD_VAL h, cons
 
 		mark_rect_dirty_nc(xp, yp, xp + w - 1, yp + h - 1);
 
-		if (xp == clip_rect.x) arr_src += xoff;
-		if (yp == clip_rect.y) arr_src += yoff * arr_w;
+		if (xp == disp_thread->clip_rect.x) arr_src += xoff;
+		if (yp == disp_thread->clip_rect.y) arr_src += yoff * arr_w;
 
 		do {
 			unsigned int ww = w;
@@ -3855,10 +4151,10 @@ int display_text_proportional_len_clip(KOORD_VAL x, KOORD_VAL y, const char* txt
 
 	// TAKE CARE: Clipping area may be larger than actual screen size ...
 	if (flags & DT_CLIP) {
-		cL = clip_rect.x;
-		cR = clip_rect.xx;
-		cT = clip_rect.y;
-		cB = clip_rect.yy;
+		cL = disp_thread->clip_rect.x;
+		cR = disp_thread->clip_rect.xx;
+		cT = disp_thread->clip_rect.y;
+		cB = disp_thread->clip_rect.yy;
 	}
 	else {
 		cL = 0;
@@ -4263,7 +4559,7 @@ void display_filled_circle( KOORD_VAL x0, KOORD_VAL  y0, int radius, const PLAYE
 	int x = 0;
 	int y = radius;
 
-	display_fb_internal( x0-radius, y0, radius+radius+1, 1, color, false, clip_rect.x, clip_rect.xx, clip_rect.y, clip_rect.yy);
+	display_fb_internal( x0-radius, y0, radius+radius+1, 1, color, false, disp_thread->clip_rect.x, disp_thread->clip_rect.xx, disp_thread->clip_rect.y, disp_thread->clip_rect.yy);
 	display_pixel( x0, y0 + radius, colval );
 	display_pixel( x0, y0 - radius, colval );
 	display_pixel( x0 + radius, y0, colval );
@@ -4283,11 +4579,11 @@ void display_filled_circle( KOORD_VAL x0, KOORD_VAL  y0, int radius, const PLAYE
 		ddF_x += 2;
 		f += ddF_x;
 
-		display_fb_internal( x0-x, y0+y, x+x, 1, color, false, clip_rect.x, clip_rect.xx, clip_rect.y, clip_rect.yy);
-		display_fb_internal( x0-x, y0-y, x+x, 1, color, false, clip_rect.x, clip_rect.xx, clip_rect.y, clip_rect.yy);
+		display_fb_internal( x0-x, y0+y, x+x, 1, color, false, disp_thread->clip_rect.x, disp_thread->clip_rect.xx, disp_thread->clip_rect.y, disp_thread->clip_rect.yy);
+		display_fb_internal( x0-x, y0-y, x+x, 1, color, false, disp_thread->clip_rect.x, disp_thread->clip_rect.xx, disp_thread->clip_rect.y, disp_thread->clip_rect.yy);
 
-		display_fb_internal( x0-y, y0+x, y+y, 1, color, false, clip_rect.x, clip_rect.xx, clip_rect.y, clip_rect.yy);
-		display_fb_internal( x0-y, y0-x, y+y, 1, color, false, clip_rect.x, clip_rect.xx, clip_rect.y, clip_rect.yy);
+		display_fb_internal( x0-y, y0+x, y+y, 1, color, false, disp_thread->clip_rect.x, disp_thread->clip_rect.xx, disp_thread->clip_rect.y, disp_thread->clip_rect.yy);
+		display_fb_internal( x0-y, y0-x, y+y, 1, color, false, disp_thread->clip_rect.x, disp_thread->clip_rect.xx, disp_thread->clip_rect.y, disp_thread->clip_rect.yy);
 	}
 //	mark_rect_dirty_wc( x0-radius, y0-radius, x0+radius+1, y0+radius+1 );
 }
@@ -4366,6 +4662,31 @@ void display_flush_buffer(void)
 	{
 		0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8, 31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
 	};
+
+	// collect the images drawn and the hits of all threads
+	for(  int t = 0;  t < MAX_DISPLAY_THREADS;  t++  ) {
+		display_thread_t &thread = display_threads[t];
+		for(  uint32 i = 0;  i < thread.used_count;  i++  ) {
+			const image_id n = thread.used_images[i];
+			thread.image_used[n >> 3] = 0;
+			if(  n < anz_images  ) {
+				images[n].last_used = image_cache_frame;
+			}
+		}
+		thread.used_count = 0;
+		image_cache_hits += thread.image_hits;
+		thread.image_hits = 0;
+	}
+
+	// above the limit free the copies of images not drawn in this frame
+	if(  image_cache_bytes <= image_cache_limit  ) {
+		image_cache_floor = 0;
+	}
+	const size_t image_cache_threshold = image_cache_limit > image_cache_floor + image_cache_limit / 4 ? image_cache_limit : image_cache_floor + image_cache_limit / 4;
+	if(  image_cache_limit > 0  &&  image_cache_bytes > image_cache_threshold  ) {
+		free_unused_image_copies();
+	}
+	image_cache_frame++;
 #ifdef USE_SOFTPOINTER
 	ex_ord_update_mx_my();
 
@@ -4395,6 +4716,15 @@ void display_flush_buffer(void)
 	old_my = sys_event.my;
 #endif
 
+	// add the tiles marked by the other drawing threads
+	for(  int t = 1;  t < MAX_DISPLAY_THREADS;  t++  ) {
+		uint32 *const thread_dirty = display_threads[t].tile_dirty;
+		for(  int i = 0;  i < tile_buffer_length;  i++  ) {
+			tile_dirty[i] |= thread_dirty[i];
+			thread_dirty[i] = 0;
+		}
+	}
+
 	// combine current with last dirty tiles
 	for(  int i = 0;  i < tile_buffer_length;  i++  ) {
 		tile_dirty_old[i] |= tile_dirty[i];
@@ -4489,6 +4819,7 @@ void display_flush_buffer(void)
 	uint32 *tmp = tile_dirty_old;
 	tile_dirty_old = tile_dirty;
 	tile_dirty = tmp; // _old was cleared to 0 in above loops
+	display_threads[0].tile_dirty = tile_dirty;
 }
 
 
@@ -4603,10 +4934,28 @@ void simgraph_init(KOORD_VAL width, KOORD_VAL height, int full_screen)
 
 	tile_dirty = MALLOCN( uint32, tile_buffer_length );
 	tile_dirty_old = MALLOCN( uint32, tile_buffer_length );
+	init_thread_tile_dirty();
 
 	mark_screen_dirty();
 	MEMZERON( tile_dirty_old, tile_buffer_length );
 
+	// the drawing threads
+	for(  i = 0;  i < MAX_DISPLAY_THREADS;  i++  ) {
+		display_thread_t *const dt = display_threads + i;
+		dt->number_of_clips = 0;
+		dt->active_ribi = 15;
+		dt->player_day = 0xFF;
+		dt->player_night = 0xFF;
+		if(  i == 0  ) {
+			dt->rgbmap_day_night = rgbmap_day_night;
+			dt->rgbmap_all_day = rgbmap_all_day;
+		}
+		else {
+			dt->rgbmap_day_night = MALLOCN( PIXVAL, RGBMAPSIZE+1 );
+			dt->rgbmap_all_day = MALLOCN( PIXVAL, RGBMAPSIZE+1 );
+		}
+		dt->rgbmap_current = dt->rgbmap_day_night;
+	}
 	// init player colors
 	for(i=0;  i<MAX_PLAYER_COUNT;  i++  ) {
 		player_offsets[i][0] = i*8;
@@ -4614,11 +4963,15 @@ void simgraph_init(KOORD_VAL width, KOORD_VAL height, int full_screen)
 	}
 
 	display_set_clip_wh(0, 0, disp_width, disp_height);
+	for(  i = 1;  i < MAX_DISPLAY_THREADS;  i++  ) {
+		display_threads[i].clip_rect = display_threads[0].clip_rect;
+	}
 
 	// Hajo: Calculate daylight rgbmap and save it for unshaded tile drawing
 	display_day_night_shift(0);
 	memcpy(specialcolormap_all_day, specialcolormap_day_night, 256 * sizeof(PIXVAL));
 	memcpy(rgbmap_all_day, rgbmap_day_night, RGBMAPSIZE * sizeof(PIXVAL));
+	copy_rgbmaps_to_threads();
 
 	// find out bit depth
 	{
@@ -4626,34 +4979,16 @@ void simgraph_init(KOORD_VAL width, KOORD_VAL height, int full_screen)
 		while((c&1)==0) {
 			c >>= 1;
 		}
-		if(c==31) {
-			// 15 bit per pixel
-			blend[0] = pix_blend25_15;
-			blend[1] = pix_blend50_15;
-			blend[2] = pix_blend75_15;
-			blend_recode[0] = pix_blend_recode25_15;
-			blend_recode[1] = pix_blend_recode50_15;
-			blend_recode[2] = pix_blend_recode75_15;
-			outline[0] = pix_outline25_15;
-			outline[1] = pix_outline50_15;
-			outline[2] = pix_outline75_15;
-			alpha = pix_alpha_15;
-			alpha_recode = pix_alpha_recode_15;
-		}
-		else {
-			blend[0] = pix_blend25_16;
-			blend[1] = pix_blend50_16;
-			blend[2] = pix_blend75_16;
-			blend_recode[0] = pix_blend_recode25_16;
-			blend_recode[1] = pix_blend_recode50_16;
-			blend_recode[2] = pix_blend_recode75_16;
-			outline[0] = pix_outline25_16;
-			outline[1] = pix_outline50_16;
-			outline[2] = pix_outline75_16;
-			alpha = pix_alpha_16;
-			alpha_recode = pix_alpha_recode_16;
-		}
+		// 15 or 16 bit per pixel
+		rgb555 = c==31;
+	}
+
+	// the fastest pixel routines of this CPU
+	const simd_level_t simd_level = get_cpu_simd_level();
+	if(  !get_pixel_kernels( simd_level, rgb555, kernels )  ) {
+		get_pixel_kernels( SIMD_NONE, rgb555, kernels );
 	}
+	dbg->message("simgraph_init()", "using %s pixel routines", get_simd_level_name(simd_level) );
 
 	printf("Init done.\n");
 	fflush(NULL);
@@ -4680,10 +5015,23 @@ void simgraph_exit()
 
 	guarded_free( tile_dirty_old );
 	guarded_free( tile_dirty );
+	for(  int t = 1;  t < MAX_DISPLAY_THREADS;  t++  ) {
+		guarded_free( display_threads[t].tile_dirty );
+		guarded_free( display_threads[t].rgbmap_day_night );
+		guarded_free( display_threads[t].rgbmap_all_day );
+		display_threads[t].tile_dirty = NULL;
+		display_threads[t].rgbmap_day_night = display_threads[t].rgbmap_all_day = NULL;
+	}
 	display_free_all_images_above(0);
 	guarded_free(images);
+	guarded_free( ground_cache );
+	guarded_free( ground_cache_valid );
+	guarded_free( ground_cache_moved );
+	ground_cache = NULL;
+	ground_cache_valid = ground_cache_moved = NULL;
 
 	tile_dirty = tile_dirty_old = NULL;
+	display_threads[0].tile_dirty = NULL;
 	images = NULL;
 #if MULTI_THREAD>1
 	pthread_mutex_destroy( &rezoom_recode_img_mutex );
@@ -4718,6 +5066,7 @@ void simgraph_resize(KOORD_VAL w, KOORD_VAL h)
 
 			tile_dirty = MALLOCN( uint32, tile_buffer_length );
 			tile_dirty_old = MALLOCN( uint32, tile_buffer_length );
+			init_thread_tile_dirty();
 
 			display_set_clip_wh(0, 0, disp_actual_width, disp_height);
 		}
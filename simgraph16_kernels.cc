@@ -0,0 +1,426 @@
+/*
+ * Copyright 2010 Simutrans contributors
+ * Available under the Artistic License (see license.txt)
+ */
+#if COLOUR_DEPTH == 16
+
+#include "simgraph16_kernels.h"
+#include "simgraph.h"
+
+#if defined(__GNUC__)  &&  (defined(__i386__)  ||  defined(__x86_64__))  &&  (defined(__clang__)  ||  __GNUC__ > 4  ||  (__GNUC__ == 4  &&  __GNUC_MINOR__ >= 9))
+#define SIMD_X86
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER)  &&  _MSC_VER >= 1700  &&  (defined(_M_IX86)  ||  defined(_M_X64))
+#define SIMD_X86
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+
+// different masks needed for RGB 555 and RGB 565
+#define ONE_OUT_16 (0x7bef)
+#define TWO_OUT_16 (0x39E7)
+#define ONE_OUT_15 (0x3DEF)
+#define TWO_OUT_15 (0x1CE7)
+
+// red and blue, and green of the alpha routines
+#define RB_MASK_16 (0xf81f)
+#define G_MASK_16 (0x07e0)
+#define RB_MASK_15 (0x7b1f)
+#define G_MASK_15 (0x03e0)
+
+// where the blended pixels come from
+enum blend_source_t {
+	FROM_IMAGE,   ///< the pixels of the image
+	FROM_RECODE,  ///< the image with replaced player colours
+	FROM_COLOUR   ///< a single colour (outlines)
+};
+
+
+/* plain C routines, also used for the ends of runs by the SIMD routines */
+
+/**
+ * mixes quarter/4 of s with (4-quarter)/4 of d
+ * one_out and two_out clear the bits shifted into the next colour
+ */
+template<int quarter> static inline PIXVAL blend_pixel(const PIXVAL s, const PIXVAL d, const PIXVAL one_out, const PIXVAL two_out)
+{
+	if(  quarter == 1  ) {
+		return ((s>>2) & two_out) + (3*((d>>2) & two_out));
+	}
+	if(  quarter == 2  ) {
+		return ((s>>1) & one_out) + ((d>>1) & one_out);
+	}
+	return (3*((s>>2) & two_out)) + ((d>>2) & two_out);
+}
+
+
+template<int quarter, blend_source_t source, bool rgb555>
+static void pix_blend(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, const PIXVAL colour, const PIXVAL len)
+{
+	const PIXVAL one_out = rgb555 ? ONE_OUT_15 : ONE_OUT_16;
+	const PIXVAL two_out = rgb555 ? TWO_OUT_15 : TWO_OUT_16;
+	const PIXVAL *const end = dest + len;
+	while(  dest < end  ) {
+		const PIXVAL s = source == FROM_IMAGE ? *src : (source == FROM_RECODE ? rgbmap[*src] : colour);
+		*dest = blend_pixel<quarter>( s, *dest, one_out, two_out );
+		dest++;
+		src++;
+	}
+}
+
+
+template<bool recode, bool rgb555>
+static void pix_alpha(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const PIXVAL *rgbmap, const unsigned alpha_flags, const PIXVAL , const PIXVAL len)
+{
+	const PIXVAL *const end = dest + len;
+
+	const uint16 rmask = alpha_flags & ALPHA_RED ? 0x001f : 0;
+	const uint16 gmask = alpha_flags & ALPHA_GREEN ? 0x03e0 : 0;
+	const uint16 bmask = alpha_flags & ALPHA_BLUE ? 0x7b00 : 0;
+	const uint16 rb_mask = rgb555 ? RB_MASK_15 : RB_MASK_16;
+	const uint16 g_mask = rgb555 ? G_MASK_15 : G_MASK_16;
+
+	while(  dest < end  ) {
+		// read mask components - always 15bpp
+		uint16 alpha_value = ((*alphamap) & rmask) + (((*alphamap) & gmask) >> 5) + (((*alphamap) & bmask) >> 10);
+		const PIXVAL s = recode ? rgbmap[*src] : *src;
+
+		if(  alpha_value > 30  ) {
+			// opaque, just copy source
+			*dest = s;
+		}
+		else if(  alpha_value > 0  ) {
+			alpha_value = alpha_value > 15 ? alpha_value + 1 : alpha_value;
+
+			// read screen and image components
+			const uint16 rbs = (*dest) & rb_mask;
+			const uint16 gs =  (*dest) & g_mask;
+			const uint16 rbi = s & rb_mask;
+			const uint16 gi =  s & g_mask;
+
+			// calculate and write destination components
+			const uint16 rbd = ((rbi * alpha_value) + (rbs * (32 - alpha_value))) >> 5;
+			const uint16 gd  = ((gi  * alpha_value) + (gs  * (32 - alpha_value))) >> 5;
+			*dest = (rbd & rb_mask) | (gd & g_mask);
+		}
+
+		dest++;
+		src++;
+		alphamap++;
+	}
+}
+
+
+static void pix_colorcopy(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, const PIXVAL len)
+{
+	const PIXVAL *const end = src + len;
+	while(  src < end  ) {
+		*dest++ = rgbmap[*src++];
+	}
+}
+
+
+#ifdef SIMD_X86
+
+/* SSE2 routines: eight pixels at once */
+
+template<int quarter> TARGET_SSE2 static inline __m128i blend_sse2(const __m128i s, const __m128i d, const __m128i one_out, const __m128i two_out)
+{
+	if(  quarter == 2  ) {
+		return _mm_add_epi16( _mm_and_si128( _mm_srli_epi16(s, 1), one_out ), _mm_and_si128( _mm_srli_epi16(d, 1), one_out ) );
+	}
+	// all sums wrap around at 16 bit, as do the stores of the plain routines
+	const __m128i s4 = _mm_and_si128( _mm_srli_epi16(s, 2), two_out );
+	const __m128i d4 = _mm_and_si128( _mm_srli_epi16(d, 2), two_out );
+	if(  quarter == 1  ) {
+		return _mm_add_epi16( s4, _mm_add_epi16( d4, _mm_add_epi16(d4, d4) ) );
+	}
+	return _mm_add_epi16( d4, _mm_add_epi16( s4, _mm_add_epi16(s4, s4) ) );
+}
+
+
+TARGET_SSE2 static inline __m128i recode_sse2(const PIXVAL *src, const PIXVAL *rgbmap)
+{
+	return _mm_setr_epi16( rgbmap[src[0]], rgbmap[src[1]], rgbmap[src[2]], rgbmap[src[3]], rgbmap[src[4]], rgbmap[src[5]], rgbmap[src[6]], rgbmap[src[7]] );
+}
+
+
+template<int quarter, blend_source_t source, bool rgb555>
+TARGET_SSE2 static void pix_blend_sse2(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, const PIXVAL colour, const PIXVAL len)
+{
+	const __m128i one_out = _mm_set1_epi16( rgb555 ? ONE_OUT_15 : ONE_OUT_16 );
+	const __m128i two_out = _mm_set1_epi16( rgb555 ? TWO_OUT_15 : TWO_OUT_16 );
+	const __m128i c = _mm_set1_epi16( colour );
+	PIXVAL i = 0;
+	for(  ;  i + 8 <= len;  i += 8  ) {
+		const __m128i s = source == FROM_IMAGE ? _mm_loadu_si128( (const __m128i *)(src + i) ) : (source == FROM_RECODE ? recode_sse2( src + i, rgbmap ) : c);
+		const __m128i d = _mm_loadu_si128( (const __m128i *)(dest + i) );
+		_mm_storeu_si128( (__m128i *)(dest + i), blend_sse2<quarter>( s, d, one_out, two_out ) );
+	}
+	pix_blend<quarter, source, rgb555>( dest + i, src + i, rgbmap, colour, len - i );
+}
+
+
+/**
+ * ((x * a) + (y * na)) >> 5 for 16 bit x, y and a + na = 32, modulo 2^16
+ * like the plain routine: the low five bits of x and y are weighted separately,
+ * so no product needs more than 16 bits
+ */
+TARGET_SSE2 static inline __m128i mix_sse2(const __m128i x, const __m128i y, const __m128i a, const __m128i na, const __m128i low_bits)
+{
+	const __m128i high = _mm_add_epi16( _mm_mullo_epi16( _mm_srli_epi16(x, 5), a ), _mm_mullo_epi16( _mm_srli_epi16(y, 5), na ) );
+	const __m128i low = _mm_add_epi16( _mm_mullo_epi16( _mm_and_si128(x, low_bits), a ), _mm_mullo_epi16( _mm_and_si128(y, low_bits), na ) );
+	return _mm_add_epi16( high, _mm_srli_epi16(low, 5) );
+}
+
+
+template<bool recode, bool rgb555>
+TARGET_SSE2 static void pix_alpha_sse2(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const PIXVAL *rgbmap, const unsigned alpha_flags, const PIXVAL colour, const PIXVAL len)
+{
+	const __m128i rmask = _mm_set1_epi16( alpha_flags & ALPHA_RED ? 0x001f : 0 );
+	const __m128i gmask = _mm_set1_epi16( alpha_flags & ALPHA_GREEN ? 0x03e0 : 0 );
+	const __m128i bmask = _mm_set1_epi16( alpha_flags & ALPHA_BLUE ? 0x7b00 : 0 );
+	const __m128i rb_mask = _mm_set1_epi16( (sint16)(rgb555 ? RB_MASK_15 : RB_MASK_16) );
+	const __m128i g_mask = _mm_set1_epi16( rgb555 ? G_MASK_15 : G_MASK_16 );
+	const __m128i low_bits = _mm_set1_epi16( 31 );
+	const __m128i v15 = _mm_set1_epi16( 15 );
+	const __m128i v30 = _mm_set1_epi16( 30 );
+	const __m128i v32 = _mm_set1_epi16( 32 );
+	const __m128i zero = _mm_setzero_si128();
+	PIXVAL i = 0;
+	for(  ;  i + 8 <= len;  i += 8  ) {
+		const __m128i am = _mm_loadu_si128( (const __m128i *)(alphamap + i) );
+		__m128i a = _mm_add_epi16( _mm_and_si128(am, rmask), _mm_add_epi16( _mm_srli_epi16( _mm_and_si128(am, gmask), 5 ), _mm_srli_epi16( _mm_and_si128(am, bmask), 10 ) ) );
+		const __m128i opaque = _mm_cmpgt_epi16( a, v30 );
+		const __m128i visible = _mm_cmpgt_epi16( a, zero );
+		// add one above 15, the compare gives -1
+		a = _mm_sub_epi16( a, _mm_cmpgt_epi16( a, v15 ) );
+		const __m128i na = _mm_sub_epi16( v32, a );
+
+		const __m128i s = recode ? recode_sse2( src + i, rgbmap ) : _mm_loadu_si128( (const __m128i *)(src + i) );
+		const __m128i d = _mm_loadu_si128( (const __m128i *)(dest + i) );
+		const __m128i rb = mix_sse2( _mm_and_si128(s, rb_mask), _mm_and_si128(d, rb_mask), a, na, low_bits );
+		const __m128i g = mix_sse2( _mm_and_si128(s, g_mask), _mm_and_si128(d, g_mask), a, na, low_bits );
+		__m128i r = _mm_or_si128( _mm_and_si128(rb, rb_mask), _mm_and_si128(g, g_mask) );
+		r = _mm_or_si128( _mm_and_si128(opaque, s), _mm_andnot_si128(opaque, r) );
+		r = _mm_or_si128( _mm_and_si128(visible, r), _mm_andnot_si128(visible, d) );
+		_mm_storeu_si128( (__m128i *)(dest + i), r );
+	}
+	pix_alpha<recode, rgb555>( dest + i, src + i, alphamap + i, rgbmap, alpha_flags, colour, len - i );
+}
+
+
+/* AVX2 routines: sixteen pixels at once, the recoding uses gathers */
+
+template<int quarter> TARGET_AVX2 static inline __m256i blend_avx2(const __m256i s, const __m256i d, const __m256i one_out, const __m256i two_out)
+{
+	if(  quarter == 2  ) {
+		return _mm256_add_epi16( _mm256_and_si256( _mm256_srli_epi16(s, 1), one_out ), _mm256_and_si256( _mm256_srli_epi16(d, 1), one_out ) );
+	}
+	const __m256i s4 = _mm256_and_si256( _mm256_srli_epi16(s, 2), two_out );
+	const __m256i d4 = _mm256_and_si256( _mm256_srli_epi16(d, 2), two_out );
+	if(  quarter == 1  ) {
+		return _mm256_add_epi16( s4, _mm256_add_epi16( d4, _mm256_add_epi16(d4, d4) ) );
+	}
+	return _mm256_add_epi16( d4, _mm256_add_epi16( s4, _mm256_add_epi16(s4, s4) ) );
+}
+
+
+/**
+ * rgbmap[src[0..15]]: gathers 32 bit at rgbmap + index, so the entry
+ * behind the index is read too, and keeps the lower half
+ */
+TARGET_AVX2 static inline __m256i recode_avx2(const PIXVAL *src, const PIXVAL *rgbmap)
+{
+	const __m256i index_lo = _mm256_cvtepu16_epi32( _mm_loadu_si128( (const __m128i *)src ) );
+	const __m256i index_hi = _mm256_cvtepu16_epi32( _mm_loadu_si128( (const __m128i *)(src + 8) ) );
+	const __m256i low_half = _mm256_set1_epi32( 0xFFFF );
+	const __m256i lo = _mm256_and_si256( _mm256_i32gather_epi32( (const int *)rgbmap, index_lo, 2 ), low_half );
+	const __m256i hi = _mm256_and_si256( _mm256_i32gather_epi32( (const int *)rgbmap, index_hi, 2 ), low_half );
+	// the pack works within the 128 bit lanes
+	return _mm256_permute4x64_epi64( _mm256_packus_epi32(lo, hi), 0xD8 );
+}
+
+
+template<int quarter, blend_source_t source, bool rgb555>
+TARGET_AVX2 static void pix_blend_avx2(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, const PIXVAL colour, const PIXVAL len)
+{
+	const __m256i one_out = _mm256_set1_epi16( rgb555 ? ONE_OUT_15 : ONE_OUT_16 );
+	const __m256i two_out = _mm256_set1_epi16( rgb555 ? TWO_OUT_15 : TWO_OUT_16 );
+	const __m256i c = _mm256_set1_epi16( colour );
+	PIXVAL i = 0;
+	for(  ;  i + 16 <= len;  i += 16  ) {
+		const __m256i s = source == FROM_IMAGE ? _mm256_loadu_si256( (const __m256i *)(src + i) ) : (source == FROM_RECODE ? recode_avx2( src + i, rgbmap ) : c);
+		const __m256i d = _mm256_loadu_si256( (const __m256i *)(dest + i) );
+		_mm256_storeu_si256( (__m256i *)(dest + i), blend_avx2<quarter>( s, d, one_out, two_out ) );
+	}
+	pix_blend<quarter, source, rgb555>( dest + i, src + i, rgbmap, colour, len - i );
+}
+
+
+TARGET_AVX2 static inline __m256i mix_avx2(const __m256i x, const __m256i y, const __m256i a, const __m256i na, const __m256i low_bits)
+{
+	const __m256i high = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_srli_epi16(x, 5), a ), _mm256_mullo_epi16( _mm256_srli_epi16(y, 5), na ) );
+	const __m256i low = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_and_si256(x, low_bits), a ), _mm256_mullo_epi16( _mm256_and_si256(y, low_bits), na ) );
+	return _mm256_add_epi16( high, _mm256_srli_epi16(low, 5) );
+}
+
+
+template<bool recode, bool rgb555>
+TARGET_AVX2 static void pix_alpha_avx2(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const PIXVAL *rgbmap, const unsigned alpha_flags, const PIXVAL colour, const PIXVAL len)
+{
+	const __m256i rmask = _mm256_set1_epi16( alpha_flags & ALPHA_RED ? 0x001f : 0 );
+	const __m256i gmask = _mm256_set1_epi16( alpha_flags & ALPHA_GREEN ? 0x03e0 : 0 );
+	const __m256i bmask = _mm256_set1_epi16( alpha_flags & ALPHA_BLUE ? 0x7b00 : 0 );
+	const __m256i rb_mask = _mm256_set1_epi16( (sint16)(rgb555 ? RB_MASK_15 : RB_MASK_16) );
+	const __m256i g_mask = _mm256_set1_epi16( rgb555 ? G_MASK_15 : G_MASK_16 );
+	const __m256i low_bits = _mm256_set1_epi16( 31 );
+	const __m256i v15 = _mm256_set1_epi16( 15 );
+	const __m256i v30 = _mm256_set1_epi16( 30 );
+	const __m256i v32 = _mm256_set1_epi16( 32 );
+	const __m256i zero = _mm256_setzero_si256();
+	PIXVAL i = 0;
+	for(  ;  i + 16 <= len;  i += 16  ) {
+		const __m256i am = _mm256_loadu_si256( (const __m256i *)(alphamap + i) );
+		__m256i a = _mm256_add_epi16( _mm256_and_si256(am, rmask), _mm256_add_epi16( _mm256_srli_epi16( _mm256_and_si256(am, gmask), 5 ), _mm256_srli_epi16( _mm256_and_si256(am, bmask), 10 ) ) );
+		const __m256i opaque = _mm256_cmpgt_epi16( a, v30 );
+		const __m256i visible = _mm256_cmpgt_epi16( a, zero );
+		a = _mm256_sub_epi16( a, _mm256_cmpgt_epi16( a, v15 ) );
+		const __m256i na = _mm256_sub_epi16( v32, a );
+
+		const __m256i s = recode ? recode_avx2( src + i, rgbmap ) : _mm256_loadu_si256( (const __m256i *)(src + i) );
+		const __m256i d = _mm256_loadu_si256( (const __m256i *)(dest + i) );
+		const __m256i rb = mix_avx2( _mm256_and_si256(s, rb_mask), _mm256_and_si256(d, rb_mask), a, na, low_bits );
+		const __m256i g = mix_avx2( _mm256_and_si256(s, g_mask), _mm256_and_si256(d, g_mask), a, na, low_bits );
+		__m256i r = _mm256_or_si256( _mm256_and_si256(rb, rb_mask), _mm256_and_si256(g, g_mask) );
+		r = _mm256_blendv_epi8( r, s, opaque );
+		r = _mm256_blendv_epi8( d, r, visible );
+		_mm256_storeu_si256( (__m256i *)(dest + i), r );
+	}
+	pix_alpha<recode, rgb555>( dest + i, src + i, alphamap + i, rgbmap, alpha_flags, colour, len - i );
+}
+
+
+TARGET_AVX2 static void pix_colorcopy_avx2(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, const PIXVAL len)
+{
+	PIXVAL i = 0;
+	for(  ;  i + 16 <= len;  i += 16  ) {
+		_mm256_storeu_si256( (__m256i *)(dest + i), recode_avx2( src + i, rgbmap ) );
+	}
+	pix_colorcopy( dest + i, src + i, rgbmap, len - i );
+}
+
+#endif
+
+
+simd_level_t get_cpu_simd_level()
+{
+#if defined(SIMD_X86)  &&  defined(_MSC_VER)
+	int info[4];
+	__cpuid( info, 0 );
+	const int max_leaf = info[0];
+	__cpuid( info, 1 );
+	const bool sse2 = (info[3] >> 26) & 1;
+	// AVX2 also needs the operating system to save the ymm registers
+	const bool avx = ((info[2] >> 27) & 1)  &&  ((info[2] >> 28) & 1)  &&  (_xgetbv(0) & 6) == 6;
+	if(  avx  &&  max_leaf >= 7  ) {
+		__cpuidex( info, 7, 0 );
+		if(  (info[1] >> 5) & 1  ) {
+			return SIMD_AVX2;
+		}
+	}
+	return sse2 ? SIMD_SSE2 : SIMD_NONE;
+#elif defined(SIMD_X86)
+	__builtin_cpu_init();
+	if(  __builtin_cpu_supports("avx2")  ) {
+		return SIMD_AVX2;
+	}
+	if(  __builtin_cpu_supports("sse2")  ) {
+		return SIMD_SSE2;
+	}
+	return SIMD_NONE;
+#else
+	return SIMD_NONE;
+#endif
+}
+
+
+const char *get_simd_level_name(simd_level_t level)
+{
+	static const char *const names[SIMD_LEVEL_COUNT] = { "plain", "SSE2", "AVX2" };
+	return level < SIMD_LEVEL_COUNT ? names[level] : "?";
+}
+
+
+template<bool rgb555> static bool fill_pixel_kernels(simd_level_t level, pixel_kernels_t &k)
+{
+	switch(  level  ) {
+		case SIMD_NONE:
+			k.blend[0] = pix_blend<1, FROM_IMAGE, rgb555>;
+			k.blend[1] = pix_blend<2, FROM_IMAGE, rgb555>;
+			k.blend[2] = pix_blend<3, FROM_IMAGE, rgb555>;
+			k.blend_recode[0] = pix_blend<1, FROM_RECODE, rgb555>;
+			k.blend_recode[1] = pix_blend<2, FROM_RECODE, rgb555>;
+			k.blend_recode[2] = pix_blend<3, FROM_RECODE, rgb555>;
+			k.outline[0] = pix_blend<1, FROM_COLOUR, rgb555>;
+			k.outline[1] = pix_blend<2, FROM_COLOUR, rgb555>;
+			k.outline[2] = pix_blend<3, FROM_COLOUR, rgb555>;
+			k.alpha = pix_alpha<false, rgb555>;
+			k.alpha_recode = pix_alpha<true, rgb555>;
+			k.colorcopy = pix_colorcopy;
+			return true;
+
+#ifdef SIMD_X86
+		case SIMD_SSE2:
+			k.blend[0] = pix_blend_sse2<1, FROM_IMAGE, rgb555>;
+			k.blend[1] = pix_blend_sse2<2, FROM_IMAGE, rgb555>;
+			k.blend[2] = pix_blend_sse2<3, FROM_IMAGE, rgb555>;
+			k.blend_recode[0] = pix_blend_sse2<1, FROM_RECODE, rgb555>;
+			k.blend_recode[1] = pix_blend_sse2<2, FROM_RECODE, rgb555>;
+			k.blend_recode[2] = pix_blend_sse2<3, FROM_RECODE, rgb555>;
+			k.outline[0] = pix_blend_sse2<1, FROM_COLOUR, rgb555>;
+			k.outline[1] = pix_blend_sse2<2, FROM_COLOUR, rgb555>;
+			k.outline[2] = pix_blend_sse2<3, FROM_COLOUR, rgb555>;
+			k.alpha = pix_alpha_sse2<false, rgb555>;
+			k.alpha_recode = pix_alpha_sse2<true, rgb555>;
+			// without gathers the lookups are not faster
+			k.colorcopy = pix_colorcopy;
+			return true;
+
+		case SIMD_AVX2:
+			k.blend[0] = pix_blend_avx2<1, FROM_IMAGE, rgb555>;
+			k.blend[1] = pix_blend_avx2<2, FROM_IMAGE, rgb555>;
+			k.blend[2] = pix_blend_avx2<3, FROM_IMAGE, rgb555>;
+			k.blend_recode[0] = pix_blend_avx2<1, FROM_RECODE, rgb555>;
+			k.blend_recode[1] = pix_blend_avx2<2, FROM_RECODE, rgb555>;
+			k.blend_recode[2] = pix_blend_avx2<3, FROM_RECODE, rgb555>;
+			k.outline[0] = pix_blend_avx2<1, FROM_COLOUR, rgb555>;
+			k.outline[1] = pix_blend_avx2<2, FROM_COLOUR, rgb555>;
+			k.outline[2] = pix_blend_avx2<3, FROM_COLOUR, rgb555>;
+			k.alpha = pix_alpha_avx2<false, rgb555>;
+			k.alpha_recode = pix_alpha_avx2<true, rgb555>;
+			k.colorcopy = pix_colorcopy_avx2;
+			return true;
+#endif
+
+		default:
+			return false;
+	}
+}
+
+
+bool get_pixel_kernels(simd_level_t level, bool rgb555, pixel_kernels_t &kernels)
+{
+	return rgb555 ? fill_pixel_kernels<true>( level, kernels ) : fill_pixel_kernels<false>( level, kernels );
+}
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2010 Simutrans contributors
+ * Available under the Artistic License (see license.txt)
+ */
+
+#ifndef simgraph16_kernels_h
+#define simgraph16_kernels_h
+
+#include "simtypes.h"
+
+/*
+ * The pixel routines of simgraph16 for transparent images, outlines and
+ * player colours. Each routine processes one run of pixels. Besides the
+ * plain C versions there are SSE2 and AVX2 versions, which give exactly
+ * the same pixels; the best one for the CPU is chosen at startup.
+ */
+
+typedef uint16 PIXVAL;
+
+/// blends len pixels of src (or the colour for outlines) into dest, rgbmap is used for recoding
+typedef void (*blend_proc)(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, const PIXVAL colour, const PIXVAL len);
+
+/// draws len pixels of src onto dest with the alpha values in alphamap
+typedef void (*alpha_proc)(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const PIXVAL *rgbmap, const unsigned alpha_flags, const PIXVAL colour, const PIXVAL len);
+
+/// copies len pixels, replacing the player colours via rgbmap
+typedef void (*colorcopy_proc)(PIXVAL *dest, const PIXVAL *src, const PIXVAL *rgbmap, const PIXVAL len);
+
+struct pixel_kernels_t {
+	// for 25%, 50% and 75% of the image
+	blend_proc blend[3];
+	blend_proc blend_recode[3];
+	blend_proc outline[3];
+	alpha_proc alpha;
+	alpha_proc alpha_recode;
+	colorcopy_proc colorcopy;
+};
+
+enum simd_level_t { SIMD_NONE, SIMD_SSE2, SIMD_AVX2, SIMD_LEVEL_COUNT };
+
+/// the best level supported by this CPU (and this build)
+simd_level_t get_cpu_simd_level();
+
+const char *get_simd_level_name(simd_level_t level);
+
+/**
+ * Fills kernels with the routines of this level for RGB 555 or 565.
+ * The AVX2 routines read one entry behind the largest index into rgbmap.
+ * @return false if the level is not available in this build
+ */
+bool get_pixel_kernels(simd_level_t level, bool rgb555, pixel_kernels_t &kernels);
+
+#endif
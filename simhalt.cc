@@ -604,15 +604,7 @@ haltestelle_t::~haltestelle_t()
 
 	const uint8 max_categories = warenbauer_t::get_max_catg_index();
 
-	for(uint8 i = 0; i < max_categories; i++) {
-		if (waren[i]) {
-			FOR(vector_tpl<ware_t>, const &w, *waren[i]) {
-				fabrik_t::update_transit(w, false);
-			}
-			delete waren[i];
-			waren[i] = NULL;
-		}
-	}
+	remove_all_goods();
 	free( waren );
 	
 	for(uint8 i = 0; i < max_categories; i++)
@@ -2852,6 +2844,121 @@ int haltestelle_t::erzeuge_fussgaenger(karte_t *welt, koord3d pos, int anzahl)
 
 
 
+void haltestelle_t::remove_all_goods()
+{
+	for(uint8 i = 0; i < warenbauer_t::get_max_catg_index(); i++) {
+		if (waren[i]) {
+			FOR(vector_tpl<ware_t>, const &w, *waren[i]) {
+				fabrik_t::update_transit(w, false);
+			}
+			delete waren[i];
+			waren[i] = NULL;
+		}
+	}
+	resort_freight_info = true;
+}
+
+
+/**
+ * Saves or loads the waiting goods (part of rdwr()).
+ * Loaded goods are added to those already waiting.
+ */
+void haltestelle_t::rdwr_goods(loadsave_t *file, uint8 max_catg_count_file)
+{
+	const char *s;
+	if(file->is_saving()) 
+	{
+		for(unsigned i=0; i<max_catg_count_file; i++) 
+		{
+			vector_tpl<ware_t> *warray = waren[i];
+			uint32 ware_count = 1;
+
+			if(warray) 
+			{
+				s = "y";	// needs to be non-empty
+				file->rdwr_str(s);
+				bool has_uint16_count;
+				if(file->get_version() <= 112002 || file->get_experimental_version() <= 10)
+				{
+					const uint32 count = warray->get_count();
+					uint16 short_count = min(count, 65535);
+					file->rdwr_short(short_count);
+					has_uint16_count = true;
+				}
+				else
+				{
+					// Experimental version 11 and above - very large/busy halts might
+					// have a count > 65535, so use the proper uint32 value.
+					
+					// In previous versions, the use of "short" lead to corrupted saved
+					// games when the value was larger than 32,767.
+
+					uint32 count = warray->get_count();
+					file->rdwr_long(count);
+					has_uint16_count = false;
+				}
+				FOR(vector_tpl<ware_t>, & ware, *warray) 
+				{
+					if(has_uint16_count && ware_count++ > 65535)
+					{
+						// Discard ware packets > 65535 if the version is < 11, as trying
+						// to save greater than this number will corrupt the save.
+						ware.menge = 0;
+					}
+					else
+					{
+						ware.rdwr(welt,file);
+					}
+				}
+			}
+		}
+		s = "";
+		file->rdwr_str(s);
+	}
+	else 
+	{
+		// restoring all goods in the station
+		char s[256];
+		file->rdwr_str(s, lengthof(s));
+		while(*s) {
+			uint32 count;
+			if(  file->get_version() <= 112002  || file->get_experimental_version() <= 10 ) {
+				// Older versions stored only 16-bit count values.
+				uint16 scount;
+				file->rdwr_short(scount);
+				count = scount;
+			}
+			else {
+				file->rdwr_long(count);
+			}
+			if(count>0) {
+				for(  uint32 i = 0;  i < count;  i++  ) {
+					// add to internal storage (use this function, since the old categories were different)
+					ware_t ware(welt,file);
+					if(  ware.menge>0  &&  welt->is_within_limits(ware.get_zielpos())  ) {
+						add_ware_to_halt(ware, true);
+						/*
+						 * It's very easy for in-transit information to get corrupted,
+						 * if an intermediate program version fails to compute it right.
+						 * So *always* compute it fresh.
+						 */ 
+						// if(  file->get_version() <= 112000  ) {
+							// restore intransit information
+							fabrik_t::update_transit( ware, true );
+						// }
+					}
+					else if(  ware.menge>0  ) 
+					{
+						dbg->error( "haltestelle_t::rdwr()", "%i of %s to %s ignored!", ware.menge, ware.get_name(), ware.get_zielpos().get_str() );
+					}
+				}
+			}
+			file->rdwr_str(s, lengthof(s));
+		}
+	}
+}
+
+
 void haltestelle_t::rdwr(loadsave_t *file)
 {
 	xml_tag_t h( file, "haltestelle_t" );
@@ -2981,57 +3088,10 @@ void haltestelle_t::rdwr(loadsave_t *file)
 		file->rdwr_byte(max_catg_count_file);
 	}
 
-	const char *s;
 	init_pos = tiles.empty() ? koord::invalid : tiles.front().grund->get_pos().get_2d();
+	rdwr_goods( file, max_catg_count_file );
 	if(file->is_saving()) 
 	{
-		for(unsigned i=0; i<max_catg_count_file; i++) 
-		{
-			vector_tpl<ware_t> *warray = waren[i];
-			uint32 ware_count = 1;
-
-			if(warray) 
-			{
-				s = "y";	// needs to be non-empty
-				file->rdwr_str(s);
-				bool has_uint16_count;
-				if(file->get_version() <= 112002 || file->get_experimental_version() <= 10)
-				{
-					const uint32 count = warray->get_count();
-					uint16 short_count = min(count, 65535);
-					file->rdwr_short(short_count);
-					has_uint16_count = true;
-				}
-				else
-				{
-					// Experimental version 11 and above - very large/busy halts might
-					// have a count > 65535, so use the proper uint32 value.
-					
-					// In previous versions, the use of "short" lead to corrupted saved
-					// games when the value was larger than 32,767.
-
-					uint32 count = warray->get_count();
-					file->rdwr_long(count);
-					has_uint16_count = false;
-				}
-				FOR(vector_tpl<ware_t>, & ware, *warray) 
-				{
-					if(has_uint16_count && ware_count++ > 65535)
-					{
-						// Discard ware packets > 65535 if the version is < 11, as trying
-						// to save greater than this number will corrupt the save.
-						ware.menge = 0;
-					}
-					else
-					{
-						ware.rdwr(welt,file);
-					}
-				}
-			}
-		}
-		s = "";
-		file->rdwr_str(s);
-
 #ifdef DEBUG_SIMRAND_CALLS
 		if (waren[0])
 		{
@@ -3052,45 +3112,6 @@ void haltestelle_t::rdwr(loadsave_t *file)
 	}
 	else 
 	{
-		// restoring all goods in the station
-		char s[256];
-		file->rdwr_str(s, lengthof(s));
-		while(*s) {
-			uint32 count;
-			if(  file->get_version() <= 112002  || file->get_experimental_version() <= 10 ) {
-				// Older versions stored only 16-bit count values.
-				uint16 scount;
-				file->rdwr_short(scount);
-				count = scount;
-			}
-			else {
-				file->rdwr_long(count);
-			}
-			if(count>0) {
-				for(  uint32 i = 0;  i < count;  i++  ) {
-					// add to internal storage (use this function, since the old categories were different)
-					ware_t ware(welt,file);
-					if(  ware.menge>0  &&  welt->is_within_limits(ware.get_zielpos())  ) {
-						add_ware_to_halt(ware, true);
-						/*
-						 * It's very easy for in-transit information to get corrupted,
-						 * if an intermediate program version fails to compute it right.
-						 * So *always* compute it fresh.
-						 */ 
-						// if(  file->get_version() <= 112000  ) {
-							// restore intransit information
-							fabrik_t::update_transit( ware, true );
-						// }
-					}
-					else if(  ware.menge>0  ) 
-					{
-						dbg->error( "haltestelle_t::rdwr()", "%i of %s to %s ignored!", ware.menge, ware.get_name(), ware.get_zielpos().get_str() );
-					}
-				}
-			}
-			file->rdwr_str(s, lengthof(s));
-		}
-
 		// old games save the list with stations
 		// however, we have to rebuilt them anyway for the new format
 		if(file->get_version()<99013) {
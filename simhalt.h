@@ -769,6 +769,15 @@ public:
 
 	void rdwr(loadsave_t *file);
 
+	/**
+	 * Saves or loads only the waiting goods, as in rdwr(); loading adds them.
+	 * Used with remove_all_goods() to resync a halt in network games.
+	 */
+	void rdwr_goods(loadsave_t *file, uint8 max_catg_count_file);
+
+	/// removes the waiting goods, with their transit at the factories
+	void remove_all_goods();
+
 	void laden_abschliessen(bool need_recheck_for_walking_distance);
 
 	/*
@@ -34,6 +34,7 @@
 #include "simgraph.h"
 #include "simevent.h"
 #include "simtools.h"
+#include "simprofile.h"
 
 #include "simversion.h"
 
@@ -194,6 +195,93 @@ static void show_times(karte_t *welt, karte_ansicht_t *view)
 #endif
 
 
+// seed of the random generator for all benchmark runs
+#define BENCHMARK_SEED (42)
+
+// appends str as quoted JSON string
+static void json_append_string( cbuffer_t &buf, const char *str )
+{
+	buf.append( "\"" );
+	for(  const char *c = str;  *c;  c++  ) {
+		if(  *c == '"'  ||  *c == '\\'  ) {
+			buf.printf( "\\%c", *c );
+		}
+		else if(  (uint8)*c < 32  ) {
+			buf.printf( "\\u%04x", (uint8)*c );
+		}
+		else {
+			buf.printf( "%c", *c );
+		}
+	}
+	buf.append( "\"" );
+}
+
+
+/* headless benchmark:
+ * runs the loaded game for step_count steps as fast as possible with a fixed
+ * random seed and writes the timings of the phases as JSON to filename
+ * (or to stdout, if NULL)
+ */
+static void run_benchmark( karte_t *welt, uint32 step_count, const char *savegame, const char *filename )
+{
+	intr_disable();
+	welt->set_pause( false );
+	welt->set_fast_forward( false );
+	// no autosaves in between
+	const sint32 old_autosave = umgebung_t::autosave;
+	umgebung_t::autosave = 0;
+
+	// like a network game: frames_per_step sync steps of a fixed length per step
+	const uint32 frames_per_step = max( 1u, welt->get_settings().get_frames_per_step() );
+	const long frame_time = 1000 / clamp( (long)welt->get_settings().get_frames_per_second(), 5l, 100l );
+
+	setsimrand( BENCHMARK_SEED, 0xFFFFFFFFu );
+	welt->reset_timer();
+	profiler::reset();
+	dbg->message( "run_benchmark()", "%u steps with %u sync steps of %li ms each", step_count, frames_per_step, frame_time );
+
+	const uint64 start = profiler::get_time_us();
+	for(  uint32 i = 0;  i < step_count;  i++  ) {
+		for(  uint32 j = 0;  j < frames_per_step;  j++  ) {
+			welt->sync_step( frame_time, true, false );
+		}
+		set_random_mode( STEP_RANDOM );
+		welt->step();
+		clear_random_mode( STEP_RANDOM );
+	}
+	const uint64 wall_us = max( (uint64)1, profiler::get_time_us() - start );
+	umgebung_t::autosave = old_autosave;
+
+	cbuffer_t buf;
+	buf.append( "{\n\t\"version\": " );
+	json_append_string( buf, VERSION_NUMBER EXPERIMENTAL_VERSION " " VERSION_DATE );
+	buf.append( ",\n\t\"savegame\": " );
+	json_append_string( buf, savegame );
+	buf.printf( ",\n\t\"seed\": %d,\n", BENCHMARK_SEED );
+	buf.printf( "\t\"steps\": %u,\n", step_count );
+	buf.printf( "\t\"sync_steps\": %u,\n", step_count * frames_per_step );
+	buf.printf( "\t\"wall_time_ms\": %.3f,\n", wall_us / 1000.0 );
+	buf.printf( "\t\"steps_per_second\": %.3f,\n", step_count * 1000000.0 / wall_us );
+	buf.printf( "\t\"sync_steps_per_second\": %.3f,\n", step_count * frames_per_step * 1000000.0 / wall_us );
+	buf.append( "\t\"phases\": {" );
+	for(  int p = 0;  p < MAX_PROFILE_PHASES;  p++  ) {
+		const profile_phase_t phase = (profile_phase_t)p;
+		buf.printf( "%s\n\t\t\"%s\": { \"calls\": %u, \"total_ms\": %.3f, \"share\": %.4f }", p ? "," : "", profiler::get_name(phase), profiler::get_count(phase), profiler::get_total_us(phase) / 1000.0, (double)profiler::get_total_us(phase) / wall_us );
+	}
+	buf.append( "\n\t}\n}\n" );
+
+	FILE *f = filename ? fopen( filename, "w" ) : stdout;
+	if(  f == NULL  ) {
+		dbg->error( "run_benchmark()", "cannot write results to \"%s\"", filename );
+		f = stdout;
+	}
+	fputs( buf.get_str(), f );
+	if(  f != stdout  ) {
+		fclose( f );
+	}
+}
+
+
 void modal_dialogue( gui_frame_t *gui, ptrdiff_t magic, karte_t *welt, bool (*quit)() )
 {
 	if(  display_get_width()==0  ) {
@@ -422,6 +510,9 @@ int simu_main(int argc, char** argv)
 			" -addons             loads also addons (with -objects)\n"
 			" -async              asynchronous images, only for SDL\n"
 			" -use_hw             hardware double buffering, only for SDL\n"
+			" -benchmark N [FILE] runs the game given by -load for N steps as fast\n"
+			"                     as possible, writes the timings as JSON to FILE\n"
+			"                     (or stdout) and quits\n"
 			" -debug NUM          enables debugging (1..5)\n"
 			" -freeplay           play with endless money\n"
 			" -fullscreen         starts simutrans in fullscreen mode\n"
@@ -811,6 +902,7 @@ int simu_main(int argc, char** argv)
 	dbg->important("Preparing display ...");
 	DBG_MESSAGE("simmain", "simgraph_init disp_width=%d, disp_height=%d, fullscreen=%d", disp_width, disp_height, fullscreen);
 	simgraph_init(disp_width, disp_height, fullscreen);
+	display_set_image_cache_limit( (size_t)umgebung_t::image_cache_size << 20 );
 	DBG_MESSAGE("simmain", ".. results in disp_width=%d, disp_height=%d", display_get_width(), display_get_height());
 
 	// The loading screen needs to be initialized
@@ -1185,6 +1277,22 @@ DBG_MESSAGE("simmain","demo file not found at %s",buf.get_str() );
 	}
 #endif
 
+	// only a benchmark run?
+	if(  gimme_arg(argc, argv, "-benchmark", 1) != NULL  ) {
+		const char *out = gimme_arg(argc, argv, "-benchmark", 2);
+		if(  out  &&  out[0] == '-'  ) {
+			// this is already the next parameter
+			out = NULL;
+		}
+		if(  loadgame.empty()  ) {
+			dbg->error( "simu_main()", "-benchmark needs a savegame given by -load" );
+		}
+		else {
+			run_benchmark( welt, atoi( gimme_arg(argc, argv, "-benchmark", 1) ), loadgame.c_str(), out );
+		}
+		umgebung_t::quit_simutrans = true;
+	}
+
 	welt->reset_timer();
 	if(  !umgebung_t::networkmode  &&  !umgebung_t::server  ) {
 #ifdef display_in_main
@@ -207,6 +207,7 @@ werkzeug_t *create_dialog_tool(int toolnr)
 		case WKZ_CLIMATES:       tool = new wkz_climates_t(); break;
 		case WKZ_SETTINGS:       tool = new wkz_settings_t(); break;
 		case WKZ_GAMEINFO:       tool = new wkz_server_t(); break;
+		case WKZ_PROFILE:        tool = new wkz_profile_t(); break;
 		default:                 dbg->error("create_dialog_tool()","cannot satisfy request for dialog_tool[%i]!",toolnr);
 		                         return NULL;
 	}
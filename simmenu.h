@@ -145,6 +145,7 @@ enum {
 	WKZ_CLIMATES,
 	WKZ_SETTINGS,
 	WKZ_GAMEINFO,
+	WKZ_PROFILE,
 	DIALOGE_TOOL_COUNT,
 	DIALOGE_TOOL = 0x4000
 };
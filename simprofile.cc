@@ -0,0 +1,131 @@
+/*
+ * This file is part of the Simutrans project under the artistic license.
+ * (see license.txt)
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "simprofile.h"
+#include "utils/cbuffer_t.h"
+
+
+static uint64 total_us[MAX_PROFILE_PHASES];
+static uint32 count[MAX_PROFILE_PHASES];
+
+// ring buffers of the last PROFILE_RECENT times
+static uint32 recent_us[MAX_PROFILE_PHASES][PROFILE_RECENT];
+
+static const char *const phase_names[MAX_PROFILE_PHASES] = {
+	"sync_step",
+	"sync_eyecandy",
+	"sync_way_eyecandy",
+	"sync_objects",
+	"display",
+	"new_month",
+	"step",
+	"seasons",
+	"path_explorer",
+	"convoys",
+	"cities",
+	"factories",
+	"power",
+	"players",
+	"halts",
+	"scenario"
+};
+
+
+uint64 profiler::get_time_us()
+{
+#ifdef _WIN32
+	static LARGE_INTEGER frequency;
+	if(  frequency.QuadPart == 0  ) {
+		QueryPerformanceFrequency( &frequency );
+	}
+	LARGE_INTEGER now;
+	QueryPerformanceCounter( &now );
+	return (uint64)( now.QuadPart / frequency.QuadPart ) * 1000000u + (uint64)( now.QuadPart % frequency.QuadPart ) * 1000000u / frequency.QuadPart;
+#else
+	timeval now;
+	gettimeofday( &now, NULL );
+	return (uint64)now.tv_sec * 1000000u + now.tv_usec;
+#endif
+}
+
+
+uint64 profiler::add(profile_phase_t phase, uint64 start)
+{
+	const uint64 now = get_time_us();
+	const uint64 time_us = now - start;
+	total_us[phase] += time_us;
+	recent_us[phase][count[phase] % PROFILE_RECENT] = time_us < 0xFFFFFFFFu ? (uint32)time_us : 0xFFFFFFFFu;
+	count[phase] ++;
+	return now;
+}
+
+
+uint64 profiler::get_total_us(profile_phase_t phase)
+{
+	return total_us[phase];
+}
+
+
+uint32 profiler::get_count(profile_phase_t phase)
+{
+	return count[phase];
+}
+
+
+void profiler::get_recent(profile_phase_t phase, uint32 &min_us, uint32 &avg_us, uint32 &max_us)
+{
+	const uint32 n = count[phase] < PROFILE_RECENT ? count[phase] : PROFILE_RECENT;
+	if(  n == 0  ) {
+		min_us = avg_us = max_us = 0;
+		return;
+	}
+	uint64 sum = 0;
+	min_us = 0xFFFFFFFFu;
+	max_us = 0;
+	for(  uint32 i = 0;  i < n;  i++  ) {
+		const uint32 t = recent_us[phase][i];
+		sum += t;
+		if(  t < min_us  ) {
+			min_us = t;
+		}
+		if(  t > max_us  ) {
+			max_us = t;
+		}
+	}
+	avg_us = (uint32)(sum / n);
+}
+
+
+void profiler::print(cbuffer_t &buf)
+{
+	buf.printf( "Last %d calls (min/avg/max in ms):\n", PROFILE_RECENT );
+	for(  int p = 0;  p < MAX_PROFILE_PHASES;  p++  ) {
+		const profile_phase_t phase = (profile_phase_t)p;
+		uint32 min_us, avg_us, max_us;
+		get_recent( phase, min_us, avg_us, max_us );
+		buf.printf( "%-18s %8.3f %8.3f %8.3f\n", get_name(phase), min_us / 1000.0, avg_us / 1000.0, max_us / 1000.0 );
+	}
+}
+
+
+const char *profiler::get_name(profile_phase_t phase)
+{
+	return phase_names[phase];
+}
+
+
+void profiler::reset()
+{
+	for(  int i = 0;  i < MAX_PROFILE_PHASES;  i++  ) {
+		total_us[i] = 0;
+		count[i] = 0;
+	}
+}
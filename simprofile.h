@@ -0,0 +1,74 @@
+/*
+ * This file is part of the Simutrans project under the artistic license.
+ * (see license.txt)
+ */
+
+#ifndef SIMPROFILE_H
+#define SIMPROFILE_H
+
+#include "simtypes.h"
+
+class cbuffer_t;
+
+// number of recent calls for the rolling minimum, average and maximum
+#define PROFILE_RECENT (64)
+
+/**
+ * The subsystems of karte_t::step() and karte_t::sync_step() whose time is
+ * accumulated. PROFILE_SYNC_STEP and PROFILE_STEP are the whole (simulation
+ * part of the) step, the phases following them are parts of it.
+ */
+enum profile_phase_t {
+	PROFILE_SYNC_STEP = 0,
+	PROFILE_SYNC_EYECANDY,
+	PROFILE_SYNC_WAY_EYECANDY,
+	PROFILE_SYNC_OBJECTS,
+	PROFILE_DISPLAY,
+	PROFILE_NEW_MONTH,
+	PROFILE_STEP,
+	PROFILE_SEASONS,
+	PROFILE_PATH_EXPLORER,
+	PROFILE_CONVOIS,
+	PROFILE_CITIES,
+	PROFILE_FACTORIES,
+	PROFILE_POWER,
+	PROFILE_PLAYERS,
+	PROFILE_HALTS,
+	PROFILE_SCENARIO,
+	MAX_PROFILE_PHASES
+};
+
+/**
+ * Very simple wall time accounting of the simulation phases.
+ * Only to be called from the main thread.
+ */
+namespace profiler
+{
+	/// microseconds since an arbitrary start, only differences are meaningful
+	uint64 get_time_us();
+
+	/**
+	 * Adds the time since start (taken from get_time_us()) to this phase.
+	 * @return the current time, to be used as start of the next phase
+	 */
+	uint64 add(profile_phase_t phase, uint64 start);
+
+	/// accumulated time since the last reset()
+	uint64 get_total_us(profile_phase_t phase);
+
+	/// number of add() calls since the last reset()
+	uint32 get_count(profile_phase_t phase);
+
+	/// minimum, average and maximum time of the last PROFILE_RECENT calls (zero without any)
+	void get_recent(profile_phase_t phase, uint32 &min_us, uint32 &avg_us, uint32 &max_us);
+
+	/// appends a human readable table of the recent times of all phases
+	void print(cbuffer_t &buf);
+
+	/// short name without spaces, e.g. for machine readable output
+	const char *get_name(profile_phase_t phase);
+
+	void reset();
+}
+
+#endif
@@ -34,6 +34,36 @@ uint32 simrand_normal(const uint32 max, const char*);
 /* generates a random number on [0,0xFFFFFFFFu]-interval */
 uint32 simrand_plain(void);
 
+/**
+ * A separate stream of game random numbers, for work done in parallel threads:
+ * seeded from simrand() in a fixed order, it gives the same numbers on all clients
+ * regardless of which thread draws them.
+ */
+class simrand_stream_t
+{
+	uint32 state;
+
+public:
+	simrand_stream_t() : state(1) { }
+
+	void set_seed(uint32 seed) { state = seed ? seed : 1; }
+
+	/* generates a random number on [0,0xFFFFFFFFu]-interval (xorshift) */
+	uint32 rand_plain()
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	/* generates a random number on [0,max-1]-interval */
+	uint32 rand(const uint32 max) { return max <= 1 ? 0 : rand_plain() % max; }
+
+	/* same distribution as simrand_normal() */
+	uint32 rand_normal(const uint32 max) { return max <= 1 ? 0 : ( rand(max) * rand(max) ) / max; }
+};
+
 double perlin_noise_2D(const double x, const double y, const double persistence, const sint32 map_size = 512);
 
 // for netowrk debugging, i.e. finding hidden simrands in worng places
@@ -64,6 +94,12 @@ template<typename T, template<typename> class U> T const& pick_any_weighted(U<T>
 	return container.at_weight(simrand(container.get_sum_weight(), "template<typename T, template<typename> class U> T const& pick_any_weighted(U<T> const& container)"));
 }
 
+/* Randomly select an entry from the given weighted container, using a separate random stream. */
+template<typename T, template<typename> class U> T const& pick_any_weighted(U<T> const& container, simrand_stream_t &random)
+{
+	return container.at_weight(random.rand(container.get_sum_weight()));
+}
+
 /* Randomly select an entry from the given subset of a weighted container. */
 template<typename T, typename U> T const& pick_any_weighted_subset(U const& container)
 {
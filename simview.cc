@@ -16,11 +16,14 @@
 #include "simconst.h"
 #include "simplan.h"
 #include "simmenu.h"
+#include "simloadingscreen.h"
 #include "player/simplay.h"
 #include "besch/grund_besch.h"
 #include "boden/wasser.h"
 #include "dataobj/umgebung.h"
+#include "dataobj/translator.h"
 #include "dings/zeiger.h"
+#include "tpl/vector_tpl.h"
 
 #include "simtools.h"
 
@@ -56,6 +59,7 @@ typedef struct{
 	koord	wh;
 	sint16	y_min;
 	sint16	y_max;
+	int	thread_nr;
 } display_region_param_t;
 
 // now the paramters
@@ -66,6 +70,9 @@ void *display_region_thread( void *ptr )
 	display_region_param_t *view = reinterpret_cast<display_region_param_t *>(ptr);
 	while(true) {
 		pthread_barrier_wait( &display_barrier_start );	// wait for all to start
+		// own clipping and dirty tiles, selected each frame in case anything else used this slot meanwhile
+		display_select_thread( view->thread_nr, true );
+		display_set_clip_wh( view->lt.x, view->lt.y, view->wh.x, view->wh.y );
 		view->show_routine->display_region( view->lt, view->wh, view->y_min, view->y_max, false, true );
 		pthread_barrier_wait( &display_barrier_end );	// wait for all to finish
 	}
@@ -81,6 +88,28 @@ static pthread_mutex_t hide_mutex;
 static bool can_multithreading = true;
 #endif
 
+// the ground is taken from the cache in this frame, it is only drawn in these rectangles
+static bool ground_cached = false;
+static vector_tpl<clip_dimension> ground_rects;
+
+
+// a progress bar is only shown for many images, like at startup with a big pakset
+static void prepare_images_progress(unsigned done, unsigned total)
+{
+	static loadingscreen_t *ls = NULL;
+	if(  done == 0  ) {
+		if(  total >= 4096  ) {
+			ls = new loadingscreen_t( translator::translate("Preparing images ..."), total );
+		}
+	}
+	else if(  ls  ) {
+		ls->set_progress( done );
+		if(  done == total  ) {
+			delete ls;
+			ls = NULL;
+		}
+	}
+}
 
 
 void karte_ansicht_t::display(bool force_dirty)
@@ -165,8 +194,49 @@ void karte_ansicht_t::display(bool force_dirty)
 	int y_min = (-const_y_off + 4*tile_raster_scale_y( min(hmax_ground, welt->get_grundwasser())*TILE_HEIGHT_STEP, IMG_SIZE )
 					+ 4*(menu_height-IMG_SIZE)-IMG_SIZE/2-1) / IMG_SIZE;
 
+	// after a change of zoom or colours find the visible images and rezoom and recode them in bulk, not one by one while drawing
+	if(  display_images_need_prepare()  ) {
+		display_collect_images( true );
+		display_region( koord(0,menu_height), koord(disp_width,disp_height-menu_height), y_min, dpy_height+4*4, false, false );
+		display_collect_images( false );
+		display_prepare_images( prepare_images_progress );
+		// collecting has cleared the dirty flags
+		mark_rect_dirty_wc( 0, menu_height, disp_width, disp_height );
+	}
+
+	// the ground which did not change is copied from the last frames
+	if(  umgebung_t::ground_cache  ) {
+		// the screen position of the origin of the world moves when scrolling
+		const koord diff = -welt->get_world_position()-welt->get_view_ij_offset();
+		const sint32 origin_x = (diff.x-diff.y)*(IMG_SIZE/2) + const_x_off;
+		const sint32 origin_y = (diff.x+diff.y)*(IMG_SIZE/4) + ((disp_width/IMG_SIZE)&1)*(IMG_SIZE/4) + const_y_off;
+		// everything else the ground depends on (the colours are handled by simgraph)
+		uint32 state = IMG_SIZE;
+		state = state*31 + grund_t::underground_mode;
+		state = state*31 + (uint8)grund_t::underground_level;
+		state = state*31 + grund_t::show_grid + 2*umgebung_t::simple_drawing;
+		state = state*31 + umgebung_t::background_color;
+		if(  umgebung_t::hide_under_cursor  &&  !grund_t::show_grid  ) {
+			// then the grid is shown around the cursor
+			const koord cursor_pos = welt->get_zeiger() ? welt->get_zeiger()->get_pos().get_2d() : koord(-1000,-1000);
+			state = state*31 + (uint16)cursor_pos.x;
+			state = state*31 + (uint16)cursor_pos.y;
+		}
+		if(  display_ground_cache_begin( 0, menu_height, disp_width, disp_height-menu_height, origin_x, origin_y, state )  ) {
+			invalidate_ground_cache( y_min, dpy_height+4*4 );
+			ground_rects.clear();
+			clip_dimension r;
+			while(  display_ground_cache_next_invalid( r.x, r.y, r.w, r.h )  ) {
+				r.xx = r.x + r.w;
+				r.yy = r.y + r.h;
+				ground_rects.append( r );
+			}
+			ground_cached = true;
+		}
+	}
+
 #if MULTI_THREAD>1
-	if(  umgebung_t::simple_drawing  &&  can_multithreading  ) {
+	if(  can_multithreading  ) {
 
 		if(!spawned_threads) {
 			// we can do the parallel display using posix threads ...
@@ -183,6 +253,7 @@ void karte_ansicht_t::display(bool force_dirty)
 			pthread_mutex_init( &hide_mutex, NULL );
 
 			for(  int t=0;  t<MULTI_THREAD-1;  t++  ) {
+				ka[t].thread_nr = t+1;
 				if(  pthread_create(&thread[t], &attr, display_region_thread, (void *)&ka[t])  ) {
 					can_multithreading = false;
 					dbg->error( "karte_ansicht_t::display()", "cannot multithread, error at thread #%i", t+1 );
@@ -195,11 +266,12 @@ void karte_ansicht_t::display(bool force_dirty)
 		}
 
 		// set parameter for each thread
+		// each one draws everything in its strip, clipped at the borders, so no strip needs to be redrawn
 		for(  int t=0;  t<MULTI_THREAD-1;  t++  ) {
 			// equals to: display_region( koord(t*(disp_width/NUM_THREADS),menu_height), koord(disp_width/NUM_THREADS,disp_height-menu_height), y_min, dpy_height+4*4, force_dirty );
 		   	ka[t].show_routine = this;
 			ka[t].lt = koord((t*disp_width)/MULTI_THREAD,menu_height);
-			ka[t].wh = koord((disp_width/MULTI_THREAD)-((t==MULTI_THREAD-1)?0:IMG_SIZE),disp_height-menu_height);
+			ka[t].wh = koord(((t+1)*disp_width)/MULTI_THREAD-ka[t].lt.x,disp_height-menu_height);
 			ka[t].y_min = y_min;
 			ka[t].y_max = dpy_height+4*4;
 		}
@@ -207,20 +279,14 @@ void karte_ansicht_t::display(bool force_dirty)
 		pthread_barrier_wait( &display_barrier_start );
 
 		// the last we can run ourselves
-		display_region( koord( ((MULTI_THREAD-1)*disp_width)/MULTI_THREAD,menu_height), koord(disp_width/MULTI_THREAD,disp_height-menu_height), y_min, dpy_height+4*4, false, true );
+		const KOORD_VAL start_x = ((MULTI_THREAD-1)*disp_width)/MULTI_THREAD;
+		display_select_thread( 0, true );
+		display_set_clip_wh( start_x, menu_height, disp_width-start_x, disp_height-menu_height );
+		display_region( koord( start_x,menu_height), koord(disp_width-start_x,disp_height-menu_height), y_min, dpy_height+4*4, false, true );
+		display_select_thread( 0, false );
+		display_set_clip_wh( 0, menu_height, disp_width, disp_height-menu_height );
 
 		pthread_barrier_wait( &display_barrier_end );
-
-		// and now draw the overlapping region single threaded with clipping
-		for(  int t=1;  t<MULTI_THREAD;  t++  ) {
-			KOORD_VAL start_x = (t*disp_width)/MULTI_THREAD-IMG_SIZE;
-			display_set_clip_wh( start_x, menu_height, IMG_SIZE, disp_height-menu_height );
-			if(grund_t::underground_mode) {
-				display_fillbox_wh(start_x, menu_height, IMG_SIZE, disp_height-menu_height, COL_BLACK, force_dirty);
-			}
-			display_region( koord( start_x,menu_height), koord(IMG_SIZE,disp_height-menu_height), y_min, dpy_height+4*4, false, false );
-		}
-		display_set_clip_wh( 0, menu_height, disp_width, disp_height-menu_height );
 	}
 	else
 #endif
@@ -228,6 +294,7 @@ void karte_ansicht_t::display(bool force_dirty)
 		// slow serial way of display
 		display_region( koord(0,menu_height), koord(disp_width,disp_height-menu_height), y_min, dpy_height+4*4, false, false );
 	}
+	ground_cached = false;
 
 	// and finally overlays (station coverage and signs)
 	for(sint16 y=y_min; y<dpy_height+4*4; y++) {
@@ -312,6 +379,32 @@ void karte_ansicht_t::display(bool force_dirty)
 
 
 void karte_ansicht_t::display_region( koord lt, koord wh, sint16 y_min, const sint16 y_max, bool force_dirty, bool threaded )
+{
+	if(  ground_cached  ) {
+		// the ground is only drawn where the cache is invalid, the rest is copied from it
+		FOR(vector_tpl<clip_dimension>, const& r, ground_rects) {
+			const KOORD_VAL x = max( r.x, lt.x );
+			const KOORD_VAL y = max( r.y, lt.y );
+			const KOORD_VAL w = min( r.xx, (KOORD_VAL)(lt.x+wh.x) ) - x;
+			const KOORD_VAL h = min( r.yy, (KOORD_VAL)(lt.y+wh.y) ) - y;
+			if(  w > 0  &&  h > 0  ) {
+				display_set_clip_wh( x, y, w, h );
+				display_fillbox_wh_clip( x, y, w, h, grund_t::underground_mode ? COL_BLACK : umgebung_t::background_color, false );
+				display_region_ground( koord(x,y), koord(w,h), y_min, y_max, threaded );
+				display_ground_cache_store( x, y, w, h );
+			}
+		}
+		display_set_clip_wh( lt.x, lt.y, wh.x, wh.y );
+		display_ground_cache_restore( lt.x, lt.y, wh.x, wh.y );
+	}
+	else {
+		y_min = display_region_ground( lt, wh, y_min, y_max, threaded );
+	}
+	display_region_dinge( lt, wh, y_min, y_max, threaded );
+}
+
+
+sint16 karte_ansicht_t::display_region_ground( koord lt, koord wh, sint16 y_min, const sint16 y_max, bool threaded )
 {
 	const sint16 IMG_SIZE = get_tile_raster_width();
 
@@ -325,26 +418,23 @@ void karte_ansicht_t::display_region( koord lt, koord wh, sint16 y_min, const si
 	// to save calls to grund_t::get_disp_height
 	const sint8 hmax_ground = (grund_t::underground_mode==grund_t::ugm_level) ? grund_t::underground_level : 127;
 
+	// when drawing a strip, tiles next to it are drawn clipped too, since their vehicles and those of their neighbours may reach into it
+	const sint16 margin = threaded ? IMG_SIZE : 0;
+
 	// prepare for selectively display
 	const koord cursor_pos = welt->get_zeiger() ? welt->get_zeiger()->get_pos().get_2d() : koord(-1000,-1000);
 #if MULTI_THREAD>1
 	if(  threaded  ) {
 		pthread_mutex_lock( &grid_mutex  );
-		pthread_mutex_lock( &hide_mutex  );
 	}
 #endif
 	const bool saved_grid = grund_t::show_grid;
-	const bool saved_hide_trees = umgebung_t::hide_trees;
-	const uint8 saved_hide_buildings = umgebung_t::hide_buildings;
 #if MULTI_THREAD>1
 	if(  threaded  ) {
 		pthread_mutex_unlock( &grid_mutex  );
-		pthread_mutex_unlock( &hide_mutex  );
 	}
 #endif
 	bool lock_restore_grid = false;	// true while showing grid
-	bool lock_restore_hiding = false; // true while hiding buildings/trees around cursor
-	const bool needs_hiding = !umgebung_t::hide_trees  |  (umgebung_t::hide_buildings != umgebung_t::ALL_HIDDEN_BUIDLING);
 
 	for( int y=y_min;  y<y_max;  y++  ) {
 
@@ -352,13 +442,13 @@ void karte_ansicht_t::display_region( koord lt, koord wh, sint16 y_min, const si
 		// plotted = we plotted something for y=lower bound
 		bool plotted = y>y_min;
 
-		for(  sint16 x=-2-((y+dpy_width) & 1);  (x*(IMG_SIZE/2) + const_x_off) < (lt.x+wh.x);  x+=2  ) {
+		for(  sint16 x=-2-((y+dpy_width) & 1);  (x*(IMG_SIZE/2) + const_x_off) < (lt.x+wh.x+margin);  x+=2  ) {
 
 			const sint16 i = ((y+x) >> 1) + i_off;
 			const sint16 j = ((y-x) >> 1) + j_off;
 			const sint16 xpos = x*(IMG_SIZE/2) + const_x_off;
 
-			if(  xpos+IMG_SIZE>lt.x  ) {
+			if(  xpos+IMG_SIZE+margin>lt.x  ) {
 				const koord pos(i,j);
 				if(  grund_t* const kb = welt->lookup_kartenboden(pos)  ) {
 					const sint16 yypos = ypos - tile_raster_scale_y(min(kb->get_hoehe(), hmax_ground) * TILE_HEIGHT_STEP, IMG_SIZE);
@@ -422,6 +512,43 @@ void karte_ansicht_t::display_region( koord lt, koord wh, sint16 y_min, const si
 		}
 #endif
 	}
+	return y_min;
+}
+
+
+void karte_ansicht_t::display_region_dinge( koord lt, koord wh, sint16 y_min, const sint16 y_max, bool threaded )
+{
+	const sint16 IMG_SIZE = get_tile_raster_width();
+
+	const int i_off = welt->get_world_position().x - display_get_width()/(2*IMG_SIZE) - display_get_height()/IMG_SIZE;
+	const int j_off = welt->get_world_position().y + display_get_width()/(2*IMG_SIZE) - display_get_height()/IMG_SIZE;
+	const int const_x_off = welt->get_x_off();
+	const int const_y_off = welt->get_y_off();
+
+	const int dpy_width = display_get_width()/IMG_SIZE + 2;
+
+	// to save calls to grund_t::get_disp_height
+	const sint8 hmax_ground = (grund_t::underground_mode==grund_t::ugm_level) ? grund_t::underground_level : 127;
+
+	// when drawing a strip, tiles next to it are drawn clipped too, since their vehicles and those of their neighbours may reach into it
+	const sint16 margin = threaded ? IMG_SIZE : 0;
+
+	// prepare for selectively display
+	const koord cursor_pos = welt->get_zeiger() ? welt->get_zeiger()->get_pos().get_2d() : koord(-1000,-1000);
+#if MULTI_THREAD>1
+	if(  threaded  ) {
+		pthread_mutex_lock( &hide_mutex  );
+	}
+#endif
+	const bool saved_hide_trees = umgebung_t::hide_trees;
+	const uint8 saved_hide_buildings = umgebung_t::hide_buildings;
+#if MULTI_THREAD>1
+	if(  threaded  ) {
+		pthread_mutex_unlock( &hide_mutex  );
+	}
+#endif
+	bool lock_restore_hiding = false; // true while hiding buildings/trees around cursor
+	const bool needs_hiding = !umgebung_t::hide_trees  |  (umgebung_t::hide_buildings != umgebung_t::ALL_HIDDEN_BUIDLING);
 
 	// and then things (and other ground)
 	// especially necessary for vehicles
@@ -429,13 +556,13 @@ void karte_ansicht_t::display_region( koord lt, koord wh, sint16 y_min, const si
 
 		const sint16 ypos = y*(IMG_SIZE/4) + const_y_off;
 
-		for(  sint16 x=-2-((y+dpy_width) & 1);  (x*(IMG_SIZE/2) + const_x_off)<(lt.x+wh.x);  x+=2  ) {
+		for(  sint16 x=-2-((y+dpy_width) & 1);  (x*(IMG_SIZE/2) + const_x_off)<(lt.x+wh.x+margin);  x+=2  ) {
 
 			const int i = ((y+x) >> 1) + i_off;
 			const int j = ((y-x) >> 1) + j_off;
 			const int xpos = x*(IMG_SIZE/2) + const_x_off;
 
-			if(  xpos+IMG_SIZE>lt.x  ) {
+			if(  xpos+IMG_SIZE+margin>lt.x  ) {
 				const koord pos(i,j);
 				const planquadrat_t *plan=welt->lookup(pos);
 				if(plan  &&  plan->get_kartenboden()) {
@@ -518,7 +645,43 @@ void karte_ansicht_t::display_region( koord lt, koord wh, sint16 y_min, const si
 		}
 #endif
 	}
-	(void) threaded;
+}
+
+
+void karte_ansicht_t::invalidate_ground_cache( sint16 y_min, const sint16 y_max )
+{
+	const sint16 IMG_SIZE = get_tile_raster_width();
+
+	const int i_off = welt->get_world_position().x - display_get_width()/(2*IMG_SIZE) - display_get_height()/IMG_SIZE;
+	const int j_off = welt->get_world_position().y + display_get_width()/(2*IMG_SIZE) - display_get_height()/IMG_SIZE;
+	const int const_x_off = welt->get_x_off();
+	const int const_y_off = welt->get_y_off();
+
+	const int dpy_width = display_get_width()/IMG_SIZE + 2;
+
+	// to save calls to grund_t::get_disp_height
+	const sint8 hmax_ground = (grund_t::underground_mode==grund_t::ugm_level) ? grund_t::underground_level : 127;
+
+	for(  int y=y_min;  y<y_max;  y++  ) {
+
+		const sint16 ypos = y*(IMG_SIZE/4) + const_y_off;
+
+		for(  sint16 x=-2-((y+dpy_width) & 1);  (x*(IMG_SIZE/2) + const_x_off) < display_get_width();  x+=2  ) {
+
+			const sint16 i = ((y+x) >> 1) + i_off;
+			const sint16 j = ((y-x) >> 1) + j_off;
+			const sint16 xpos = x*(IMG_SIZE/2) + const_x_off;
+
+			if(  xpos+IMG_SIZE>0  ) {
+				const grund_t* const kb = welt->lookup_kartenboden(koord(i,j));
+				if(  kb  &&  kb->is_boden_dirty()  ) {
+					// also the fences above the tile
+					const sint16 yypos = ypos - tile_raster_scale_y(min(kb->get_hoehe(), hmax_ground) * TILE_HEIGHT_STEP, IMG_SIZE);
+					display_ground_cache_invalidate( xpos, yypos-IMG_SIZE/2, xpos+IMG_SIZE-1, yypos+IMG_SIZE-1 );
+				}
+			}
+		}
+	}
 }
 
 
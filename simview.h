@@ -45,9 +45,21 @@ public:
 	 * @param y_max Minimum height of the screen (bottom pixel row) to start processing objects to draw.
 	 * @param dirty If set to true, will mark the whole rectangle as dirty.
 	 * @param threaded If set to true, indicates there are more threads drawing on screen, and this routine will use mutexes when needed.
+	 * Then the clipping rectangle must be set to the rectangle, since also the tiles next to it are drawn.
 	 */
 	void display_region( koord lt, koord wh, sint16 y_min, const sint16 y_max, bool force_dirty, bool threaded );
 
+	/**
+	 * The two parts of display_region(): first the ground and the ways of all tiles, which is kept in the ground cache
+	 * (see display_ground_cache_begin()), then the objects on them.
+	 * @return the ground part returns y_min, increased by the rows with nothing visible
+	 */
+	sint16 display_region_ground( koord lt, koord wh, sint16 y_min, const sint16 y_max, bool threaded );
+	void display_region_dinge( koord lt, koord wh, sint16 y_min, const sint16 y_max, bool threaded );
+
+	/// Invalidates the ground cache where the visible ground changed since the last frame.
+	void invalidate_ground_cache( sint16 y_min, const sint16 y_max );
+
 	/**
 	 * Draws background in the specified rectangular screen coordinates.
 	 * @param xp X screen coordinate of the left-top corner.
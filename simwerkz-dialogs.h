@@ -45,6 +45,7 @@
 #include "gui/climates.h"
 #include "gui/settings_frame.h"
 #include "gui/server_frame.h"
+#include "gui/profile_frame.h"
 #include "gui/schedule_list.h"
 
 class spieler_t;
@@ -500,4 +501,19 @@ public:
 	bool is_init_network_save() const OVERRIDE { return true; }
 	bool is_work_network_save() const OVERRIDE { return true; }
 };
+
+/* times of the simulation phases (debug) */
+class wkz_profile_t : public werkzeug_t {
+public:
+	wkz_profile_t() : werkzeug_t(WKZ_PROFILE | DIALOGE_TOOL) {}
+	char const* get_tooltip(spieler_t const*) const OVERRIDE { return translator::translate("Profiling"); }
+	bool is_selected(karte_t const*) const OVERRIDE { return win_get_magic(magic_profile); }
+	bool init(karte_t*, spieler_t*) OVERRIDE {
+		create_win( new profile_frame_t(), w_info, magic_profile );
+		return false;
+	}
+	bool exit(karte_t*, spieler_t*) OVERRIDE { destroy_win(magic_profile); return false; }
+	bool is_init_network_save() const OVERRIDE { return true; }
+	bool is_work_network_save() const OVERRIDE { return true; }
+};
 #endif
@@ -104,7 +104,9 @@ enum magic_numbers {
 	magic_replace=magic_halt_detail+65536,
 	magic_toolbar=magic_replace+65536,
 	magic_info_pointer=magic_toolbar+256,
-	magic_max = magic_info_pointer+843
+	// new ones behind, since the ids of saved windows must not change
+	magic_profile=magic_info_pointer+843,
+	magic_max
 };
 
 // Holding time for auto-closing windows
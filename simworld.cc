@@ -36,6 +36,7 @@
 #include "simloadingscreen.h"
 #include "simmenu.h"
 #include "simmesg.h"
+#include "simprofile.h"
 #include "simskin.h"
 #include "simsound.h"
 #include "simsys.h"
@@ -93,6 +94,8 @@
 #include "utils/cbuffer_t.h"
 #include "utils/simstring.h"
 #include "utils/memory_rw.h"
+#include "utils/simthread.h"
+#include "utils/searchfolder.h"
 
 #include "bauer/brueckenbauer.h"
 #include "bauer/tunnelbauer.h"
@@ -156,6 +159,12 @@ void station_check(const char *who, karte_t *welt)
 // frame per second for fast forward
 #define FF_PPS (10)
 
+// rows of tiles per savegame segment, for the delta autosaves
+#define SAVE_SEGMENT_ROWS (16)
+
+// the full autosaves which delta autosaves refer to, in the save folder, named by their id
+#define AUTOSAVE_BASE_PREFIX "autosave-base-"
+
 
 static bool is_dragging = false;
 static uint32 last_clients = -1;
@@ -270,6 +279,148 @@ void karte_t::world_xy_loop(xy_loop_func function, bool sync_x_steps)
 }
 
 
+// the route searches of the current step, see karte_t::calc_convoi_routes()
+static vector_tpl<convoi_t::route_search_t> convoi_route_searches;
+
+#if MULTI_THREAD>1
+static pthread_mutex_t convoi_route_search_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32 next_convoi_route_search;
+
+void karte_t::calc_convoi_routes_part(void *, int)
+{
+	while(  true  ) {
+		// take the next search not yet done
+		pthread_mutex_lock( &convoi_route_search_mutex );
+		const uint32 i = next_convoi_route_search++;
+		pthread_mutex_unlock( &convoi_route_search_mutex );
+		if(  i >= convoi_route_searches.get_count()  ) {
+			break;
+		}
+		convoi_t::route_search_t &search = convoi_route_searches[i];
+		search.result = search.cnv->front()->search_route( search.start, search.ziel, search.max_speed, &search.route );
+	}
+}
+#endif
+
+
+#if MULTI_THREAD>1
+static pthread_mutex_t passenger_plan_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32 next_passenger_plan_city;
+
+void karte_t::plan_passenger_trips_part(void *args, int)
+{
+	karte_t *const welt = (karte_t *)args;
+	while(  true  ) {
+		// take the next city not yet planned
+		pthread_mutex_lock( &passenger_plan_mutex );
+		const uint32 i = next_passenger_plan_city++;
+		pthread_mutex_unlock( &passenger_plan_mutex );
+		if(  i >= welt->stadt.get_count()  ) {
+			break;
+		}
+		welt->stadt[i]->plan_passagiere();
+	}
+}
+#endif
+
+
+void karte_t::plan_passenger_trips()
+{
+	set_random_mode( INTERACTIVE_RANDOM ); // do not allow simrand() here!
+#if MULTI_THREAD>1
+	next_passenger_plan_city = 0;
+	run_parallel( plan_passenger_trips_part, this, min( MULTI_THREAD, (int)stadt.get_count() ) );
+#else
+	FOR(weighted_vector_tpl<stadt_t*>, const i, stadt) {
+		i->plan_passagiere();
+	}
+#endif
+	clear_random_mode( INTERACTIVE_RANDOM );
+}
+
+
+#if MULTI_THREAD>1
+static pthread_mutex_t factory_production_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32 next_factory_production;
+static long factory_production_delta_t;
+
+// factories taken at once by a thread, since a single production step is cheap
+#define FACTORY_PRODUCTION_CHUNK (16)
+
+void karte_t::step_factory_production_part(void *args, int)
+{
+	karte_t *const welt = (karte_t *)args;
+	const uint32 count = welt->fab_list.get_count();
+	while(  true  ) {
+		// take the next factories not yet stepped
+		pthread_mutex_lock( &factory_production_mutex );
+		const uint32 first = next_factory_production;
+		next_factory_production += FACTORY_PRODUCTION_CHUNK;
+		pthread_mutex_unlock( &factory_production_mutex );
+		if(  first >= count  ) {
+			break;
+		}
+		const uint32 last = min( first + FACTORY_PRODUCTION_CHUNK, count );
+		for(  uint32 i = first;  i < last;  i++  ) {
+			welt->fab_list[i]->step_production( factory_production_delta_t );
+		}
+	}
+}
+#endif
+
+
+void karte_t::step_factory_production(long delta_t)
+{
+	set_random_mode( INTERACTIVE_RANDOM ); // do not allow simrand() here!
+#if MULTI_THREAD>1
+	next_factory_production = 0;
+	factory_production_delta_t = delta_t;
+	run_parallel( step_factory_production_part, this, min( MULTI_THREAD, (int)((fab_list.get_count() + FACTORY_PRODUCTION_CHUNK - 1) / FACTORY_PRODUCTION_CHUNK) ) );
+#else
+	FOR(vector_tpl<fabrik_t*>, const f, fab_list) {
+		f->step_production(delta_t);
+	}
+#endif
+	clear_random_mode( INTERACTIVE_RANDOM );
+}
+
+
+void karte_t::calc_convoi_routes()
+{
+	convoi_route_searches.clear();
+	FOR(vector_tpl<convoihandle_t>, const cnv, convoi_array) {
+		convoi_t::route_search_t search;
+		if(  cnv->prepare_route_search(search)  ) {
+			convoi_route_searches.append(search);
+		}
+	}
+	if(  convoi_route_searches.empty()  ) {
+		return;
+	}
+
+	// the node arrays must be set up before the threads start searching
+	if(  !route_t::MAX_STEP  ) {
+		route_t::INIT_NODES( settings.get_max_route_steps(), get_size() );
+	}
+
+	set_random_mode( INTERACTIVE_RANDOM ); // do not allow simrand() here!
+#if MULTI_THREAD>1
+	next_convoi_route_search = 0;
+	run_parallel( calc_convoi_routes_part, NULL, min( MULTI_THREAD, (int)convoi_route_searches.get_count() ) );
+#else
+	FOR(vector_tpl<convoi_t::route_search_t>, & search, convoi_route_searches) {
+		search.result = search.cnv->front()->search_route( search.start, search.ziel, search.max_speed, &search.route );
+	}
+#endif
+	clear_random_mode( INTERACTIVE_RANDOM );
+
+	// now hand the results to the convoys
+	FOR(vector_tpl<convoi_t::route_search_t>, & search, convoi_route_searches) {
+		search.cnv->set_prepared_route_search( &search );
+	}
+}
+
+
 void checklist_t::rdwr(memory_rw_t *buffer)
 {
 	buffer->rdwr_long(random_seed);
@@ -281,13 +432,14 @@ void checklist_t::rdwr(memory_rw_t *buffer)
 		buffer->rdwr_long(industry_density_proportion);
 		buffer->rdwr_long(actual_industry_density);
 		buffer->rdwr_long(traffic);
+		buffer->rdwr_long(world_hash);
 	}
 }
 
 
 int checklist_t::print(char *buffer, const char *entity) const
 {
-	return sprintf(buffer, "%s=[rand=%u halt=%u line=%u cnvy=%u ind_dns_prop=%u act_ind_dens=%u traffic=%u] ", entity, random_seed, halt_entry, line_entry, convoy_entry, industry_density_proportion, actual_industry_density, traffic);
+	return sprintf(buffer, "%s=[rand=%u halt=%u line=%u cnvy=%u ind_dns_prop=%u act_ind_dens=%u traffic=%u world=%08x] ", entity, random_seed, halt_entry, line_entry, convoy_entry, industry_density_proportion, actual_industry_density, traffic, world_hash);
 }
 
 
@@ -642,6 +794,9 @@ DBG_MESSAGE("karte_t::destroy()", "destroying world");
 
 	is_shutting_down = true;
 
+	// the next autosave will be a full one again
+	autosave_base.clear();
+
 	uint32 max_display_progress = 256+stadt.get_count()*10 + haltestelle_t::get_alle_haltestellen().get_count() + convoi_array.get_count() + (cached_size.x*cached_size.y)*2;
 	uint32 old_progress = 0;
 
@@ -1887,6 +2042,8 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 
 	// Resize marker_t:
 	marker.init(new_groesse_x, new_groesse_y);
+	// the route search markers are sized like the map, so they must be renewed too
+	route_t::TERM_NODES();
 
 	distribute_groundobjs_cities(sets, old_x, old_y);
 
@@ -3059,16 +3216,15 @@ DBG_MESSAGE( "karte_t::rotate90()", "called" );
 	if( cached_grid_size.x != cached_grid_size.y ) {
 		// the marking array and the map must be reinit
 		marker.init( cached_grid_size.x, cached_grid_size.y );
+		route_t::TERM_NODES();
 		reliefkarte_t::get_karte()->set_welt( this );
 	}
 
 	//  rotate map search array
 	fabrikbauer_t::neue_karte( this );
 
-	// update minimap
-	if(reliefkarte_t::is_visible) {
-		reliefkarte_t::get_karte()->set_mode( reliefkarte_t::get_karte()->get_mode() );
-	}
+	// update minimap: all tiles have moved
+	reliefkarte_t::get_karte()->calc_map();
 
 	get_scenario()->rotate90( cached_size.x );
 
@@ -3422,6 +3578,7 @@ void karte_t::sync_step(long delta_t, bool sync, bool display )
 	haltestelle_t::pedestrian_limit = 0;
 	if(sync) {
 		// only omitted, when called to display a new frame during fast forward
+		const uint64 sync_step_start = profiler::get_time_us();
 
 		// just for progress
 		if(  delta_t > 10000  ) {
@@ -3436,12 +3593,15 @@ void karte_t::sync_step(long delta_t, bool sync, bool display )
 		 * foundations etc are added removed freuently during city growth
 		 * => they are now in a hastable!
 		 */
+		uint64 phase_start = profiler::get_time_us();
 		sync_eyecandy_step( delta_t );
+		phase_start = profiler::add( PROFILE_SYNC_EYECANDY, phase_start );
 
 		/* pedestrians do not require exact sync and are added/removed frequently
 		 * => they are now in a hastable!
 		 */
 		sync_way_eyecandy_step( delta_t );
+		phase_start = profiler::add( PROFILE_SYNC_WAY_EYECANDY, phase_start );
 
 		clear_random_mode( INTERACTIVE_RANDOM );
 
@@ -3500,10 +3660,13 @@ void karte_t::sync_step(long delta_t, bool sync, bool display )
 		}
 
 		sync_step_running = false;
+		profiler::add( PROFILE_SYNC_OBJECTS, phase_start );
+		profiler::add( PROFILE_SYNC_STEP, sync_step_start );
 	}
 
 	if(display) {
 		// only omitted in fast forward mode for the magic steps
+		const uint64 display_start = profiler::get_time_us();
 
 		for(int x=0; x<MAX_PLAYER_COUNT-1; x++) {
 			if(spieler[x]) {
@@ -3529,6 +3692,7 @@ void karte_t::sync_step(long delta_t, bool sync, bool display )
 		// display new frame with water animation
 		intr_refresh_display( false );
 		update_frame_sleep_time(delta_t);
+		profiler::add( PROFILE_DISPLAY, display_start );
 	}
 	clear_random_mode( SYNC_STEP_RANDOM );
 }
@@ -3878,7 +4042,7 @@ void karte_t::new_month()
 	if( !umgebung_t::networkmode  &&  umgebung_t::autosave>0  &&  last_month%umgebung_t::autosave==0 ) {
 		char buf[128];
 		sprintf( buf, "save/autosave%02i.sve", last_month+1 );
-		save( buf, loadsave_t::autosave_mode, umgebung_t::savegame_version_str, umgebung_t::savegame_ex_version_str, true );
+		autosave( buf );
 	}
 
 	set_citycar_speed_average();
@@ -4130,7 +4294,9 @@ void karte_t::step()
 		next_month_ticks += karte_t::ticks_per_world_month;
 
 		DBG_DEBUG4("karte_t::step", "calling neuer_monat");
+		const uint64 new_month_start = profiler::get_time_us();
 		new_month();
+		profiler::add( PROFILE_NEW_MONTH, new_month_start );
 	}
 
 	DBG_DEBUG4("karte_t::step", "time calculations");
@@ -4182,6 +4348,7 @@ void karte_t::step()
 		// network mode
 	}
 	// now do the step ...
+	const uint64 step_start = profiler::get_time_us();
 	last_step_ticks = ticks;
 	steps ++;
 
@@ -4189,6 +4356,7 @@ void karte_t::step()
 	INT_CHECK("karte_t::step");
 
 	// check for pending seasons change
+	uint64 phase_start = profiler::get_time_us();
 	if(pending_season_change>0) {
 		// process
 		const uint32 end_count = min( cached_grid_size.x*cached_grid_size.y,  tile_counter + max( 16384, cached_grid_size.x*cached_grid_size.y/16 ) );
@@ -4211,10 +4379,13 @@ void karte_t::step()
 	INT_CHECK("karte_t::step 1");
 
 	// Knightly : calling global path explorer
+	phase_start = profiler::add( PROFILE_SEASONS, phase_start );
 	path_explorer_t::step();
+	phase_start = profiler::add( PROFILE_PATH_EXPLORER, phase_start );
 	INT_CHECK("karte_t::step 2");
 	
 	DBG_DEBUG4("karte_t::step 4", "step %d convois", convoi_array.get_count());
+	calc_convoi_routes();
 	// since convois will be deleted during stepping, we need to step backwards
 	for (size_t i = convoi_array.get_count(); i-- != 0;) {
 		convoihandle_t cnv = convoi_array[i];
@@ -4223,6 +4394,14 @@ void karte_t::step()
 			INT_CHECK("karte_t::step 5");
 		}
 	}
+	// routes not taken are outdated in the next step
+	FOR(vector_tpl<convoi_t::route_search_t>, const& search, convoi_route_searches) {
+		if(  search.cnv.is_bound()  ) {
+			search.cnv->set_prepared_route_search( NULL );
+		}
+	}
+	convoi_route_searches.clear();
+	phase_start = profiler::add( PROFILE_CONVOIS, phase_start );
 
 	if(cities_awaiting_private_car_route_check.get_count() > 0 && (steps % 12) == 0)
 	{
@@ -4240,21 +4419,32 @@ void karte_t::step()
 		bev += i->get_finance_history_month(0, HIST_CITICENS);
 	}
 
+	// generate the passengers: plan the trips, then book them in city order
+	plan_passenger_trips();
+	FOR(weighted_vector_tpl<stadt_t*>, const i, stadt) {
+		i->step_passagiere();
+	}
+
 	// the inhabitants stuff
 	finance_history_month[0][WORLD_CITICENS] = bev;
+	phase_start = profiler::add( PROFILE_CITIES, phase_start );
 
 	DBG_DEBUG4("karte_t::step", "step factories");
+	// first the production of all factories, then the distribution in fab_list order
+	step_factory_production(delta_t);
 	FOR(vector_tpl<fabrik_t*>, const f, fab_list) {
 		f->step(delta_t);
 	}
 
 	finance_history_year[0][WORLD_FACTORIES] = finance_history_month[0][WORLD_FACTORIES] = fab_list.get_count();
+	phase_start = profiler::add( PROFILE_FACTORIES, phase_start );
 
 	// step powerlines - required order: pumpe, senke, then powernet
 	DBG_DEBUG4("karte_t::step", "step poweline stuff");
 	pumpe_t::step_all( delta_t );
 	senke_t::step_all( delta_t );
 	powernet_t::step_all( delta_t );
+	phase_start = profiler::add( PROFILE_POWER, phase_start );
 
 	DBG_DEBUG4("karte_t::step", "step players");
 	// then step all players
@@ -4263,9 +4453,11 @@ void karte_t::step()
 			spieler[i]->step();
 		}
 	}
+	phase_start = profiler::add( PROFILE_PLAYERS, phase_start );
 
 	DBG_DEBUG4("karte_t::step", "step halts");
 	haltestelle_t::step_all();
+	profiler::add( PROFILE_HALTS, phase_start );
 
 	// Re-check paths if the time has come. 
 	// Long months means that it might be necessary to do
@@ -4332,9 +4524,12 @@ void karte_t::step()
 #endif
 	}
 
+	phase_start = profiler::get_time_us();
 	if(  get_scenario()->is_scripted() ) {
 		get_scenario()->step();
 	}
+	profiler::add( PROFILE_SCENARIO, phase_start );
+	profiler::add( PROFILE_STEP, step_start );
 	DBG_DEBUG4("karte_t::step", "end");
 }
 
@@ -4859,10 +5054,11 @@ bool karte_t::play_sound_area_clipped(koord const pos, uint16 const idx) const
 }
 
 
-void karte_t::save(const char *filename, loadsave_t::mode_t savemode, const char *version_str, const char *ex_version_str, bool silent )
+bool karte_t::save(const char *filename, loadsave_t::mode_t savemode, const char *version_str, const char *ex_version_str, bool silent, const savegame_segments_t *base, savegame_segments_t *written )
 {
 DBG_MESSAGE("karte_t::speichern()", "saving game to '%s'", filename);
 	loadsave_t  file;
+	bool ok = false;
 	bool save_temp = strstart( filename, "save/" );
 	const char *savename = save_temp ? "save/_temp.sve" : filename;
 
@@ -4872,6 +5068,7 @@ DBG_MESSAGE("karte_t::speichern()", "saving game to '%s'", filename);
 		// Make local saving/loading faster in network mode.
 		savemode = loadsave_t::zipped;
 	}
+	file.set_segments( base, written );
 	if(!file.wr_open( savename, savemode, umgebung_t::objfilename.c_str(), version_str, ex_version_str )) {
 		create_win(new news_img("Kann Spielstand\nnicht speichern.\n"), w_info, magic_none);
 		dbg->error("karte_t::speichern()","cannot open file for writing! check permissions!");
@@ -4885,6 +5082,7 @@ DBG_MESSAGE("karte_t::speichern()", "saving game to '%s'", filename);
 			create_win( new news_img(err_str), w_time_delete, magic_none);
 		}
 		else {
+			ok = true;
 			if(  save_temp  ) {
 				remove( filename );
 				rename( savename, filename );
@@ -4898,6 +5096,112 @@ DBG_MESSAGE("karte_t::speichern()", "saving game to '%s'", filename);
 		reset_interaction();
 	}
 	display_show_load_pointer( false );
+	return ok;
+}
+
+
+// copies a file, e.g. an autosave to its base
+static bool copy_file(const char *from, const char *to)
+{
+	FILE *in = fopen( from, "rb" );
+	if(  in == NULL  ) {
+		return false;
+	}
+	FILE *out = fopen( to, "wb" );
+	if(  out == NULL  ) {
+		fclose( in );
+		return false;
+	}
+	bool ok = true;
+	char buf[65536];
+	size_t len;
+	while(  ok  &&  (len = fread( buf, 1, sizeof(buf), in )) > 0  ) {
+		ok = fwrite( buf, 1, len, out ) == len;
+	}
+	ok &= !ferror( in );
+	fclose( in );
+	ok &= fclose( out ) == 0;
+	if(  !ok  ) {
+		dbg->warning( "copy_file()", "cannot copy %s to %s", from, to );
+		remove( to );
+	}
+	return ok;
+}
+
+
+// removes the autosave bases other than current_base which no savegame refers to
+static void remove_unused_autosave_bases(const std::string &current_base)
+{
+	// the bases still referred to by any savegame
+	searchfolder_t sf;
+	sf.search( "save/", "sve", false, false );
+	vector_tpl<std::string> used;
+	used.append( current_base );
+	FOR( searchfolder_t, const name, sf ) {
+		std::string base_name;
+		if(  loadsave_t::get_base_name( (std::string("save/") + name).c_str(), base_name )  ) {
+			used.append_unique( base_name );
+		}
+	}
+	FOR( searchfolder_t, const name, sf ) {
+		if(  strstart( name, AUTOSAVE_BASE_PREFIX )  &&  !used.is_contained( name )  ) {
+			remove( (std::string("save/") + name).c_str() );
+		}
+	}
+}
+
+
+void karte_t::autosave(const char *filename)
+{
+	const char *version_str = umgebung_t::savegame_version_str;
+	const char *ex_version_str = umgebung_t::savegame_ex_version_str;
+	if(  umgebung_t::delta_autosaves<=0  ||  loadsave_t::autosave_mode!=loadsave_t::zipped_blocks  ) {
+		save( filename, loadsave_t::autosave_mode, version_str, ex_version_str, true );
+		return;
+	}
+
+	if(  autosave_base.file_id!=0  &&  autosave_base.deltas<(uint32)umgebung_t::delta_autosaves  ) {
+		// only the rows changed since the last full autosave
+		if(  save( filename, loadsave_t::zipped_blocks, version_str, ex_version_str, true, &autosave_base, NULL )  ) {
+			autosave_base.deltas++;
+		}
+		// the overwritten autosave may have been the last one referring to an older base
+		remove_unused_autosave_bases( autosave_base.filename );
+		return;
+	}
+
+	// a new full autosave, and a copy of it as the base for the next ones
+	autosave_base.clear();
+	if(  save( filename, loadsave_t::zipped_blocks, version_str, ex_version_str, true, NULL, &autosave_base )  ) {
+		char base_name[64];
+		sprintf( base_name, AUTOSAVE_BASE_PREFIX "%08x.sve", autosave_base.file_id );
+		if(  copy_file( filename, (std::string("save/") + base_name).c_str() )  ) {
+			autosave_base.filename = base_name;
+		}
+		else {
+			autosave_base.clear();
+		}
+	}
+	else {
+		autosave_base.clear();
+	}
+	remove_unused_autosave_bases( autosave_base.filename );
+}
+
+
+bool karte_t::save(memory_file_t *mem, const char *version_str, const char *ex_version_str)
+{
+	DBG_MESSAGE("karte_t::save()", "saving game to memory");
+	loadsave_t file;
+	display_show_load_pointer( true );
+	bool ok = file.wr_open( mem, umgebung_t::objfilename.c_str(), version_str, ex_version_str );
+	if(  ok  ) {
+		save( &file, true );
+		ok = file.close()==NULL;
+		reset_interaction();
+	}
+	display_show_load_pointer( false );
+	return ok;
 }
 
 
@@ -5000,6 +5304,10 @@ DBG_MESSAGE("karte_t::speichern(loadsave_t *file)", "start");
 DBG_MESSAGE("karte_t::speichern(loadsave_t *file)", "saved cities ok");
 
 	for(int j=0; j<get_size().y; j++) {
+		if(  j%SAVE_SEGMENT_ROWS==0  ) {
+			// unchanged rows are not repeated by delta autosaves
+			file->start_segment( j/SAVE_SEGMENT_ROWS + 1 );
+		}
 		for(int i=0; i<get_size().x; i++) {
 			plan[i+j*cached_grid_size.x].rdwr(this, file, koord(i,j) );
 		}
@@ -5010,6 +5318,7 @@ DBG_MESSAGE("karte_t::speichern(loadsave_t *file)", "saved cities ok");
 			ls->set_progress(j);
 		}
 	}
+	file->start_segment( 0 );
 DBG_MESSAGE("karte_t::speichern(loadsave_t *file)", "saved tiles");
 
 	if(  file->get_version()<=102001  ) {
@@ -5184,7 +5493,7 @@ void karte_t::add_missing_paks( const char *name, missing_level_t level )
 
 // LOAD, not save
 // just the preliminaries, opens the file, checks the versions ...
-bool karte_t::load(const char *filename)
+bool karte_t::load(const char *filename, const memory_file_t *mem)
 {
 	cbuffer_t name;
 	bool ok = false;
@@ -5258,7 +5567,7 @@ bool karte_t::load(const char *filename)
 		name.append(filename);
 	}
 
-	if(!file.rd_open(name)) {
+	if(  mem ? !file.rd_open(mem) : !file.rd_open(name)  ) {
 
 		if(  (sint32)file.get_version()==-1  ||  file.get_version()>loadsave_t::int_version(SAVEGAME_VER_NR, NULL, NULL).version  ) {
 			dbg->warning("karte_t::laden()", translator::translate("WRONGSAVE") );
@@ -7182,7 +7491,20 @@ bool karte_t::interactive(uint32 quit_month)
 					const int offset = server_checklist.print(buf, "server");
 					LCHKLST(server_sync_step).print(buf + offset, "client");
 					dbg->warning("karte_t::interactive", "sync_step=%u  %s", server_sync_step, buf);
-					if( LCHKLST(server_sync_step)!=server_checklist  ) {
+					if(  nwc_world_hash_t::is_timed_out(this)  ) {
+						dbg->warning("karte_t::interactive", "disconnecting, no world hashes from the server in time" );
+						printf("Desync due to checklist mismatch\nsync_step=%u  %s", server_sync_step, buf);
+						network_disconnect();
+					}
+					else if(  LCHKLST(server_sync_step)!=server_checklist  &&  nwc_world_hash_t::is_pending(this)  ) {
+						// still looking for the objects of the last mismatch
+					}
+					else if(  LCHKLST(server_sync_step)!=server_checklist  &&  LCHKLST(server_sync_step).world_hash!=server_checklist.world_hash  &&  nwc_world_hash_t::find_difference(this, nwcheck)  ) {
+						// disconnects when the server has sent the hashes of the differing objects
+						dbg->warning("karte_t::interactive", "checklist mismatch, comparing world hashes" );
+						printf("Desync due to checklist mismatch\nsync_step=%u  %s", server_sync_step, buf);
+					}
+					else if( LCHKLST(server_sync_step)!=server_checklist  ) {
 						dbg->warning("karte_t::interactive", "disconnecting due to checklist mismatch" );
 						printf("Desync due to checklist mismatch\nsync_step=%u  %s", server_sync_step, buf);
 						network_disconnect();
@@ -7203,6 +7525,7 @@ bool karte_t::interactive(uint32 quit_month)
 							LCHKLST(nwt->last_sync_step).print(buf + offset, "executor");
 							dbg->warning("karte_t::interactive", "skipping command due to checklist mismatch : sync_step=%u %s", nwt->last_sync_step, buf);
 							if(  !umgebung_t::server  ) {
+								// a skipped tool cannot be resynced, so do not wait for the world hashes
 								network_disconnect();
 								printf("Desync due to checklist mismatch\nsync_step=%u  %s", nwt->last_sync_step, buf);
 							}
@@ -7269,7 +7592,11 @@ bool karte_t::interactive(uint32 quit_month)
 						network_frame_count = 0;
 					}
 					sync_steps = steps * settings.get_frames_per_step() + network_frame_count;
-					LCHKLST(sync_steps) = checklist_t(get_random_seed(), halthandle_t::get_next_check(), linehandle_t::get_next_check(), convoihandle_t::get_next_check(), industry_density_proportion, actual_industry_density,finance_history_year[0][WORLD_CITYCARS] );
+					uint32 root = 0;
+					if(  umgebung_t::networkmode  &&  world_hash.step( this, sync_steps )  ) {
+						root = world_hash.get_root();
+					}
+					LCHKLST(sync_steps) = checklist_t(get_random_seed(), halthandle_t::get_next_check(), linehandle_t::get_next_check(), convoihandle_t::get_next_check(), industry_density_proportion, actual_industry_density,finance_history_year[0][WORLD_CITYCARS], root );
 
 #ifdef DEBUG_SIMRAND_CALLS
 					char buf[256];
@@ -7281,8 +7608,8 @@ bool karte_t::interactive(uint32 quit_month)
 					if(  umgebung_t::networkmode  &&  umgebung_t::server  ) {
 						// broadcast sync info
 						if (  (network_frame_count==0  &&  (sint64)dr_time()-(sint64)next_step_time>fix_ratio_frame_time*2)
-								||  (sync_steps % umgebung_t::server_sync_steps_between_checks)==0  ) {
-							nwc_check_t* nwc = new nwc_check_t(sync_steps + 1, map_counter, LCHKLST(sync_steps), sync_steps);
+								||  (sync_steps % umgebung_t::server_sync_steps_between_checks)==0  ||  root!=0  ) {
+							nwc_check_t* nwc = new nwc_check_t(sync_steps + 1, map_counter, LCHKLST(sync_steps), sync_steps, world_hash);
 							network_send_all(nwc, true);
 						}
 					}
@@ -30,6 +30,7 @@
 #include "dataobj/einstellungen.h"
 #include "dataobj/pwd_hash.h"
 #include "dataobj/loadsave.h"
+#include "dataobj/world_hash.h"
 
 #include "simplan.h"
 
@@ -74,14 +75,15 @@ struct checklist_t
 	uint32 industry_density_proportion;
 	uint32 actual_industry_density;
 	uint32 traffic;
+	uint32 world_hash;	// root of world_hash_t, 0 at the sync steps without hashing (not compared then)
 
-	checklist_t() : random_seed(0), halt_entry(0), line_entry(0), convoy_entry(0), industry_density_proportion(0), actual_industry_density(0), traffic(0) { }
-	checklist_t(uint32 _random_seed, uint16 _halt_entry, uint16 _line_entry, uint16 _convoy_entry, uint32 _industry_denisty_proportion, uint32 _actual_industry_density, uint32 _traffic)
-		: random_seed(_random_seed), halt_entry(_halt_entry), line_entry(_line_entry), convoy_entry(_convoy_entry), industry_density_proportion(_industry_denisty_proportion), actual_industry_density(_actual_industry_density), traffic(_traffic) { }
+	checklist_t() : random_seed(0), halt_entry(0), line_entry(0), convoy_entry(0), industry_density_proportion(0), actual_industry_density(0), traffic(0), world_hash(0) { }
+	checklist_t(uint32 _random_seed, uint16 _halt_entry, uint16 _line_entry, uint16 _convoy_entry, uint32 _industry_denisty_proportion, uint32 _actual_industry_density, uint32 _traffic, uint32 _world_hash)
+		: random_seed(_random_seed), halt_entry(_halt_entry), line_entry(_line_entry), convoy_entry(_convoy_entry), industry_density_proportion(_industry_denisty_proportion), actual_industry_density(_actual_industry_density), traffic(_traffic), world_hash(_world_hash) { }
 
 	bool operator == (const checklist_t &other) const
 	{
-		return ( random_seed==other.random_seed && halt_entry==other.halt_entry && line_entry==other.line_entry && convoy_entry==other.convoy_entry && industry_density_proportion == other.industry_density_proportion && actual_industry_density == other.actual_industry_density);
+		return ( random_seed==other.random_seed && halt_entry==other.halt_entry && line_entry==other.line_entry && convoy_entry==other.convoy_entry && industry_density_proportion == other.industry_density_proportion && actual_industry_density == other.actual_industry_density && (world_hash == other.world_hash || world_hash == 0 || other.world_hash == 0));
 	}
 	bool operator != (const checklist_t &other) const { return !( (*this)==other ); }
 
@@ -274,6 +276,11 @@ private:
 	bool nosave;
 	bool nosave_warning;
 
+	/**
+	 * The last full autosave, which delta autosaves refer to.
+	 */
+	savegame_segments_t autosave_base;
+
 	/*
 	 * The current convoi to follow.
 	 * @author prissi
@@ -652,6 +659,8 @@ private:
 	/// @note variable used in interactive()
 	checklist_t last_checklists[LAST_CHECKLISTS_COUNT];
 #define LCHKLST(x) (last_checklists[(x) % LAST_CHECKLISTS_COUNT])
+	/// @note variable used in interactive()
+	world_hash_t world_hash;
 	/// @note variable used in interactive()
 	uint8  network_frame_count;
 	/**
@@ -799,6 +808,11 @@ private:
 	 */
 	void save(loadsave_t *file,bool silent);
 
+	/**
+	 * Autosave, with only the changed tiles when delta autosaves are enabled.
+	 */
+	void autosave(const char *filename);
+
 	/**
 	 * Internal loading method.
 	 * @author Hj. Malthaner
@@ -866,6 +880,32 @@ private:
 	void world_xy_loop(xy_loop_func func, bool sync_x_steps);
 	static void *world_xy_loop_thread(void *);
 
+	/**
+	 * Does the route searches the convoys will need in this step in advance,
+	 * on all threads if MULTI_THREAD is set. The searches only read the world
+	 * and the convoys take their routes when stepped in convoi_array order,
+	 * so the result does not depend on the number of threads.
+	 */
+	void calc_convoi_routes();
+	static void calc_convoi_routes_part(void *, int);
+
+	/**
+	 * Plans the passenger trips of all cities due in this step, on all threads
+	 * if MULTI_THREAD is set. Each city draws from its own random stream and
+	 * the trips are booked afterwards in city order, so again the result does
+	 * not depend on the number of threads.
+	 */
+	void plan_passenger_trips();
+	static void plan_passenger_trips_part(void *, int);
+
+	/**
+	 * Does the production of all factories (fabrik_t::step_production), on all
+	 * threads if MULTI_THREAD is set. The factories distribute their goods
+	 * afterwards in fab_list order.
+	 */
+	void step_factory_production(long delta_t);
+	static void step_factory_production_part(void *, int);
+
 	/**
 	 * Loops over plans after load.
 	 */
@@ -1966,16 +2006,26 @@ public:
 	/**
 	 * Saves the map to a file.
 	 * @param Filename name of the file to write.
+	 * @param base, written see loadsave_t::set_segments()
+	 * @return false on error
 	 * @author Hj. Malthaner
 	 */
-	void save(const char *filename, const loadsave_t::mode_t savemode, const char *version, const char *ex_version, bool silent);
+	bool save(const char *filename, const loadsave_t::mode_t savemode, const char *version, const char *ex_version, bool silent, const savegame_segments_t *base = NULL, savegame_segments_t *written = NULL);
+
+	/**
+	 * Saves the map into memory (zipped_blocks), e.g. for the transfer to network clients.
+	 * @return false on error
+	 */
+	bool save(memory_file_t *mem, const char *version, const char *ex_version);
 
 	/**
 	 * Loads a map from a file.
 	 * @param Filename name of the file to read.
+	 * @param mem if not NULL, the savegame is read from there instead; filename
+	 *        still decides about a network resync
 	 * @author Hj. Malthaner
 	 */
-	bool load(const char *filename);
+	bool load(const char *filename, const memory_file_t *mem = NULL);
 
 	/**
 	 * Creates a map from a heightfield.
@@ -2010,6 +2060,7 @@ public:
 	void set_checklist_at(const uint32 sync_step, const checklist_t &chklst) { LCHKLST(sync_step) = chklst; }
 
 	const checklist_t& get_last_checklist() const { return LCHKLST(sync_steps); }
+	const world_hash_t& get_world_hash() const { return world_hash; }
 	uint32 get_last_checklist_sync_step() const { return sync_steps; }
 
 	void command_queue_append(network_world_command_t*) const;
@@ -0,0 +1,140 @@
+/**
+ * This file is part of the Simutrans project under the artistic license.
+ * (see license.txt)
+ *
+ * Unit test for simgraph16_kernels.h: the SSE2 and AVX2 routines must give
+ * exactly the same pixels as the plain C routines for random runs.
+ * Do NOT link this into simutrans!  This is a unit test!
+ *
+ * Build e.g. with: g++ -O2 -DCOLOUR_DEPTH=16 -o test_kernels test_simgraph16_kernels.cc simgraph16_kernels.cc
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simgraph16_kernels.h"
+#include "simgraph.h"
+
+#define RGBMAP_SIZE (0x8000+256)
+#define MAX_RUN (300)
+#define RUNS (2000)
+
+static PIXVAL rgbmap[RGBMAP_SIZE+1];
+static PIXVAL src[MAX_RUN+32];
+static PIXVAL alphamap[MAX_RUN+32];
+static PIXVAL dest[MAX_RUN+32];
+static PIXVAL expected[MAX_RUN+32];
+static PIXVAL result[MAX_RUN+32];
+
+static int errors = 0;
+
+static PIXVAL random_pixel()
+{
+	return (PIXVAL)(rand() ^ (rand() << 8));
+}
+
+
+static void check(const char *name, simd_level_t level, bool rgb555, PIXVAL len)
+{
+	if(  memcmp( expected, result, sizeof(expected) ) != 0  ) {
+		for(  int i = 0;  i < MAX_RUN+32;  i++  ) {
+			if(  expected[i] != result[i]  ) {
+				fprintf(stderr, "%s %s %s: pixel %d of %u is %04x, expected %04x\n", get_simd_level_name(level), name, rgb555 ? "555" : "565", i, len, result[i], expected[i]);
+				break;
+			}
+		}
+		errors ++;
+	}
+}
+
+
+static void test_level(simd_level_t level, bool rgb555)
+{
+	pixel_kernels_t plain, k;
+	get_pixel_kernels(SIMD_NONE, rgb555, plain);
+	if(  !get_pixel_kernels(level, rgb555, k)  ) {
+		fprintf(stdout, "%s not available\n", get_simd_level_name(level));
+		return;
+	}
+	static const char *const quarters[3] = { "25", "50", "75" };
+	char name[64];
+
+	for(  int run = 0;  run < RUNS;  run++  ) {
+		// random length and position, so all ends and alignments are used
+		const PIXVAL len = rand() % MAX_RUN;
+		const int offset = rand() % 16;
+		const PIXVAL colour = random_pixel();
+		const unsigned alpha_flags = rand() & (ALPHA_RED | ALPHA_GREEN | ALPHA_BLUE);
+		for(  int i = 0;  i < MAX_RUN+32;  i++  ) {
+			src[i] = rand() % RGBMAP_SIZE;
+			dest[i] = random_pixel();
+			// mostly the extreme values, as in real alpha maps
+			const int a = rand() % 4;
+			alphamap[i] = a == 0 ? 0 : (a == 1 ? 0x7fff : random_pixel() & 0x7fff);
+		}
+
+		for(  int q = 0;  q < 3;  q++  ) {
+			sprintf(name, "blend%s", quarters[q]);
+			memcpy(expected, dest, sizeof(dest));
+			memcpy(result, dest, sizeof(dest));
+			plain.blend[q](expected + offset, src + offset, rgbmap, colour, len);
+			k.blend[q](result + offset, src + offset, rgbmap, colour, len);
+			check(name, level, rgb555, len);
+
+			sprintf(name, "blend_recode%s", quarters[q]);
+			memcpy(expected, dest, sizeof(dest));
+			memcpy(result, dest, sizeof(dest));
+			plain.blend_recode[q](expected + offset, src + offset, rgbmap, colour, len);
+			k.blend_recode[q](result + offset, src + offset, rgbmap, colour, len);
+			check(name, level, rgb555, len);
+
+			sprintf(name, "outline%s", quarters[q]);
+			memcpy(expected, dest, sizeof(dest));
+			memcpy(result, dest, sizeof(dest));
+			plain.outline[q](expected + offset, NULL, rgbmap, colour, len);
+			k.outline[q](result + offset, NULL, rgbmap, colour, len);
+			check(name, level, rgb555, len);
+		}
+
+		memcpy(expected, dest, sizeof(dest));
+		memcpy(result, dest, sizeof(dest));
+		plain.alpha(expected + offset, src + offset, alphamap + offset, rgbmap, alpha_flags, colour, len);
+		k.alpha(result + offset, src + offset, alphamap + offset, rgbmap, alpha_flags, colour, len);
+		check("alpha", level, rgb555, len);
+
+		memcpy(expected, dest, sizeof(dest));
+		memcpy(result, dest, sizeof(dest));
+		plain.alpha_recode(expected + offset, src + offset, alphamap + offset, rgbmap, alpha_flags, colour, len);
+		k.alpha_recode(result + offset, src + offset, alphamap + offset, rgbmap, alpha_flags, colour, len);
+		check("alpha_recode", level, rgb555, len);
+
+		memcpy(expected, dest, sizeof(dest));
+		memcpy(result, dest, sizeof(dest));
+		plain.colorcopy(expected + offset, src + offset, rgbmap, len);
+		k.colorcopy(result + offset, src + offset, rgbmap, len);
+		check("colorcopy", level, rgb555, len);
+	}
+	fprintf(stdout, "%s %s tested\n", get_simd_level_name(level), rgb555 ? "555" : "565");
+}
+
+
+int main(int argc, char** argv)
+{
+	srand(42);
+	for(  int i = 0;  i < RGBMAP_SIZE+1;  i++  ) {
+		rgbmap[i] = random_pixel();
+	}
+
+	const simd_level_t cpu_level = get_cpu_simd_level();
+	fprintf(stdout, "CPU supports %s\n", get_simd_level_name(cpu_level));
+	for(  int level = SIMD_SSE2;  level <= cpu_level;  level++  ) {
+		test_level((simd_level_t)level, true);
+		test_level((simd_level_t)level, false);
+	}
+
+	if(  errors  ) {
+		fprintf(stderr, "%d kernels differ from the plain routines\n", errors);
+		return 1;
+	}
+	fprintf(stdout, "all kernels are pixel exact\n");
+	return 0;
+}
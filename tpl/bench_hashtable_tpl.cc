@@ -0,0 +1,145 @@
+/**
+ * This file is part of the Simutrans project under the artistic license.
+ * (see license.txt)
+ *
+ * Micro benchmark for hashtable_tpl.h: insert, lookup, iterate and erase
+ * with integer, koord and string keys at the sizes found in games.
+ * Do NOT link this into simutrans!  This is a benchmark!
+ *
+ * Build e.g. with: g++ -O2 -o bench_hashtable tpl/bench_hashtable_tpl.cc
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../simtypes.h"
+#include "inthashtable_tpl.h"
+#include "koordhashtable_tpl.h"
+#include "stringhashtable_tpl.h"
+
+// This is a hack, but it's worth it.  The templates need logging and the freelist in order to link.
+#include "../simdebug.cc"
+#include "../utils/dumb-log.cc"
+#include "../simmem.cc"
+#include "../dataobj/freelist.cc"
+
+#define ROUNDS (8)
+
+static clock_t timer;
+
+static void start_timer()
+{
+	timer = clock();
+}
+
+static void stop_timer(const char *what, uint32 size, uint32 operations)
+{
+	const double secs = (double)(clock() - timer) / CLOCKS_PER_SEC;
+	fprintf(stdout, "%-10s %7u entries: %8.1f ns/op\n", what, size, secs * 1e9 / operations);
+}
+
+
+// runs the benchmark for the table type T, with keys[] holding size different keys
+template<class T, class key_t> void bench(const char *name, const key_t *keys, const uint32 size)
+{
+	fprintf(stdout, "%s\n", name);
+	T table;
+	uint32 sum = 0;
+
+	start_timer();
+	for(  int r = 0;  r < ROUNDS;  r++  ) {
+		table.clear();
+		for(  uint32 i = 0;  i < size;  i++  ) {
+			table.put(keys[i], i);
+		}
+	}
+	stop_timer("insert", size, ROUNDS * size);
+	if(  table.get_count() != size  ) {
+		fprintf(stderr, "wrong count %u after insert, expected %u\n", table.get_count(), size);
+		exit(1);
+	}
+
+	start_timer();
+	for(  int r = 0;  r < ROUNDS;  r++  ) {
+		for(  uint32 i = 0;  i < size;  i++  ) {
+			sum += table.get(keys[i]);
+		}
+	}
+	stop_timer("lookup", size, ROUNDS * size);
+	if(  sum != ROUNDS * (uint32)(((uint64)size * (size - 1)) / 2)  ) {
+		fprintf(stderr, "wrong values found\n");
+		exit(1);
+	}
+
+	// keys not contained
+	start_timer();
+	for(  int r = 0;  r < ROUNDS;  r++  ) {
+		for(  uint32 i = 0;  i < size;  i++  ) {
+			sum += table.is_contained(keys[size + i]);
+		}
+	}
+	stop_timer("miss", size, ROUNDS * size);
+
+	start_timer();
+	uint32 visited = 0;
+	T const& const_table = table;
+	for(  int r = 0;  r < ROUNDS;  r++  ) {
+		for(  typename T::const_iterator i = const_table.begin(), end = const_table.end();  i != end;  ++i  ) {
+			sum += i->value;
+			visited ++;
+		}
+	}
+	stop_timer("iterate", size, ROUNDS * size);
+	if(  visited != ROUNDS * size  ) {
+		fprintf(stderr, "wrong number of entries iterated\n");
+		exit(1);
+	}
+
+	start_timer();
+	for(  uint32 i = 0;  i < size;  i += 2  ) {
+		table.remove(keys[i]);
+	}
+	for(  typename T::iterator i = table.begin();  i != table.end();  ) {
+		i = table.erase(i);
+	}
+	stop_timer("erase", size, size);
+	if(  !table.empty()  ) {
+		fprintf(stderr, "table not empty after erase\n");
+		exit(1);
+	}
+	fprintf(stdout, "\n");
+}
+
+
+int main(int argc, char** argv)
+{
+	static const uint32 sizes[] = { 16, 128, 1024, 16384, 131072 };
+	const uint32 max_size = sizes[lengthof(sizes) - 1];
+	srand(42);
+
+	// twice as many keys as entries: the second half is for the lookups that fail
+	uint32 *int_keys = new uint32[max_size * 2];
+	for(  uint32 i = 0;  i < max_size * 2;  i++  ) {
+		int_keys[i] = i * 7 + (rand() & 7) * max_size * 16;
+	}
+
+	koord *koord_keys = new koord[max_size * 2];
+	for(  uint32 i = 0;  i < max_size * 2;  i++  ) {
+		// like tiles of a 1024x1024 map
+		koord_keys[i] = koord( (sint16)(i % 1024), (sint16)(i / 1024) );
+	}
+
+	char **string_keys = new char *[max_size * 2];
+	for(  uint32 i = 0;  i < max_size * 2;  i++  ) {
+		string_keys[i] = new char[16];
+		sprintf(string_keys[i], "obj_%u", i);
+	}
+
+	for(  uint32 s = 0;  s < lengthof(sizes);  s++  ) {
+		const uint32 size = sizes[s];
+		fprintf(stdout, "=== %u entries ===\n", size);
+		bench< inthashtable_tpl<uint32, uint32> >("inthashtable_tpl", int_keys, size);
+		bench< koordhashtable_tpl<koord, uint32> >("koordhashtable_tpl", koord_keys, size);
+		bench< stringhashtable_tpl<uint32> >("stringhashtable_tpl", (const char **)string_keys, size);
+	}
+	return 0;
+}
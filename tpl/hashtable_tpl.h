@@ -1,17 +1,33 @@
 #ifndef tpl_hashtable_tpl_h
 #define tpl_hashtable_tpl_h
 
-#include "slist_tpl.h"
+#include <iterator>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h> // for ptrdiff_t
+#include "../dataobj/freelist.h"
+#include "../simdebug.h"
+#include "../simtypes.h"
 #include "../macros.h"
 
-#define STHT_BAGSIZE 101
-#define STHT_BAG_COUNTER_T uint8
+// smallest table: 1<<STHT_MIN_HOME_BITS home slots
+#define STHT_MIN_HOME_BITS (3)
 
 
 /*
  * Generic hashtable, which maps key_t to value_t. key_t depended functions
  * like the hash generation is implemented by the third template parameter
  * hash_t (see ifc/hash_tpl.h)
+ *
+ * The table uses open addressing with linear probing: every key has a home
+ * slot given by the top bits of its (mixed) hash and is stored there or in
+ * the next free slot behind it. The used slots are kept sorted by hash and
+ * key, and probing never wraps around (there are some spare slots at the end
+ * instead). Hence the iteration order depends only on the contained keys, not
+ * on the order of insertion or on the size of the table.
+ * The table grows when it is three quarters full and never shrinks. The
+ * nodes themselves are never moved, so a pointer from access() stays valid
+ * until its entry is removed. Iterators become invalid when entries are added.
  */
 template<class key_t, class value_t, class hash_t>
 class hashtable_tpl
@@ -23,10 +39,19 @@ protected:
 		value_t	value;
 
 		int operator == (const node_t &x) const { return key == x.key; }
+
+		void* operator new(size_t) { return freelist_t::gimme_node(sizeof(node_t)); }
+		void operator delete(void* p) { freelist_t::putback_node(sizeof(node_t), p); }
+	};
+
+	struct slot_t {
+		uint32 hash_value;
+		node_t *node;	// NULL for an unused slot
 	};
 
-	// the entires in the lists are sorted according to their keys
-	slist_tpl <node_t> bags[STHT_BAGSIZE];
+	slot_t *slots;
+	uint32 slot_count;	// home slots plus spare slots
+	uint8 home_bits;
 	uint32 count;
 
 /*
@@ -36,13 +61,137 @@ private:
 	hashtable_tpl(const hashtable_tpl&);
 	hashtable_tpl& operator=( hashtable_tpl const&);
 
-public:
-	hashtable_tpl() { count = 0; }
+	// Fibonacci hashing, so that the top bits depend on all bits of the hash
+	static uint32 get_hash(const key_t key)
+	{
+		return (uint32)hash_t::hash(key) * 0x9E3779B1u;
+	}
+
+	uint32 get_home(const uint32 hash) const
+	{
+		return hash >> (32 - home_bits);
+	}
+
+	static uint32 get_slot_count(const uint8 bits)
+	{
+		return (1u << bits) + (1u << bits) / 8 + 8;
+	}
+
+	/*
+	 * Returns the slot which holds key or where it has to be inserted.
+	 * comp() is not an ordering for all key types, so all keys with the
+	 * same hash are checked for equality.
+	 */
+	uint32 find_slot(const key_t key, const uint32 hash, bool &found) const
+	{
+		found = false;
+		if(  slots == NULL  ) {
+			return 0;
+		}
+		uint32 i = get_home(hash);
+		while(  i < slot_count  &&  slots[i].node  &&  slots[i].hash_value < hash  ) {
+			i++;
+		}
+		uint32 insert_pos = slot_count;
+		for(  ;  i < slot_count  &&  slots[i].node  &&  slots[i].hash_value == hash;  i++  ) {
+			const long diff = (long)hash_t::comp(slots[i].node->key, key);
+			if(  diff == 0  ) {
+				found = true;
+				return i;
+			}
+			if(  diff > 0  &&  insert_pos == slot_count  ) {
+				insert_pos = i;
+			}
+		}
+		return insert_pos < slot_count ? insert_pos : i;
+	}
+
+	node_t *find_node(const key_t key) const
+	{
+		bool found;
+		const uint32 i = find_slot(key, get_hash(key), found);
+		return found ? slots[i].node : NULL;
+	}
+
+	// rebuilds the table with 1<<bits home slots (or more, if the entries do not fit)
+	void resize(uint8 bits)
+	{
+		slot_t *const old_slots = slots;
+		const uint32 old_slot_count = slot_count;
+		for(  ;;  bits++  ) {
+			slot_count = get_slot_count(bits);
+			home_bits = bits;
+			slots = new slot_t[slot_count];
+			memset( slots, 0, sizeof(slot_t) * slot_count );
+			// the old slots are sorted, so every entry goes behind the previous one
+			uint32 next = 0;
+			bool fits = true;
+			for(  uint32 i = 0;  i < old_slot_count;  i++  ) {
+				if(  old_slots[i].node  ) {
+					const uint32 home = get_home(old_slots[i].hash_value);
+					const uint32 pos = home > next ? home : next;
+					if(  pos >= slot_count  ) {
+						fits = false;
+						break;
+					}
+					slots[pos] = old_slots[i];
+					next = pos + 1;
+				}
+			}
+			if(  fits  ) {
+				break;
+			}
+			delete [] slots;
+		}
+		delete [] old_slots;
+	}
+
+	// inserts a new node for key, which must not be contained
+	node_t *insert_node(const key_t key)
+	{
+		const uint32 hash = get_hash(key);
+		if(  slots == NULL  ||  (count + 1) * 4 > (3u << home_bits)  ) {
+			resize( slots == NULL ? STHT_MIN_HOME_BITS : home_bits + 1 );
+		}
+		for(  ;;  ) {
+			bool found;
+			const uint32 pos = find_slot(key, hash, found);
+			uint32 free_pos = pos;
+			while(  free_pos < slot_count  &&  slots[free_pos].node  ) {
+				free_pos++;
+			}
+			if(  free_pos < slot_count  ) {
+				memmove( slots + pos + 1, slots + pos, sizeof(slot_t) * (free_pos - pos) );
+				slots[pos].hash_value = hash;
+				slots[pos].node = new node_t();
+				slots[pos].node->key = key;
+				count ++;
+				return slots[pos].node;
+			}
+			// ran into the end of the table
+			resize( home_bits + 1 );
+		}
+	}
+
+	// removes the entry in slot i; the following entries move up where possible
+	void remove_slot(uint32 i)
+	{
+		delete slots[i].node;
+		while(  i + 1 < slot_count  &&  slots[i + 1].node  &&  get_home(slots[i + 1].hash_value) <= i  ) {
+			slots[i] = slots[i + 1];
+			i++;
+		}
+		slots[i].node = NULL;
+		count --;
+	}
 
 public:
-	STHT_BAG_COUNTER_T get_hash(const key_t key) const
+	hashtable_tpl() : slots(NULL), slot_count(0), home_bits(0), count(0) {}
+
+	~hashtable_tpl()
 	{
-		return (STHT_BAG_COUNTER_T)(hash_t::hash(key) % STHT_BAGSIZE);
+		clear();
+		delete [] slots;
 	}
 
 	class iterator
@@ -55,41 +204,29 @@ public:
 			typedef node_t*                   pointer;
 			typedef node_t&                   reference;
 
-			iterator() : bag_i(), bag_end(), node_i() {}
+			iterator() : slot_i(), slot_end() {}
 
-			iterator(slist_tpl<node_t>* const bag_i,  slist_tpl<node_t>* const bag_end, typename slist_tpl<node_t>::iterator const& node_i) :
-				bag_i(bag_i),
-				bag_end(bag_end),
-				node_i(node_i)
+			iterator(slot_t* const slot_i, slot_t* const slot_end) :
+				slot_i(slot_i),
+				slot_end(slot_end)
 			{}
 
-			pointer   operator ->() const { return &*node_i; }
-			reference operator *()  const { return  *node_i; }
+			pointer   operator ->() const { return  slot_i->node; }
+			reference operator *()  const { return *slot_i->node; }
 
 			iterator& operator ++()
 			{
-				if (++node_i == bag_i->end()) {
-					for (;;) {
-						if (++bag_i == bag_end) {
-							node_i = typename slist_tpl<node_t>::iterator();
-							break;
-						}
-						if (!bag_i->empty()) {
-							node_i = bag_i->begin();
-							break;
-						}
-					}
+				while(  ++slot_i != slot_end  &&  !slot_i->node  ) {
 				}
 				return *this;
 			}
 
-			bool operator ==(iterator const& o) const { return bag_i == o.bag_i && node_i == o.node_i; }
+			bool operator ==(iterator const& o) const { return slot_i == o.slot_i; }
 			bool operator !=(iterator const& o) const { return !(*this == o); }
 
 		private:
-			slist_tpl<node_t>*                   bag_i;
-			slist_tpl<node_t>*                   bag_end;
-			typename slist_tpl<node_t>::iterator node_i;
+			slot_t* slot_i;
+			slot_t* slot_end;
 	};
 
 	/* Erase element at pos
@@ -97,23 +234,12 @@ public:
 	 * An iterator pointing to the successor of the erased element is returned */
 	iterator erase(iterator old)
 	{
+		remove_slot( old.slot_i - slots );
+		// the successor moved up into this slot, or it is behind it
 		iterator pos(old);
-		pos.bag_end = old.bag_end;
-		pos.bag_i = old.bag_i;
-		pos.node_i = old.bag_i->erase( old.node_i );
-		if(  pos.node_i ==  pos.bag_i->end()  ) {
-			for (;;) {
-				if (++pos.bag_i == pos.bag_end) {
-					pos.node_i = typename slist_tpl<node_t>::iterator();
-					break;
-				}
-				if (!pos.bag_i->empty()) {
-					pos.node_i = pos.bag_i->begin();
-					break;
-				}
-			}
+		if(  !pos.slot_i->node  ) {
+			++pos;
 		}
-		count --;
 		return pos;
 	}
 
@@ -126,48 +252,36 @@ public:
 			typedef node_t const*             pointer;
 			typedef node_t const&             reference;
 
-			const_iterator() : bag_i(), bag_end(), node_i() {}
+			const_iterator() : slot_i(), slot_end() {}
 
-			const_iterator(slist_tpl<node_t> const* const bag_i,  slist_tpl<node_t> const* const bag_end, typename slist_tpl<node_t>::const_iterator const& node_i) :
-				bag_i(bag_i),
-				bag_end(bag_end),
-				node_i(node_i)
+			const_iterator(slot_t const* const slot_i, slot_t const* const slot_end) :
+				slot_i(slot_i),
+				slot_end(slot_end)
 			{}
 
-			pointer   operator ->() const { return &*node_i; }
-			reference operator *()  const { return  *node_i; }
+			pointer   operator ->() const { return  slot_i->node; }
+			reference operator *()  const { return *slot_i->node; }
 
 			const_iterator& operator ++()
 			{
-				if (++node_i == bag_i->end()) {
-					for (;;) {
-						if (++bag_i == bag_end) {
-							node_i = typename slist_tpl<node_t>::const_iterator();
-							break;
-						}
-						if (!bag_i->empty()) {
-							node_i = bag_i->begin();
-							break;
-						}
-					}
+				while(  ++slot_i != slot_end  &&  !slot_i->node  ) {
 				}
 				return *this;
 			}
 
-			bool operator ==(const_iterator const& o) const { return bag_i == o.bag_i && node_i == o.node_i; }
+			bool operator ==(const_iterator const& o) const { return slot_i == o.slot_i; }
 			bool operator !=(const_iterator const& o) const { return !(*this == o); }
 
 		private:
-			slist_tpl<node_t> const*                   bag_i;
-			slist_tpl<node_t> const*                   bag_end;
-			typename slist_tpl<node_t>::const_iterator node_i;
+			slot_t const* slot_i;
+			slot_t const* slot_end;
 	};
 
 	iterator begin()
 	{
-		for (slist_tpl<node_t>* i = bags; i != endof(bags); ++i) {
-			if (!i->empty()) {
-				return iterator(i, endof(bags), i->begin());
+		for(  uint32 i = 0;  i < slot_count;  i++  ) {
+			if(  slots[i].node  ) {
+				return iterator(slots + i, slots + slot_count);
 			}
 		}
 		return end();
@@ -175,14 +289,14 @@ public:
 
 	iterator end()
 	{
-		return iterator(endof(bags), endof(bags), typename slist_tpl<node_t>::iterator());
+		return iterator(slots + slot_count, slots + slot_count);
 	}
 
 	const_iterator begin() const
 	{
-		for (slist_tpl<node_t> const* i = bags; i != endof(bags); ++i) {
-			if (!i->empty()) {
-				return const_iterator(i, endof(bags), i->begin());
+		for(  uint32 i = 0;  i < slot_count;  i++  ) {
+			if(  slots[i].node  ) {
+				return const_iterator(slots + i, slots + slot_count);
 			}
 		}
 		return end();
@@ -190,51 +304,31 @@ public:
 
 	const_iterator end() const
 	{
-		return const_iterator(endof(bags), endof(bags), typename slist_tpl<node_t>::iterator());
+		return const_iterator(slots + slot_count, slots + slot_count);
 	}
 
+	// like vector_tpl, this keeps the allocated slots for refilling
 	void clear()
 	{
-		for(STHT_BAG_COUNTER_T i=0; i<STHT_BAGSIZE; i++) {
-			bags[i].clear();
+		for(  uint32 i = 0;  i < slot_count;  i++  ) {
+			delete slots[i].node;
+			slots[i].node = NULL;
 		}
 		count = 0;
 	}
 
-	// the elements are inserted with increasing key
-	// => faster retrivial (we only have to check half of the lists)
 	const value_t &get(const key_t key) const
 	{
 		static value_t nix;
-		FORT(slist_tpl<node_t>, const& node, bags[get_hash(key)]) {
-			const int diff = hash_t::comp(node.key, key);
-			if(  diff == 0  ) {
-				return node.value;
-			}
-			if(  diff > 0  ) {
-				// not contained
-				break;
-			}
-		}
-		return nix;
+		const node_t *const node = find_node(key);
+		return node ? node->value : nix;
 	}
 
-	// the elements are inserted with increasing key
-	// => faster retrivial, but never ever change a key later!!!
+	// never ever change a key later!!!
 	value_t *access(const key_t key)
 	{
-		slist_tpl<node_t>& bag = bags[get_hash(key)];
-		FORT(slist_tpl<node_t>, & node, bag) {
-			const int diff = hash_t::comp(node.key, key);
-			if(  diff == 0  ) {
-				return &node.value;
-			}
-			if(  diff > 0  ) {
-				// not contained
-				break;
-			}
-		}
-		return NULL;
+		node_t *const node = find_node(key);
+		return node ? &node->value : NULL;
 	}
 
 	//
@@ -243,32 +337,13 @@ public:
 	//
 	bool put(const key_t key, value_t object)
 	{
-		slist_tpl<node_t>& bag = bags[get_hash(key)];
-
 		/* Duplicate values are hard to debug, so better check here.
-		 * we also enter it sorted, saving lookout time for large lists ...
 		 */
-		for(  typename slist_tpl<node_t>::iterator iter = bag.begin(), end = bag.end();  iter != end;  ++iter  ) {
-			const int diff = hash_t::comp(iter->key, key);
-			if(  diff>0  ) {
-				node_t n;
-				n.key   = key;
-				n.value = object;
-				bag.insert( iter, n );
-				count ++;
-				return true;
-			}
-			if(  diff == 0  ) {
-				dbg->message( "hashtable_tpl::put", "Duplicate hash!" );
-				return false;
-			}
+		if(  find_node(key)  ) {
+			dbg->message( "hashtable_tpl::put", "Duplicate hash!" );
+			return false;
 		}
-		// here only for empty lists or everything was smaller
-		node_t n;
-		n.key = key;
-		n.value = object;
-		bag.append( n );
-		count ++;
+		insert_node(key)->value = object;
 		return true;
 	}
 
@@ -279,18 +354,7 @@ public:
 	//
 	bool is_contained(const key_t key) const
 	{
-		const slist_tpl<node_t>& bag = bags[get_hash(key)];
-		FORT(slist_tpl<node_t>, const& node, bag) {
-			const int diff = hash_t::comp(node.key, key);
-			if(  diff == 0  ) {
-				return true;
-			}
-			if(  diff > 0  ) {
-				// not contained
-				break;
-			}
-		}
-		return false;
+		return find_node(key) != NULL;
 	}
 
 	// Inserts a new instantiated value - failure, if key exists in table
@@ -298,28 +362,11 @@ public:
 	//
 	bool put(const key_t key)
 	{
-		slist_tpl<node_t>& bag = bags[get_hash(key)];
-
-		/* Duplicate values are hard to debug, so better check here.
-		 * we also enter it sorted, saving lookout time for large lists ...
-		 */
-		for(  typename slist_tpl<node_t>::iterator iter = bag.begin(), end = bag.end();  iter != end;  ++iter  ) {
-			const int diff = hash_t::comp(iter->key, key);
-			if(  diff>0  ) {
-				iter = bag.insert( iter );
-				iter->key = key;
-				count ++;
-				return true;
-			}
-			if(  diff == 0  ) {
-				// already initialized
-				return false;
-			}
+		if(  find_node(key)  ) {
+			// already initialized
+			return false;
 		}
-		// here only for empty lists or everything was smaller
-		bag.append();
-		bag.back().key = key;
-		count ++;
+		insert_node(key);
 		return true;
 	}
 
@@ -331,29 +378,12 @@ public:
 	//
 	value_t set(const key_t key, value_t object)
 	{
-		slist_tpl<node_t>& bag = bags[get_hash(key)];
-		for(  typename slist_tpl<node_t>::iterator iter = bag.begin(), end = bag.end();  iter != end;  ++iter  ) {
-			const int diff = hash_t::comp(iter->key, key);
-			if(  diff == 0  ) {
-				value_t value = iter->value;
-				iter->value = object;
-				return value;
-			}
-			if(  diff > 0  ) {
-				node_t node;
-				node.key   = key;
-				node.value = object;
-				bag.insert( iter, node );
-				count ++;
-				return value_t();
-			}
+		if(  node_t *const node = find_node(key)  ) {
+			value_t value = node->value;
+			node->value = object;
+			return value;
 		}
-		// empty list or really last one ...
-		node_t node;
-		node.key   = key;
-		node.value = object;
-		bag.append(node);
-		count ++;
+		insert_node(key)->value = object;
 		return value_t();
 	}
 
@@ -361,29 +391,23 @@ public:
 	// otherwise the value that was associated to the key.
 	value_t remove(const key_t key)
 	{
-		slist_tpl<node_t>& bag = bags[get_hash(key)];
-		for(  typename slist_tpl<node_t>::iterator iter = bag.begin(), end = bag.end();  iter != end;  ++iter  ) {
-			const int diff = hash_t::comp(iter->key, key);
-			if(  diff == 0  ) {
-				value_t v = iter->value;
-				bag.erase(iter);
-				count --;
-				return v;
-			}
-			if(  diff > 0  ) {
-				// not in list
-				break;
-			}
+		bool found;
+		const uint32 i = find_slot(key, get_hash(key), found);
+		if(  !found  ) {
+			return value_t();
 		}
-		return value_t();
+		value_t v = slots[i].node->value;
+		remove_slot(i);
+		return v;
 	}
 
 	value_t remove_first()
 	{
-		for(STHT_BAG_COUNTER_T i = 0; i < STHT_BAGSIZE; i++) {
-			if(  !bags[i].empty()  ) {
-				count --;
-				return bags[i].remove_first().value;
+		for(  uint32 i = 0;  i < slot_count;  i++  ) {
+			if(  slots[i].node  ) {
+				value_t v = slots[i].node->value;
+				remove_slot(i);
+				return v;
 			}
 		}
 		dbg->fatal( "hashtable_tpl::remove_first()", "Hashtable already empty!" );
@@ -392,12 +416,11 @@ public:
 
 	void dump_stats()
 	{
-		for(STHT_BAG_COUNTER_T i = 0; i < STHT_BAGSIZE; i++) {
-			printf("Bag %d contains %ud elements\n", i, bags[i].get_count());
-
-			FORT(slist_tpl<node_t>, const& node, bags[i]) {
-				printf(" ");
-				hash_t::dump(node.key);
+		printf("%u entries in %u slots\n", count, slot_count);
+		for(  uint32 i = 0;  i < slot_count;  i++  ) {
+			if(  slots[i].node  ) {
+				printf("Slot %u (home %u): ", i, get_home(slots[i].hash_value));
+				hash_t::dump(slots[i].node->key);
 				printf("\n");
 			}
 		}
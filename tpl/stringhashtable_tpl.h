@@ -15,16 +15,11 @@ class stringhash_t {
 public:
 	static uint32 hash(const char *key)
 	{
+		// the hashtable uses the top bits of the hash, so every character must count
 		uint32 hash = 0;
-#if 1
-		for(  sint8 i=16;  i*key[0]!=0;  i--  ) {
-			hash += (uint8)(*key++);
-		}
-#else
 		while (*key != '\0') {
-			hash = hash * 33 + *key++;
+			hash = hash * 33 + (uint8)*key++;
 		}
-#endif
 		return hash;
 	}
 
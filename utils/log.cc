@@ -36,12 +36,29 @@
 #endif
 #endif
 
+#if MULTI_THREAD>1
+#include <pthread.h>
+
+// the parallel parts of a step may log too, so one entry is written at a time
+static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+class log_lock_t {
+public:
+	log_lock_t() { pthread_mutex_lock( &log_mutex ); }
+	~log_lock_t() { pthread_mutex_unlock( &log_mutex ); }
+};
+#define LOG_LOCK log_lock_t log_lock
+#else
+#define LOG_LOCK
+#endif
+
 /**
  * writes important messages to stdout/logfile
  * use instead of printf()
  */
 void log_t::important(const char* format, ...)
 {
+	LOG_LOCK;
 	va_list argptr;
 
 	va_start( argptr, format );
@@ -81,6 +98,7 @@ void log_t::important(const char* format, ...)
 void log_t::debug(const char *who, const char *format, ...)
 {
 	if(log_debug  &&  debuglevel==4) {
+		LOG_LOCK;
 		va_list argptr;
 		va_start(argptr, format);
 
@@ -124,6 +142,7 @@ void log_t::debug(const char *who, const char *format, ...)
 void log_t::message(const char *who, const char *format, ...)
 {
 	if(debuglevel>2) {
+		LOG_LOCK;
 		va_list argptr;
 		va_start(argptr, format);
 
@@ -167,6 +186,7 @@ void log_t::message(const char *who, const char *format, ...)
 void log_t::warning(const char *who, const char *format, ...)
 {
 	if(debuglevel>1) {
+		LOG_LOCK;
 		va_list argptr;
 		va_start(argptr, format);
 
@@ -210,6 +230,7 @@ void log_t::warning(const char *who, const char *format, ...)
 void log_t::error(const char *who, const char *format, ...)
 {
 	if(debuglevel>0) {
+		LOG_LOCK;
 		va_list argptr;
 		va_start(argptr, format);
 
@@ -349,6 +370,7 @@ void log_t::fatal(const char *who, const char *format, ...)
 void log_t::vmessage(const char *what, const char *who, const char *format, va_list args )
 {
 	if(debuglevel>0) {
+		LOG_LOCK;
 		va_list args2;
 #ifdef __va_copy
 		__va_copy(args2, args);
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the Simutrans project under the artistic license.
+ * (see license.txt)
+ */
+
+#include "simthread.h"
+#include "../simtypes.h"
+#include "../simdebug.h"
+
+#if MULTI_THREAD>1
+#include <pthread.h>
+
+// only one work at a time uses the pool
+static pthread_mutex_t pool_busy_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// guards the following variables
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+
+// threads created so far, they have the numbers 1 .. pool_size
+static int pool_size = 0;
+
+// the current work, a new one increases the generation
+static unsigned pool_generation = 0;
+static parallel_func pool_func;
+static void *pool_param;
+static int pool_count;
+static int pool_pending;
+
+
+static void *pool_thread(void *ptr)
+{
+	const int nr = (int)(size_t)ptr;
+	unsigned done_generation = 0;
+	pthread_mutex_lock( &pool_mutex );
+	while(  true  ) {
+		while(  done_generation == pool_generation  ) {
+			pthread_cond_wait( &pool_start, &pool_mutex );
+		}
+		done_generation = pool_generation;
+		if(  nr < pool_count  ) {
+			parallel_func func = pool_func;
+			void *param = pool_param;
+			pthread_mutex_unlock( &pool_mutex );
+			func( param, nr );
+			pthread_mutex_lock( &pool_mutex );
+			if(  --pool_pending == 0  ) {
+				pthread_cond_signal( &pool_done );
+			}
+		}
+	}
+	return NULL;
+}
+#endif
+
+
+void run_parallel(parallel_func func, void *param, int count)
+{
+#if MULTI_THREAD>1
+	if(  count > 1  &&  pthread_mutex_trylock( &pool_busy_mutex ) == 0  ) {
+		pthread_mutex_lock( &pool_mutex );
+		while(  pool_size < min( count, MULTI_THREAD ) - 1  ) {
+			pthread_t thread;
+			pthread_attr_t attr;
+			pthread_attr_init( &attr );
+			pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+			const bool ok = pthread_create( &thread, &attr, pool_thread, (void *)(size_t)(pool_size + 1) ) == 0;
+			pthread_attr_destroy( &attr );
+			if(  !ok  ) {
+				dbg->warning( "run_parallel()", "cannot create thread #%i", pool_size + 1 );
+				break;
+			}
+			pool_size++;
+		}
+		const int threads = min( count - 1, pool_size );
+		pool_func = func;
+		pool_param = param;
+		pool_count = threads + 1;
+		pool_pending = threads;
+		pool_generation++;
+		pthread_cond_broadcast( &pool_start );
+		pthread_mutex_unlock( &pool_mutex );
+
+		func( param, 0 );
+		// the parts beyond the pool
+		for(  int nr = threads + 1;  nr < count;  nr++  ) {
+			func( param, nr );
+		}
+
+		pthread_mutex_lock( &pool_mutex );
+		while(  pool_pending > 0  ) {
+			pthread_cond_wait( &pool_done, &pool_mutex );
+		}
+		pthread_mutex_unlock( &pool_mutex );
+		pthread_mutex_unlock( &pool_busy_mutex );
+		return;
+	}
+#endif
+	for(  int nr = 0;  nr < count;  nr++  ) {
+		func( param, nr );
+	}
+}
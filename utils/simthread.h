@@ -0,0 +1,30 @@
+/*
+ * This file is part of the Simutrans project under the artistic license.
+ * (see license.txt)
+ */
+
+#ifndef simthread_h
+#define simthread_h
+
+/*
+ * A pool of helper threads for work split into a few parallel parts,
+ * like the route searches of a step or the packing of savegame blocks.
+ * The threads are created when first needed and then wait for the next
+ * work, so no threads are created and joined each time.
+ */
+
+/// does the part nr of the work described by param
+typedef void (*parallel_func)(void *param, int nr);
+
+/**
+ * Calls func(param, nr) for nr = 0 .. count-1 at the same time and returns
+ * when all calls have returned. Part 0 runs in the calling thread, the
+ * others on the pool of MULTI_THREAD-1 threads.
+ * If the pool is already busy (i.e. when called by a pool thread or by
+ * another thread at the same time) or without MULTI_THREAD, all parts are
+ * done one after another in the calling thread. So the parts must not
+ * wait for each other.
+ */
+void run_parallel(parallel_func func, void *param, int count);
+
+#endif
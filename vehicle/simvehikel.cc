@@ -424,6 +424,38 @@ uint32 vehikel_basis_t::fahre_basis(uint32 distance)
 }
 
 
+bool vehikel_t::fahre_basis_auf_feld(vehikel_t *const *v, const uint8 count, const uint32 distance)
+{
+	const uint32 steps_to_do = distance >> YARDS_PER_VEHICLE_STEP_SHIFT;
+	if(  steps_to_do == 0  ) {
+		return false;
+	}
+	// would anyone hop (or turn, for aircraft with steps_next==0)?
+	for(  uint8 i = 0;  i < count;  i++  ) {
+		if(  steps_to_do + v[i]->steps > v[i]->steps_next  ) {
+			return false;
+		}
+	}
+	// ok, so all just travel on their tile
+	for(  uint8 i = 0;  i < count;  i++  ) {
+		vehikel_t *const w = v[i];
+		if(  !w->get_flag(ding_t::dirty)  ) {
+			w->mark_image_dirty( w->bild, w->hoff );
+			w->set_flag( ding_t::dirty );
+		}
+		w->steps += steps_to_do;
+		if(  w->use_calc_height  ) {
+			w->hoff = w->calc_height(NULL);
+		}
+	}
+	// same as update_bookkeeping(): only the first vehicle counts
+	if(  v[0]->ist_erstes  ) {
+		v[0]->cnv->increment_odometer(steps_to_do);
+	}
+	return true;
+}
+
+
 
 // to make smaller steps than the tile granularity, we have to use this trick
 void vehikel_basis_t::get_screen_offset( int &xoff, int &yoff, const sint16 raster_width ) const
@@ -1315,7 +1347,23 @@ vehikel_t::vehikel_t(karte_t *welt) :
 
 route_t::route_result_t vehikel_t::calc_route(koord3d start, koord3d ziel, sint32 max_speed, route_t* route)
 {
-	return route->calc_route(welt, start, ziel, this, max_speed, cnv != NULL ? cnv->get_highest_axle_load() : get_sum_weight(), 0, 4294967295U, cnv != NULL ? cnv->get_weight_summary().weight / 1000 : get_gesamtgewicht());
+	return search_or_take_prepared_route(start, ziel, max_speed, route);
+}
+
+
+route_t::route_result_t vehikel_t::search_route(koord3d start, koord3d ziel, sint32 max_speed, route_t* route)
+{
+	return route->calc_route(welt, start, ziel, this, max_speed, cnv != NULL ? cnv->get_highest_axle_load() : get_sum_weight(), get_route_search_tile_length(), 4294967295U, cnv != NULL ? cnv->get_weight_summary().weight / 1000 : get_gesamtgewicht());
+}
+
+
+route_t::route_result_t vehikel_t::search_or_take_prepared_route(koord3d start, koord3d ziel, sint32 max_speed, route_t* route)
+{
+	route_t::route_result_t result;
+	if(  cnv  &&  cnv->take_prepared_route(start, ziel, max_speed, route, result)  ) {
+		return result;
+	}
+	return search_route(start, ziel, max_speed, route);
 }
 
 bool vehikel_t::reroute(const uint16 reroute_index, const koord3d &ziel)
@@ -1393,7 +1441,7 @@ vehikel_t::verlasse_feld()
 	vehikel_basis_t::verlasse_feld();
 #ifndef DEBUG_ROUTES
 	if(ist_letztes  &&  reliefkarte_t::is_visible) {
-			reliefkarte_t::get_karte()->calc_map_pixel(get_pos().get_2d());
+			reliefkarte_t::get_karte()->calc_vehicle_pixel(get_pos().get_2d());
 	}
 #endif
 }
@@ -1408,7 +1456,7 @@ grund_t* vehikel_t::betrete_feld()
 {
 	grund_t* gr = vehikel_basis_t::betrete_feld();
 	if(ist_erstes  &&  reliefkarte_t::is_visible  ) {
-		reliefkarte_t::get_karte()->calc_map_pixel( get_pos().get_2d() );  //"Set relief colour" (Babelfish)
+		reliefkarte_t::get_karte()->calc_vehicle_pixel( get_pos().get_2d() );  //"Set relief colour" (Babelfish)
 	}
 	return gr;
 }
@@ -2449,7 +2497,7 @@ vehikel_t::~vehikel_t()
 	grund_t *gr = welt->lookup(get_pos());
 	if(gr) {
 		// remove vehicle's marker from the reliefmap
-		reliefkarte_t::get_karte()->calc_map_pixel(get_pos().get_2d());
+		reliefkarte_t::get_karte()->calc_vehicle_pixel(get_pos().get_2d());
 	}
 }
 
@@ -2682,8 +2730,7 @@ route_t::route_result_t automobil_t::calc_route(koord3d start, koord3d ziel, sin
 		}
 	}
 	target_halt = halthandle_t();	// no block reserved
-	const uint32 routing_weight = cnv != NULL ? cnv->get_highest_axle_load() : get_sum_weight();
-	route_t::route_result_t r = route->calc_route(welt, start, ziel, this, max_speed, routing_weight, cnv->get_tile_length(), 4294967295U, cnv->get_weight_summary().weight / 1000 );
+	route_t::route_result_t r = search_or_take_prepared_route(start, ziel, max_speed, route);
 	if(  r == route_t::valid_route_halt_too_short  ) {
 		cbuffer_t buf;
 		buf.printf( translator::translate("Vehicle %s cannot choose because stop too short!"), cnv->get_name());
@@ -2693,6 +2740,12 @@ route_t::route_result_t automobil_t::calc_route(koord3d start, koord3d ziel, sin
 }
 
 
+sint32 automobil_t::get_route_search_tile_length() const
+{
+	return cnv->get_tile_length();
+}
+
+
 
 bool automobil_t::ist_befahrbar(const grund_t *bd) const
 {
@@ -3420,9 +3473,7 @@ route_t::route_result_t waggon_t::calc_route(koord3d start, koord3d ziel, sint32
 	}
 	cnv->set_next_reservation_index( 0 );	// nothing to reserve
 	target_halt = halthandle_t();	// no block reserved
-	// use length > 8888 tiles to advance to the end of terminus stations
-	const sint16 tile_length = (cnv->get_schedule()->get_current_eintrag().reverse ? 8888 : 0) + cnv->get_tile_length();
-	route_t::route_result_t r = route->calc_route(welt, start, ziel, this, max_speed, cnv != NULL ? cnv->get_highest_axle_load() : get_sum_weight(), tile_length, 4294967295U, cnv ? cnv->get_weight_summary().weight / 1000 : get_gesamtgewicht());
+	route_t::route_result_t r = search_or_take_prepared_route(start, ziel, max_speed, route);
 	if(r == route_t::valid_route_halt_too_short)
 	{
 		cbuffer_t buf;
@@ -3433,6 +3484,14 @@ route_t::route_result_t waggon_t::calc_route(koord3d start, koord3d ziel, sint32
 }
 
 
+sint32 waggon_t::get_route_search_tile_length() const
+{
+	// use length > 8888 tiles to advance to the end of terminus stations
+	const sint16 tile_length = (cnv->get_schedule()->get_current_eintrag().reverse ? 8888 : 0) + cnv->get_tile_length();
+	return tile_length;
+}
+
+
 
 bool waggon_t::ist_befahrbar(const grund_t *bd) const
 {
@@ -337,6 +337,14 @@ protected:
 	bool check_access(const weg_t* way) const;
 
 public:
+	/**
+	 * Vehicle movement for the common case: moves all count vehicles by the same
+	 * distance, like fahre_basis() would, but only if none of them leaves its tile.
+	 * Then no hop is needed and the vehicles are advanced in one tight loop.
+	 * @return false (and nothing moved), if fahre_basis() must be used instead
+	 */
+	static bool fahre_basis_auf_feld(vehikel_t *const *v, uint8 count, uint32 distance);
+
 	sint32 calc_speed_limit(const weg_t *weg, const weg_t *weg_previous, fixed_list_tpl<sint16, 16>* cornering_data, ribi_t::ribi current_direction, ribi_t::ribi previous_direction);
 
 	virtual bool ist_befahrbar(const grund_t* ) const {return false;}
@@ -374,6 +382,23 @@ public:
 	void darf_rauchen(bool yesno ) { rauchen = yesno;}
 
 	virtual route_t::route_result_t calc_route(koord3d start, koord3d ziel, sint32 max_speed_kmh, route_t* route);
+
+	/**
+	 * The plain route search of calc_route(), without touching any reservations.
+	 * It only reads the world, so it may run on a route search thread.
+	 * @see karte_t::calc_convoi_routes()
+	 */
+	route_t::route_result_t search_route(koord3d start, koord3d ziel, sint32 max_speed_kmh, route_t* route);
+
+	/**
+	 * Like search_route(), but uses the route our convoi has found in advance
+	 * if that was searched for the same start, target and speed.
+	 */
+	route_t::route_result_t search_or_take_prepared_route(koord3d start, koord3d ziel, sint32 max_speed_kmh, route_t* route);
+
+	// length passed to the route search, to fit the convoi into the target halt
+	virtual sint32 get_route_search_tile_length() const { return 0; }
+
 	uint16 get_route_index() const {return route_index;}
 	void set_route_index(uint16 value) { route_index = value; }
 	const koord3d get_pos_prev() const {return pos_prev;}
@@ -660,6 +685,8 @@ public:
 
 	virtual route_t::route_result_t calc_route(koord3d start, koord3d ziel, sint32 max_speed, route_t* route);
 
+	virtual sint32 get_route_search_tile_length() const;
+
 	virtual bool ist_weg_frei(int &restart_speed, bool second_check );
 
 	// returns true for the way search to an unknown target.
@@ -708,6 +735,9 @@ public:
 	// since we might need to unreserve previously used blocks, we must do this before calculation a new route
 	route_t::route_result_t calc_route(koord3d start, koord3d ziel, sint32 max_speed, route_t* route);
 
+	// use length > 8888 tiles to advance to the end of terminus stations
+	virtual sint32 get_route_search_tile_length() const;
+
 	// how expensive to go here (for way search)
 	virtual int get_kosten(const grund_t *, const sint32, koord);
 